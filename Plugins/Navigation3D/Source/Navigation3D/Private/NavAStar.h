@@ -0,0 +1,252 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavSearchContext.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Reverse.h"
+#include <atomic>
+#include <limits>
+
+// Generic A* over any Navigation3D graph representation (dense grid, octree leaves, ...).
+//
+// GraphType must provide:
+//     float Heuristic(int32 NodeIndex) const;                                   // admissible estimate to the goal
+//     template<typename F> void ForEachNeighbor(int32 NodeIndex, F&& Func) const; // Func(int32 NeighborIndex, float EdgeCost)
+//
+// VisitorType receives search events, mainly for debug drawing:
+//     void OnPopped(int32 NodeIndex); void OnClosed(int32 NodeIndex);
+//     void OnNeighborConsidered(int32 FromIndex, int32 ToIndex); void OnNeighborImproved(int32 FromIndex, int32 ToIndex);
+
+enum class ENavAStarStatus : uint8
+{
+    Found,
+    NoPath,
+    Cancelled,
+    // MaxExpansions or the deadline was reached. The open heap is left intact, so the search can be continued.
+    OutOfBudget
+};
+
+struct FNavAStarParams
+{
+    int32 StartIndex = INDEX_NONE;
+    int32 GoalIndex = INDEX_NONE;
+    const std::atomic<bool>* bCancelled = nullptr;
+    // Expansions allowed in this call; 0 for no limit.
+    int32 MaxExpansions = 0;
+    // FPlatformTime::Seconds() after which this call stops, checked every 256 expansions; 0 for none.
+    double DeadlineSeconds = 0.0;
+    // Continue a search that returned OutOfBudget on the same context, graph and goal instead of starting one.
+    bool bContinue = false;
+    // Without a GoalIndex: distinct nodes, sorted ascending, after whose closing the search may stop because only
+    // their scores are needed. It then returns Found; if some cannot be reached it runs until the open set is empty.
+    TConstArrayView<int32> SettleIndices;
+};
+
+struct FNavAStarNullVisitor
+{
+    FORCEINLINE void OnPopped(int32) {}
+    FORCEINLINE void OnClosed(int32) {}
+    FORCEINLINE void OnNeighborConsidered(int32, int32) {}
+    FORCEINLINE void OnNeighborImproved(int32, int32) {}
+};
+
+// Visitor for searches compiled away from their caller (FNavClusterHierarchy::FindPath), which cannot take the
+// caller's visitor type as a template argument. Pass nullptr where a null visitor would do, so the virtual calls
+// are only paid while drawing or tracing.
+class INavAStarVisitor
+{
+public:
+    virtual ~INavAStarVisitor() = default;
+    virtual void OnPopped(int32 NodeIndex) = 0;
+    virtual void OnClosed(int32 NodeIndex) = 0;
+    virtual void OnNeighborConsidered(int32 FromIndex, int32 ToIndex) = 0;
+    virtual void OnNeighborImproved(int32 FromIndex, int32 ToIndex) = 0;
+};
+
+template<typename InnerVisitorType>
+class TNavAStarVisitorAdapter final : public INavAStarVisitor
+{
+public:
+    explicit TNavAStarVisitorAdapter(InnerVisitorType& InInner) : Inner(InInner) {}
+
+    virtual void OnPopped(int32 NodeIndex) override { Inner.OnPopped(NodeIndex); }
+    virtual void OnClosed(int32 NodeIndex) override { Inner.OnClosed(NodeIndex); }
+    virtual void OnNeighborConsidered(int32 FromIndex, int32 ToIndex) override { Inner.OnNeighborConsidered(FromIndex, ToIndex); }
+    virtual void OnNeighborImproved(int32 FromIndex, int32 ToIndex) override { Inner.OnNeighborImproved(FromIndex, ToIndex); }
+
+private:
+    InnerVisitorType& Inner;
+};
+
+// Runs A* from Params.StartIndex to Params.GoalIndex. The search context must already have been begun for
+// the graph's node count; on success the path can be read back from it with GetCameFrom.
+// Each node sits in the open heap at most once (improvements decrease its key in place) and closed nodes are
+// never reopened, so the search allocates nothing once the context's heap has grown to its working size.
+template<typename GraphType, typename VisitorType>
+ENavAStarStatus RunNavAStar(const GraphType& Graph, FNavSearchContext& Search, const FNavAStarParams& Params, VisitorType& Visitor)
+{
+    if (!Params.bContinue)
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("RunNavAStar_Init"));
+        FNavSearchNodeState& StartState = Search.Touch(Params.StartIndex);
+        StartState.GScore = 0.0f;
+        Search.ClosestToGoalIndex = Params.StartIndex;
+        Search.ClosestToGoalHeuristic = Graph.Heuristic(Params.StartIndex);
+        Search.PushOrDecreaseOpen(Params.StartIndex, Search.ClosestToGoalHeuristic);
+    }
+
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("RunNavAStar_MainLoop"));
+    int32 NumExpanded = 0;
+    int32 NumToSettle = Params.SettleIndices.Num();
+    while (!Search.IsOpenEmpty())
+    {
+        if ((++NumExpanded & 255) == 0) {
+            // Superseded queries stop early so they hand their worker back to the scheduler.
+            if (Params.bCancelled && Params.bCancelled->load(std::memory_order_relaxed)) {
+                return ENavAStarStatus::Cancelled;
+            }
+            if (Params.DeadlineSeconds > 0.0 && FPlatformTime::Seconds() >= Params.DeadlineSeconds) {
+                return ENavAStarStatus::OutOfBudget;
+            }
+        }
+        if (Params.MaxExpansions > 0 && NumExpanded > Params.MaxExpansions) {
+            return ENavAStarStatus::OutOfBudget;
+        }
+
+        const int32 CurrentIndex = Search.PopOpen();
+        Visitor.OnPopped(CurrentIndex);
+        Search.MarkClosed(CurrentIndex);
+        Visitor.OnClosed(CurrentIndex);
+
+        if (CurrentIndex == Params.GoalIndex) {
+            return ENavAStarStatus::Found;
+        }
+        if (NumToSettle > 0 && Algo::BinarySearch(Params.SettleIndices, CurrentIndex) != INDEX_NONE && --NumToSettle == 0) {
+            return ENavAStarStatus::Found;
+        }
+
+        const float CurrentGScore = Search.GetGScore(CurrentIndex);
+        if (CurrentGScore == std::numeric_limits<float>::max()) { continue; }
+
+        Graph.ForEachNeighbor(CurrentIndex, [&](int32 NeighborIndex, float EdgeCost) {
+            Visitor.OnNeighborConsidered(CurrentIndex, NeighborIndex);
+
+            if (Search.IsClosed(NeighborIndex)) {
+                return;
+            }
+
+            const float TentativeGScore = CurrentGScore + EdgeCost;
+            FNavSearchNodeState& NeighborState = Search.Touch(NeighborIndex);
+            if (TentativeGScore < NeighborState.GScore) {
+                NeighborState.CameFrom = CurrentIndex;
+                NeighborState.GScore = TentativeGScore;
+                const float Heuristic = Graph.Heuristic(NeighborIndex);
+                if (Heuristic < Search.ClosestToGoalHeuristic) {
+                    Search.ClosestToGoalIndex = NeighborIndex;
+                    Search.ClosestToGoalHeuristic = Heuristic;
+                }
+                Search.PushOrDecreaseOpen(NeighborIndex, TentativeGScore + Heuristic);
+                Visitor.OnNeighborImproved(CurrentIndex, NeighborIndex);
+            }
+        });
+    }
+
+    return ENavAStarStatus::NoPath;
+}
+
+// Bidirectional A* from Params.StartIndex to Params.GoalIndex over an undirected graph: ForwardGraph and
+// BackwardGraph are the same graph with heuristics toward the goal and toward the start respectively, and
+// each direction keeps its own context. The side with the smaller open set expands next. Every time a node's
+// score improves in one direction while the other has reached it, the meeting cost through it is recorded.
+// The search stops once either frontier's lowest FScore reaches the best meeting cost: with consistent
+// heuristics no cheaper path can remain. Budgets and bContinue are not supported; cancellation is.
+template<typename ForwardGraphType, typename BackwardGraphType, typename VisitorType>
+ENavAStarStatus RunNavBidirectionalAStar(const ForwardGraphType& ForwardGraph, const BackwardGraphType& BackwardGraph,
+    FNavSearchContext& Forward, FNavSearchContext& Backward, const FNavAStarParams& Params, VisitorType& Visitor, int32& OutMeetingIndex)
+{
+    OutMeetingIndex = INDEX_NONE;
+    if (Params.StartIndex == Params.GoalIndex) {
+        Forward.Touch(Params.StartIndex).GScore = 0.0f;
+        Backward.Touch(Params.GoalIndex).GScore = 0.0f;
+        OutMeetingIndex = Params.StartIndex;
+        return ENavAStarStatus::Found;
+    }
+
+    float BestCost = std::numeric_limits<float>::max();
+    Forward.Touch(Params.StartIndex).GScore = 0.0f;
+    Forward.PushOrDecreaseOpen(Params.StartIndex, ForwardGraph.Heuristic(Params.StartIndex));
+    Backward.Touch(Params.GoalIndex).GScore = 0.0f;
+    Backward.PushOrDecreaseOpen(Params.GoalIndex, BackwardGraph.Heuristic(Params.GoalIndex));
+
+    auto ExpandOne = [&](const auto& Graph, FNavSearchContext& Search, const FNavSearchContext& Other) {
+        const int32 CurrentIndex = Search.PopOpen();
+        Visitor.OnPopped(CurrentIndex);
+        Search.MarkClosed(CurrentIndex);
+        Visitor.OnClosed(CurrentIndex);
+
+        const float CurrentGScore = Search.GetGScore(CurrentIndex);
+        Graph.ForEachNeighbor(CurrentIndex, [&](int32 NeighborIndex, float EdgeCost) {
+            Visitor.OnNeighborConsidered(CurrentIndex, NeighborIndex);
+
+            if (Search.IsClosed(NeighborIndex)) {
+                return;
+            }
+
+            const float TentativeGScore = CurrentGScore + EdgeCost;
+            FNavSearchNodeState& NeighborState = Search.Touch(NeighborIndex);
+            if (TentativeGScore < NeighborState.GScore) {
+                NeighborState.CameFrom = CurrentIndex;
+                NeighborState.GScore = TentativeGScore;
+                Search.PushOrDecreaseOpen(NeighborIndex, TentativeGScore + Graph.Heuristic(NeighborIndex));
+                Visitor.OnNeighborImproved(CurrentIndex, NeighborIndex);
+
+                const float OtherGScore = Other.GetGScore(NeighborIndex);
+                if (OtherGScore != std::numeric_limits<float>::max() && TentativeGScore + OtherGScore < BestCost) {
+                    BestCost = TentativeGScore + OtherGScore;
+                    OutMeetingIndex = NeighborIndex;
+                }
+            }
+        });
+    };
+
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("RunNavBidirectionalAStar_MainLoop"));
+    int32 NumExpanded = 0;
+    while (!Forward.IsOpenEmpty() && !Backward.IsOpenEmpty())
+    {
+        if (Params.bCancelled && (++NumExpanded & 255) == 0 && Params.bCancelled->load(std::memory_order_relaxed)) {
+            return ENavAStarStatus::Cancelled;
+        }
+        if (FMath::Max(Forward.PeekOpenScore(), Backward.PeekOpenScore()) >= BestCost) {
+            break;
+        }
+
+        if (Forward.NumOpen() <= Backward.NumOpen()) {
+            ExpandOne(ForwardGraph, Forward, Backward);
+        } else {
+            ExpandOne(BackwardGraph, Backward, Forward);
+        }
+    }
+
+    // An exhausted side has reached everything it can, so a recorded meeting is then exact as well.
+    return OutMeetingIndex != INDEX_NONE ? ENavAStarStatus::Found : ENavAStarStatus::NoPath;
+}
+
+// Writes the node indices of the path ending at GoalIndex, start first.
+inline void ReconstructNavPath(const FNavSearchContext& Search, int32 GoalIndex, TArray<int32>& OutNodeIndices)
+{
+    OutNodeIndices.Reset();
+    for (int32 NodeIndex = GoalIndex; NodeIndex != INDEX_NONE; NodeIndex = Search.GetCameFrom(NodeIndex)) {
+        OutNodeIndices.Add(NodeIndex);
+    }
+    Algo::Reverse(OutNodeIndices);
+}
+
+// Writes the node indices of a RunNavBidirectionalAStar path, start first: the forward parents up to the
+// meeting node, then the backward parents from it to the goal.
+inline void ReconstructNavBidirectionalPath(const FNavSearchContext& Forward, const FNavSearchContext& Backward, int32 MeetingIndex, TArray<int32>& OutNodeIndices)
+{
+    ReconstructNavPath(Forward, MeetingIndex, OutNodeIndices);
+    for (int32 NodeIndex = Backward.GetCameFrom(MeetingIndex); NodeIndex != INDEX_NONE; NodeIndex = Backward.GetCameFrom(NodeIndex)) {
+        OutNodeIndices.Add(NodeIndex);
+    }
+}
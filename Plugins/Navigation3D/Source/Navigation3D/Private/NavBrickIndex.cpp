@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NavBrickIndex.h"
+#include "NavGrid.h"
+#include "Algo/BinarySearch.h"
+
+void FNavBrickIndex::Build(const FNavGrid& Grid)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavBrickIndex::Build"));
+
+    Empty();
+    if (Grid.IsEmpty())
+    {
+        return;
+    }
+
+    GridSize = Grid.GetSize();
+    NumBricks = FIntVector(
+        FMath::DivideAndRoundUp(GridSize.X, BrickSize),
+        FMath::DivideAndRoundUp(GridSize.Y, BrickSize),
+        FMath::DivideAndRoundUp(GridSize.Z, BrickSize));
+
+    BrickOffsets.SetNumUninitialized(NumBricks.X * NumBricks.Y * NumBricks.Z + 1);
+    BrickCells.Reserve(Grid.Num());
+    int32 Brick = 0;
+    for (int32 BrickZ = 0; BrickZ < NumBricks.Z; ++BrickZ)
+    {
+        for (int32 BrickY = 0; BrickY < NumBricks.Y; ++BrickY)
+        {
+            for (int32 BrickX = 0; BrickX < NumBricks.X; ++BrickX, ++Brick)
+            {
+                BrickOffsets[Brick] = BrickCells.Num();
+                const FIntVector Origin(BrickX * BrickSize, BrickY * BrickSize, BrickZ * BrickSize);
+                const FIntVector End(
+                    FMath::Min(Origin.X + BrickSize, GridSize.X),
+                    FMath::Min(Origin.Y + BrickSize, GridSize.Y),
+                    FMath::Min(Origin.Z + BrickSize, GridSize.Z));
+                for (int32 Z = Origin.Z; Z < End.Z; ++Z)
+                {
+                    for (int32 Y = Origin.Y; Y < End.Y; ++Y)
+                    {
+                        for (int32 X = Origin.X; X < End.X; ++X)
+                        {
+                            if (Grid.IsTraversable(Grid.ToIndex(FIntVector(X, Y, Z))))
+                            {
+                                BrickCells.Add(static_cast<uint16>((X - Origin.X) + (Y - Origin.Y) * BrickSize + (Z - Origin.Z) * BrickSize * BrickSize));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    BrickOffsets[Brick] = BrickCells.Num();
+    BrickCells.Shrink();
+}
+
+void FNavBrickIndex::Empty()
+{
+    GridSize = FIntVector::ZeroValue;
+    NumBricks = FIntVector::ZeroValue;
+    BrickOffsets.Empty();
+    BrickCells.Empty();
+}
+
+SIZE_T FNavBrickIndex::GetAllocatedSize() const
+{
+    return BrickOffsets.GetAllocatedSize() + BrickCells.GetAllocatedSize();
+}
+
+void FNavBrickIndex::GatherBricks(const FIntVector& MinCell, const FIntVector& MaxCell, FNavBrickSampleSet& OutSet) const
+{
+    OutSet.Bricks.Reset();
+    OutSet.CumulativeCells.Reset();
+    if (IsEmpty())
+    {
+        return;
+    }
+
+    const FIntVector MinBrick(MinCell.X / BrickSize, MinCell.Y / BrickSize, MinCell.Z / BrickSize);
+    const FIntVector MaxBrick(MaxCell.X / BrickSize, MaxCell.Y / BrickSize, MaxCell.Z / BrickSize);
+    int32 TotalCells = 0;
+    for (int32 BrickZ = MinBrick.Z; BrickZ <= MaxBrick.Z; ++BrickZ)
+    {
+        for (int32 BrickY = MinBrick.Y; BrickY <= MaxBrick.Y; ++BrickY)
+        {
+            for (int32 BrickX = MinBrick.X; BrickX <= MaxBrick.X; ++BrickX)
+            {
+                const int32 Brick = (BrickZ * NumBricks.Y + BrickY) * NumBricks.X + BrickX;
+                const int32 NumBrickCells = BrickOffsets[Brick + 1] - BrickOffsets[Brick];
+                if (NumBrickCells > 0)
+                {
+                    TotalCells += NumBrickCells;
+                    OutSet.Bricks.Add(Brick);
+                    OutSet.CumulativeCells.Add(TotalCells);
+                }
+            }
+        }
+    }
+}
+
+int32 FNavBrickIndex::SampleCell(const FNavBrickSampleSet& Set, const FRandomStream& Random) const
+{
+    const int32 NumCells = Set.NumCells();
+    if (NumCells == 0)
+    {
+        return INDEX_NONE;
+    }
+
+    const int32 Pick = Random.RandRange(0, NumCells - 1);
+    const int32 SetEntry = Algo::UpperBound(Set.CumulativeCells, Pick);
+    const int32 Brick = Set.Bricks[SetEntry];
+    const int32 CellsBefore = SetEntry > 0 ? Set.CumulativeCells[SetEntry - 1] : 0;
+    return ToCellIndex(Brick, BrickCells[BrickOffsets[Brick] + Pick - CellsBefore]);
+}
+
+int32 FNavBrickIndex::ToCellIndex(int32 Brick, uint16 LocalCell) const
+{
+    const int32 BrickX = Brick % NumBricks.X;
+    const int32 BrickYZ = Brick / NumBricks.X;
+    const FIntVector Cell(
+        BrickX * BrickSize + LocalCell % BrickSize,
+        (BrickYZ % NumBricks.Y) * BrickSize + (LocalCell / BrickSize) % BrickSize,
+        (BrickYZ / NumBricks.Y) * BrickSize + LocalCell / (BrickSize * BrickSize));
+    return (Cell.Z * GridSize.Y + Cell.Y) * GridSize.X + Cell.X;
+}
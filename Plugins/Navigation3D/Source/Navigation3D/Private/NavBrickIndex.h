@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FNavGrid;
+
+// Bricks of an FNavBrickIndex overlapping a box of cells, with running totals of their free cells so a cell can
+// be drawn uniformly across all of them. Filled by FNavBrickIndex::GatherBricks.
+struct FNavBrickSampleSet
+{
+    TArray<int32, TInlineAllocator<64>> Bricks;
+    // CumulativeCells[I] is the number of free cells in Bricks[0..I].
+    TArray<int32, TInlineAllocator<64>> CumulativeCells;
+
+    FORCEINLINE int32 NumCells() const { return CumulativeCells.Num() > 0 ? CumulativeCells.Last() : 0; }
+};
+
+// The dense grid's traversable cells bucketed by 8x8x8 brick, for drawing random free cells near a point without
+// visiting the blocked ones. Each free cell costs 2 bytes (its offset inside the brick). Rebuilt as a whole
+// whenever traversability changes; read-only otherwise.
+class FNavBrickIndex
+{
+public:
+    static constexpr int32 BrickSize = 8;
+
+    void Build(const FNavGrid& Grid);
+    void Empty();
+
+    FORCEINLINE bool IsEmpty() const { return BrickOffsets.Num() == 0; }
+    SIZE_T GetAllocatedSize() const;
+
+    // Collects the bricks touching the inclusive cell box [MinCell, MaxCell], which must lie inside the grid.
+    void GatherBricks(const FIntVector& MinCell, const FIntVector& MaxCell, FNavBrickSampleSet& OutSet) const;
+
+    // A free cell drawn uniformly from the set's bricks; it may lie outside the box the set was gathered for.
+    // INDEX_NONE if the set has no free cells.
+    int32 SampleCell(const FNavBrickSampleSet& Set, const FRandomStream& Random) const;
+
+    // Calls Visitor(CellIndex) for every free cell of the set's bricks.
+    template<typename VisitorType>
+    void ForEachCell(const FNavBrickSampleSet& Set, VisitorType&& Visitor) const
+    {
+        for (const int32 Brick : Set.Bricks)
+        {
+            for (int32 Entry = BrickOffsets[Brick]; Entry < BrickOffsets[Brick + 1]; ++Entry)
+            {
+                Visitor(ToCellIndex(Brick, BrickCells[Entry]));
+            }
+        }
+    }
+
+private:
+    int32 ToCellIndex(int32 Brick, uint16 LocalCell) const;
+
+    FIntVector GridSize = FIntVector::ZeroValue;
+    FIntVector NumBricks = FIntVector::ZeroValue;
+    // Free cells of brick B are BrickCells[BrickOffsets[B] .. BrickOffsets[B + 1]), as X + Y * 8 + Z * 64 inside the brick.
+    TArray<int32> BrickOffsets;
+    TArray<uint16> BrickCells;
+};
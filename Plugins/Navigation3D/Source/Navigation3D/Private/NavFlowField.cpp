@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NavFlowField.h"
+#include "NavAStar.h"
+#include "NavHierarchy.h"
+
+bool FNavFlowField::Build(const FNavGrid& Grid, int32 InGoalIndex, FNavSearchContext& Search, const std::atomic<bool>* bCancelled)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavFlowField::Build"));
+
+    GoalIndex = INDEX_NONE;
+    Distances.Reset();
+    NextDirections.Reset();
+
+    // Moves only depend on the target cell being free, so distances from the goal equal distances to it.
+    Search.BeginSearch(Grid.Num());
+    const FNavGridBoxGraph WholeGrid(Grid, FIntVector::ZeroValue, Grid.GetSize(), FIntVector::ZeroValue, false);
+    FNavAStarParams Params;
+    Params.StartIndex = InGoalIndex; // No goal: floods everything reachable.
+    Params.bCancelled = bCancelled;
+    FNavAStarNullVisitor Visitor;
+    if (RunNavAStar(WholeGrid, Search, Params, Visitor) == ENavAStarStatus::Cancelled)
+    {
+        return false;
+    }
+
+    Distances.SetNumUninitialized(Grid.Num());
+    NextDirections.SetNumUninitialized(Grid.Num());
+    for (int32 CellIndex = 0; CellIndex < Grid.Num(); ++CellIndex)
+    {
+        Distances[CellIndex] = Search.GetGScore(CellIndex);
+
+        const int32 ParentIndex = Search.GetCameFrom(CellIndex);
+        NextDirections[CellIndex] = ParentIndex == INDEX_NONE
+            ? NoDirection
+            : static_cast<uint8>(FNavGrid::FindDirection(Grid.ToCoordinates(ParentIndex) - Grid.ToCoordinates(CellIndex)));
+    }
+    GoalIndex = InGoalIndex;
+    return true;
+}
+
+SIZE_T FNavFlowField::GetAllocatedSize() const
+{
+    return Distances.GetAllocatedSize() + NextDirections.GetAllocatedSize();
+}
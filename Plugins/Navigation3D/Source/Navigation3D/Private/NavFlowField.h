@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavGrid.h"
+#include "NavSearchContext.h"
+#include <atomic>
+
+// Dijkstra map over an FNavGrid toward a single goal cell: the path distance from every reachable cell and
+// the direction of its first step along a shortest path. Built once per goal cell, then read in O(1) by any
+// number of agents heading to the same goal. Immutable after Build, so a finished field can be shared across threads.
+class FNavFlowField
+{
+public:
+    // Returns false if the build was cancelled; the field is then left empty.
+    bool Build(const FNavGrid& Grid, int32 InGoalIndex, FNavSearchContext& Search, const std::atomic<bool>* bCancelled);
+
+    FORCEINLINE bool IsEmpty() const { return GoalIndex == INDEX_NONE; }
+    FORCEINLINE int32 GetGoalIndex() const { return GoalIndex; }
+
+    FORCEINLINE bool IsReachable(int32 CellIndex) const { return Distances[CellIndex] != std::numeric_limits<float>::max(); }
+
+    // Path distance to the goal in cell units.
+    FORCEINLINE float GetDistance(int32 CellIndex) const { return Distances[CellIndex]; }
+
+    // FNavGrid direction of the next step, or INDEX_NONE at the goal and in unreachable cells.
+    FORCEINLINE int32 GetNextDirection(int32 CellIndex) const
+    {
+        return NextDirections[CellIndex] == NoDirection ? INDEX_NONE : NextDirections[CellIndex];
+    }
+
+    SIZE_T GetAllocatedSize() const;
+
+private:
+    static constexpr uint8 NoDirection = 0xFF;
+
+    int32 GoalIndex = INDEX_NONE;
+    TArray<float> Distances;
+    TArray<uint8> NextDirections;
+};
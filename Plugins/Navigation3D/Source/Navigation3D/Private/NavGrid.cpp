@@ -0,0 +1,354 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NavGrid.h"
+
+const FIntVector FNavGrid::Directions[FNavGrid::NumDirections] = {
+    // Faces
+    FIntVector(-1, 0, 0), FIntVector(1, 0, 0), FIntVector(0, -1, 0), FIntVector(0, 1, 0), FIntVector(0, 0, -1), FIntVector(0, 0, 1),
+    // Edges
+    FIntVector(-1, -1, 0), FIntVector(1, -1, 0), FIntVector(-1, 1, 0), FIntVector(1, 1, 0),
+    FIntVector(-1, 0, -1), FIntVector(1, 0, -1), FIntVector(-1, 0, 1), FIntVector(1, 0, 1),
+    FIntVector(0, -1, -1), FIntVector(0, 1, -1), FIntVector(0, -1, 1), FIntVector(0, 1, 1),
+    // Corners
+    FIntVector(-1, -1, -1), FIntVector(1, -1, -1), FIntVector(-1, 1, -1), FIntVector(1, 1, -1),
+    FIntVector(-1, -1, 1), FIntVector(1, -1, 1), FIntVector(-1, 1, 1), FIntVector(1, 1, 1)
+};
+
+const float FNavGrid::DirectionCosts[FNavGrid::NumDirections] = {
+    1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+    UE_SQRT_2, UE_SQRT_2, UE_SQRT_2, UE_SQRT_2, UE_SQRT_2, UE_SQRT_2,
+    UE_SQRT_2, UE_SQRT_2, UE_SQRT_2, UE_SQRT_2, UE_SQRT_2, UE_SQRT_2,
+    UE_SQRT_3, UE_SQRT_3, UE_SQRT_3, UE_SQRT_3, UE_SQRT_3, UE_SQRT_3, UE_SQRT_3, UE_SQRT_3
+};
+
+int32 FNavGrid::FindDirection(const FIntVector& Offset)
+{
+    for (int32 Direction = 0; Direction < NumDirections; ++Direction)
+    {
+        if (Directions[Direction] == Offset)
+        {
+            return Direction;
+        }
+    }
+    return INDEX_NONE;
+}
+
+void FNavGrid::Initialize(int32 InSizeX, int32 InSizeY, int32 InSizeZ, int32 MinSharedNeighborAxes)
+{
+    SizeX = FMath::Max(0, InSizeX);
+    SizeY = FMath::Max(0, InSizeY);
+    SizeZ = FMath::Max(0, InSizeZ);
+    NumCells = SizeX * SizeY * SizeZ;
+
+    AllowedDirectionsMask = 0;
+    for (int32 Direction = 0; Direction < NumDirections; ++Direction)
+    {
+        const FIntVector& Dir = Directions[Direction];
+        const int32 SharedAxes = (Dir.X == 0) + (Dir.Y == 0) + (Dir.Z == 0);
+        if (SharedAxes >= MinSharedNeighborAxes)
+        {
+            AllowedDirectionsMask |= 1u << Direction;
+        }
+    }
+    ComputeIndexOffsets();
+
+    // Everything starts traversable, matching the behaviour before the traversability bake runs.
+    TraversableBits.Reset();
+    TraversableBits.SetNumUninitialized((NumCells + 63) / 64);
+    for (uint64& Word : TraversableBits)
+    {
+        Word = ~0ull;
+    }
+    if (NumCells % 64 != 0)
+    {
+        TraversableBits.Last() = (1ull << (NumCells % 64)) - 1;
+    }
+
+    NeighborMasks.Reset();
+    NeighborMasks.SetNumZeroed(NumCells);
+    Clearance.Reset();
+    BlockedCountBeforeWord.Reset();
+    NearestTraversableByRank.Reset();
+}
+
+void FNavGrid::ComputeIndexOffsets()
+{
+    for (int32 Direction = 0; Direction < NumDirections; ++Direction)
+    {
+        const FIntVector& Dir = Directions[Direction];
+        DirectionIndexOffsets[Direction] = (Dir.Z * SizeY + Dir.Y) * SizeX + Dir.X;
+    }
+}
+
+void FNavGrid::Serialize(FArchive& Ar)
+{
+    Ar << SizeX << SizeY << SizeZ << AllowedDirectionsMask;
+    if (Ar.IsLoading())
+    {
+        NumCells = SizeX * SizeY * SizeZ;
+        ComputeIndexOffsets();
+    }
+    TraversableBits.BulkSerialize(Ar);
+    NeighborMasks.BulkSerialize(Ar);
+    Clearance.BulkSerialize(Ar);
+    BlockedCountBeforeWord.BulkSerialize(Ar);
+    NearestTraversableByRank.BulkSerialize(Ar);
+
+    if (Ar.IsLoading() && (TraversableBits.Num() != (NumCells + 63) / 64 || NeighborMasks.Num() != NumCells || Clearance.Num() != NumCells
+        || BlockedCountBeforeWord.Num() != TraversableBits.Num() || NearestTraversableByRank.Num() != NumCells - CountTraversable()))
+    {
+        Ar.SetError();
+    }
+}
+
+void FNavGrid::Empty()
+{
+    SizeX = SizeY = SizeZ = NumCells = 0;
+    AllowedDirectionsMask = 0;
+    TraversableBits.Empty();
+    NeighborMasks.Empty();
+    Clearance.Empty();
+    BlockedCountBeforeWord.Empty();
+    NearestTraversableByRank.Empty();
+}
+
+void FNavGrid::RebuildNeighborMasks()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavGrid::RebuildNeighborMasks"));
+
+    if (NumCells > 0)
+    {
+        RebuildNeighborMasks(FNavGridRegion{FIntVector::ZeroValue, FIntVector(SizeX - 1, SizeY - 1, SizeZ - 1)});
+    }
+}
+
+void FNavGrid::RebuildNeighborMasks(const FNavGridRegion& Region)
+{
+    const FIntVector Min(FMath::Max(Region.Min.X - 1, 0), FMath::Max(Region.Min.Y - 1, 0), FMath::Max(Region.Min.Z - 1, 0));
+    const FIntVector Max(FMath::Min(Region.Max.X + 1, SizeX - 1), FMath::Min(Region.Max.Y + 1, SizeY - 1), FMath::Min(Region.Max.Z + 1, SizeZ - 1));
+
+    for (int32 Z = Min.Z; Z <= Max.Z; ++Z)
+    {
+        for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+        {
+            for (int32 X = Min.X; X <= Max.X; ++X)
+            {
+                const int32 Index = (Z * SizeY + Y) * SizeX + X;
+                uint32 Mask = 0;
+                for (int32 Direction = 0; Direction < NumDirections; ++Direction)
+                {
+                    if (!(AllowedDirectionsMask & (1u << Direction))) continue;
+
+                    const FIntVector& Dir = Directions[Direction];
+                    const int32 NX = X + Dir.X, NY = Y + Dir.Y, NZ = Z + Dir.Z;
+                    if (NX < 0 || NX >= SizeX || NY < 0 || NY >= SizeY || NZ < 0 || NZ >= SizeZ) continue;
+
+                    if (IsTraversable(Index + DirectionIndexOffsets[Direction]))
+                    {
+                        Mask |= 1u << Direction;
+                    }
+                }
+                NeighborMasks[Index] = Mask;
+            }
+        }
+    }
+}
+
+void FNavGrid::RebuildClearance()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavGrid::RebuildClearance"));
+
+    Clearance.SetNumUninitialized(NumCells);
+    if (NumCells > 0)
+    {
+        const FNavGridRegion Everything{FIntVector::ZeroValue, FIntVector(SizeX - 1, SizeY - 1, SizeZ - 1)};
+        ComputeClearance(Everything, Everything);
+    }
+}
+
+void FNavGrid::RebuildClearance(const FNavGridRegion& Region)
+{
+    if (!HasClearance())
+    {
+        return;
+    }
+
+    // A changed cell moves clearance at most MaxClearance cells away, and those cells only see obstacles up to
+    // MaxClearance further out.
+    auto Grow = [this](const FNavGridRegion& In, int32 Amount)
+    {
+        return FNavGridRegion{
+            FIntVector(FMath::Max(In.Min.X - Amount, 0), FMath::Max(In.Min.Y - Amount, 0), FMath::Max(In.Min.Z - Amount, 0)),
+            FIntVector(FMath::Min(In.Max.X + Amount, SizeX - 1), FMath::Min(In.Max.Y + Amount, SizeY - 1), FMath::Min(In.Max.Z + Amount, SizeZ - 1))};
+    };
+    ComputeClearance(Grow(Region, 2 * MaxClearance), Grow(Region, MaxClearance));
+}
+
+void FNavGrid::ComputeClearance(const FNavGridRegion& Box, const FNavGridRegion& WriteBox)
+{
+    const FIntVector BoxSize = Box.Max - Box.Min + FIntVector(1);
+    const int32 StrideY = BoxSize.X;
+    const int32 StrideZ = BoxSize.X * BoxSize.Y;
+    TArray<uint8> Distances;
+    Distances.SetNumUninitialized(StrideZ * BoxSize.Z);
+
+    // Directions that precede a cell in X-fastest scan order feed the forward pass; the rest feed the backward pass.
+    int32 ForwardDirections[NumDirections / 2];
+    int32 BackwardDirections[NumDirections / 2];
+    int32 NumForward = 0;
+    int32 NumBackward = 0;
+    for (int32 Direction = 0; Direction < NumDirections; ++Direction)
+    {
+        const FIntVector& Dir = Directions[Direction];
+        const bool bPrecedes = Dir.Z < 0 || (Dir.Z == 0 && (Dir.Y < 0 || (Dir.Y == 0 && Dir.X < 0)));
+        if (bPrecedes) { ForwardDirections[NumForward++] = Direction; }
+        else           { BackwardDirections[NumBackward++] = Direction; }
+    }
+
+    auto Relax = [&](int32 X, int32 Y, int32 Z, const int32* PassDirections, int32 NumPassDirections)
+    {
+        uint8& Distance = Distances[Z * StrideZ + Y * StrideY + X];
+        for (int32 Slot = 0; Slot < NumPassDirections && Distance > 1; ++Slot)
+        {
+            const FIntVector& Dir = Directions[PassDirections[Slot]];
+            const int32 NX = X + Dir.X, NY = Y + Dir.Y, NZ = Z + Dir.Z;
+            if (NX < 0 || NX >= BoxSize.X || NY < 0 || NY >= BoxSize.Y || NZ < 0 || NZ >= BoxSize.Z) continue;
+
+            Distance = FMath::Min<uint8>(Distance, Distances[NZ * StrideZ + NY * StrideY + NX] + 1);
+        }
+    };
+
+    for (int32 Z = 0; Z < BoxSize.Z; ++Z)
+    {
+        for (int32 Y = 0; Y < BoxSize.Y; ++Y)
+        {
+            for (int32 X = 0; X < BoxSize.X; ++X)
+            {
+                const bool bFree = IsTraversable(ToIndex(Box.Min + FIntVector(X, Y, Z)));
+                Distances[Z * StrideZ + Y * StrideY + X] = bFree ? MaxClearance : 0;
+                if (bFree)
+                {
+                    Relax(X, Y, Z, ForwardDirections, NumForward);
+                }
+            }
+        }
+    }
+    for (int32 Z = BoxSize.Z - 1; Z >= 0; --Z)
+    {
+        for (int32 Y = BoxSize.Y - 1; Y >= 0; --Y)
+        {
+            for (int32 X = BoxSize.X - 1; X >= 0; --X)
+            {
+                Relax(X, Y, Z, BackwardDirections, NumBackward);
+            }
+        }
+    }
+
+    for (int32 Z = WriteBox.Min.Z; Z <= WriteBox.Max.Z; ++Z)
+    {
+        for (int32 Y = WriteBox.Min.Y; Y <= WriteBox.Max.Y; ++Y)
+        {
+            for (int32 X = WriteBox.Min.X; X <= WriteBox.Max.X; ++X)
+            {
+                const FIntVector Local = FIntVector(X, Y, Z) - Box.Min;
+                Clearance[ToIndex(FIntVector(X, Y, Z))] = Distances[Local.Z * StrideZ + Local.Y * StrideY + Local.X];
+            }
+        }
+    }
+}
+
+void FNavGrid::RebuildNearestTraversable()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavGrid::RebuildNearestTraversable"));
+
+    // Padding bits past NumCells read as blocked but are never ranked, since they only follow real cells.
+    BlockedCountBeforeWord.SetNumUninitialized(TraversableBits.Num());
+    int32 BlockedSoFar = 0;
+    for (int32 Word = 0; Word < TraversableBits.Num(); ++Word)
+    {
+        BlockedCountBeforeWord[Word] = BlockedSoFar;
+        BlockedSoFar += 64 - FMath::CountBits(TraversableBits[Word]);
+    }
+    const int32 NumBlocked = NumCells - CountTraversable();
+
+    NearestTraversableByRank.Reset();
+    NearestTraversableByRank.Init(INDEX_NONE, NumBlocked);
+    if (NumBlocked == 0 || NumBlocked == NumCells)
+    {
+        return;
+    }
+
+    auto ForEachInBoundsNeighbor = [this](int32 Index, auto&& Func)
+    {
+        const FIntVector Coordinates = ToCoordinates(Index);
+        for (int32 Direction = 0; Direction < NumDirections; ++Direction)
+        {
+            if (IsInBounds(Coordinates + Directions[Direction]) && !Func(Index + DirectionIndexOffsets[Direction]))
+            {
+                return;
+            }
+        }
+    };
+
+    // Seeds are the blocked cells touching free space. Directions run faces, edges, corners, so the first
+    // free neighbour found is the closest.
+    TArray<int32> Frontier;
+    for (int32 Index = 0; Index < NumCells; ++Index)
+    {
+        if (IsTraversable(Index))
+        {
+            continue;
+        }
+        int32& Nearest = NearestTraversableByRank[GetBlockedRank(Index)];
+        ForEachInBoundsNeighbor(Index, [&](int32 NeighborIndex)
+        {
+            if (IsTraversable(NeighborIndex))
+            {
+                Nearest = NeighborIndex;
+                return false;
+            }
+            return true;
+        });
+        if (Nearest != INDEX_NONE)
+        {
+            Frontier.Add(Index);
+        }
+    }
+
+    // Layer by layer into the blocked interior; each cell inherits the free cell of whoever reached it first.
+    for (int32 Head = 0; Head < Frontier.Num(); ++Head)
+    {
+        const int32 Index = Frontier[Head];
+        const int32 Nearest = NearestTraversableByRank[GetBlockedRank(Index)];
+        ForEachInBoundsNeighbor(Index, [&](int32 NeighborIndex)
+        {
+            if (!IsTraversable(NeighborIndex))
+            {
+                int32& NeighborNearest = NearestTraversableByRank[GetBlockedRank(NeighborIndex)];
+                if (NeighborNearest == INDEX_NONE)
+                {
+                    NeighborNearest = Nearest;
+                    Frontier.Add(NeighborIndex);
+                }
+            }
+            return true;
+        });
+    }
+}
+
+int32 FNavGrid::CountTraversable() const
+{
+    int32 Count = 0;
+    for (const uint64 Word : TraversableBits)
+    {
+        Count += FMath::CountBits(Word);
+    }
+    return Count;
+}
+
+SIZE_T FNavGrid::GetAllocatedSize() const
+{
+    return TraversableBits.GetAllocatedSize() + NeighborMasks.GetAllocatedSize() + Clearance.GetAllocatedSize()
+        + BlockedCountBeforeWord.GetAllocatedSize() + NearestTraversableByRank.GetAllocatedSize();
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Box of cells, bounds inclusive on every axis.
+struct FNavGridRegion
+{
+    FIntVector Min = FIntVector::ZeroValue;
+    FIntVector Max = FIntVector::ZeroValue;
+
+    FORCEINLINE bool Intersects(const FIntVector& OtherMin, const FIntVector& OtherMax) const
+    {
+        return Min.X <= OtherMax.X && Max.X >= OtherMin.X &&
+               Min.Y <= OtherMax.Y && Max.Y >= OtherMin.Y &&
+               Min.Z <= OtherMax.Z && Max.Z >= OtherMin.Z;
+    }
+};
+
+// Flat structure-of-arrays voxel grid used by ANavigationVolume3D.
+// Coordinates are derived from the linear index (X fastest, then Y, then Z), traversability is a packed
+// bitset and connectivity is a per-voxel 26-bit mask of open neighbours. Bit D of a mask refers to
+// direction GetDirection(D); the neighbour's index is simply Index + GetIndexOffset(D).
+struct NAVIGATION3D_API FNavGrid
+{
+    static constexpr int32 NumDirections = 26;
+
+    // Clearance is stored per cell up to this many cells; anything farther from an obstacle reads as MaxClearance.
+    static constexpr int32 MaxClearance = 16;
+
+    // Allocates an all-traversable grid. Neighbour masks stay empty until RebuildNeighborMasks is called.
+    void Initialize(int32 InSizeX, int32 InSizeY, int32 InSizeZ, int32 MinSharedNeighborAxes);
+    void Empty();
+
+    FORCEINLINE bool IsEmpty() const { return NumCells == 0; }
+    FORCEINLINE int32 Num() const { return NumCells; }
+    FORCEINLINE FIntVector GetSize() const { return FIntVector(SizeX, SizeY, SizeZ); }
+
+    FORCEINLINE int32 ToIndex(const FIntVector& Coordinates) const
+    {
+        return (Coordinates.Z * SizeY + Coordinates.Y) * SizeX + Coordinates.X;
+    }
+
+    FORCEINLINE FIntVector ToCoordinates(int32 Index) const
+    {
+        const int32 X = Index % SizeX;
+        const int32 YZ = Index / SizeX;
+        return FIntVector(X, YZ % SizeY, YZ / SizeY);
+    }
+
+    FORCEINLINE bool IsInBounds(const FIntVector& Coordinates) const
+    {
+        return Coordinates.X >= 0 && Coordinates.X < SizeX &&
+               Coordinates.Y >= 0 && Coordinates.Y < SizeY &&
+               Coordinates.Z >= 0 && Coordinates.Z < SizeZ;
+    }
+
+    FORCEINLINE bool IsTraversable(int32 Index) const
+    {
+        return (TraversableBits[Index >> 6] >> (Index & 63)) & 1ull;
+    }
+
+    FORCEINLINE void SetTraversable(int32 Index, bool bTraversable)
+    {
+        const uint64 Bit = 1ull << (Index & 63);
+        if (bTraversable) { TraversableBits[Index >> 6] |= Bit; }
+        else              { TraversableBits[Index >> 6] &= ~Bit; }
+    }
+
+    FORCEINLINE uint32 GetOpenNeighborMask(int32 Index) const { return NeighborMasks[Index]; }
+
+    FORCEINLINE int32 GetIndexOffset(int32 Direction) const { return DirectionIndexOffsets[Direction]; }
+    FORCEINLINE static const FIntVector& GetDirection(int32 Direction) { return Directions[Direction]; }
+    FORCEINLINE static float GetDirectionCost(int32 Direction) { return DirectionCosts[Direction]; }
+    FORCEINLINE uint32 GetAllowedDirectionsMask() const { return AllowedDirectionsMask; }
+
+    // Direction index of a unit offset (each component in [-1, 1]), or INDEX_NONE for zero or longer offsets.
+    static int32 FindDirection(const FIntVector& Offset);
+
+    // Recomputes the open-neighbour masks from the traversability bits. Call after changing traversability.
+    void RebuildNeighborMasks();
+
+    // Recomputes only the masks that can see a cell of Region, i.e. Region grown by one cell, clamped to the grid.
+    void RebuildNeighborMasks(const FNavGridRegion& Region);
+
+    // Chebyshev distance in cells from a cell to the nearest blocked cell, capped at MaxClearance; 0 for blocked
+    // cells. Cells within Clearance - 1 steps in every direction are free, so a cube of half-size
+    // (Clearance - 0.5) cells around the cell centre touches no obstacle. Cells outside the grid do not count
+    // as obstacles. Empty until RebuildClearance is called.
+    FORCEINLINE uint8 GetClearance(int32 Index) const { return Clearance[Index]; }
+    FORCEINLINE bool HasClearance() const { return Clearance.Num() == NumCells && NumCells > 0; }
+
+    // Two-pass 26-neighbour chamfer distance transform, exact for the Chebyshev metric.
+    void RebuildClearance();
+
+    // Recomputes clearance for the cells that a traversability change inside Region can affect.
+    void RebuildClearance(const FNavGridRegion& Region);
+
+    // Index itself if it is traversable, otherwise the free cell RebuildNearestTraversable assigned to it.
+    // INDEX_NONE if the table is not built or no cell of the grid is free. Constant time: blocked cells are
+    // ranked by a per-word prefix count over the traversability bits, and the table holds one entry per rank.
+    FORCEINLINE int32 FindNearestTraversable(int32 Index) const
+    {
+        if (IsTraversable(Index))
+        {
+            return Index;
+        }
+        return NearestTraversableByRank.Num() > 0 ? NearestTraversableByRank[GetBlockedRank(Index)] : INDEX_NONE;
+    }
+
+    // For every blocked cell, the free cell reached first by a breadth-first search through blocked cells over
+    // all 26 directions, i.e. one at the smallest Chebyshev distance, preferring face over edge over corner
+    // steps next to the free space. Call after changing traversability; the ranks of every later cell move.
+    void RebuildNearestTraversable();
+
+    int32 CountTraversable() const;
+    SIZE_T GetAllocatedSize() const;
+
+    // Sizes, connectivity, traversability bits, neighbour masks, clearance and the nearest-traversable table, as
+    // stored in baked navigation data.
+    void Serialize(FArchive& Ar);
+
+private:
+    void ComputeIndexOffsets();
+
+    // Runs the distance transform over the cells of Box (obstacles outside it are ignored) and stores the
+    // results for the cells of WriteBox, which must lie inside Box.
+    void ComputeClearance(const FNavGridRegion& Box, const FNavGridRegion& WriteBox);
+
+    // Number of blocked cells before Index. Only valid while BlockedCountBeforeWord matches the bits.
+    FORCEINLINE int32 GetBlockedRank(int32 Index) const
+    {
+        const uint64 BelowMask = (1ull << (Index & 63)) - 1;
+        return BlockedCountBeforeWord[Index >> 6] + FMath::CountBits(~TraversableBits[Index >> 6] & BelowMask);
+    }
+
+    int32 SizeX = 0;
+    int32 SizeY = 0;
+    int32 SizeZ = 0;
+    int32 NumCells = 0;
+
+    // Directions permitted by the volume's MinSharedNeighborAxes setting.
+    uint32 AllowedDirectionsMask = 0;
+    int32 DirectionIndexOffsets[NumDirections] = {};
+
+    TArray<uint64> TraversableBits;
+    TArray<uint32> NeighborMasks;
+    TArray<uint8> Clearance;
+    TArray<int32> BlockedCountBeforeWord;
+    TArray<int32> NearestTraversableByRank;
+
+    static const FIntVector Directions[NumDirections];
+    static const float DirectionCosts[NumDirections];
+};
+
+// FNavGrid as an A* graph (see NavAStar.h). Edge costs and the heuristic are in cell units.
+struct FNavGridGraph
+{
+    const FNavGrid& Grid;
+    const FVector GoalCoordinates;
+
+    FNavGridGraph(const FNavGrid& InGrid, const FIntVector& InGoalCoordinates)
+        : Grid(InGrid)
+        , GoalCoordinates(InGoalCoordinates)
+    {
+    }
+
+    FORCEINLINE float Heuristic(int32 NodeIndex) const
+    {
+        return FVector::Distance(GoalCoordinates, FVector(Grid.ToCoordinates(NodeIndex)));
+    }
+
+    template<typename FuncType>
+    FORCEINLINE void ForEachNeighbor(int32 NodeIndex, FuncType&& Func) const
+    {
+        // The open-neighbour mask already excludes out-of-bounds, disallowed and blocked neighbours.
+        uint32 OpenNeighbors = Grid.GetOpenNeighborMask(NodeIndex);
+        while (OpenNeighbors != 0)
+        {
+            const int32 Direction = FMath::CountTrailingZeros(OpenNeighbors);
+            OpenNeighbors &= OpenNeighbors - 1;
+            Func(NodeIndex + Grid.GetIndexOffset(Direction), FNavGrid::GetDirectionCost(Direction));
+        }
+    }
+};
+
+// FNavGridGraph for agents wider than a point: skips neighbours whose clearance is below MinClearance (the goal is
+// always accepted) and, with OpenSpaceWeight > 0, scales each step by 1 + OpenSpaceWeight / Clearance so paths
+// keep away from walls where they can. Costs never drop below the plain grid's, so the heuristic stays admissible.
+struct FNavGridClearanceGraph
+{
+    const FNavGrid& Grid;
+    const FVector GoalCoordinates;
+    const int32 GoalIndex;
+    const uint8 MinClearance;
+    const float OpenSpaceWeight;
+
+    FNavGridClearanceGraph(const FNavGrid& InGrid, int32 InGoalIndex, uint8 InMinClearance, float InOpenSpaceWeight)
+        : Grid(InGrid)
+        , GoalCoordinates(InGrid.ToCoordinates(InGoalIndex))
+        , GoalIndex(InGoalIndex)
+        , MinClearance(InMinClearance)
+        , OpenSpaceWeight(InOpenSpaceWeight)
+    {
+    }
+
+    FORCEINLINE float Heuristic(int32 NodeIndex) const
+    {
+        return FVector::Distance(GoalCoordinates, FVector(Grid.ToCoordinates(NodeIndex)));
+    }
+
+    template<typename FuncType>
+    FORCEINLINE void ForEachNeighbor(int32 NodeIndex, FuncType&& Func) const
+    {
+        uint32 OpenNeighbors = Grid.GetOpenNeighborMask(NodeIndex);
+        while (OpenNeighbors != 0)
+        {
+            const int32 Direction = FMath::CountTrailingZeros(OpenNeighbors);
+            OpenNeighbors &= OpenNeighbors - 1;
+
+            const int32 NeighborIndex = NodeIndex + Grid.GetIndexOffset(Direction);
+            const uint8 NeighborClearance = Grid.GetClearance(NeighborIndex);
+            if (NeighborClearance < MinClearance && NeighborIndex != GoalIndex)
+            {
+                continue;
+            }
+            Func(NeighborIndex, FNavGrid::GetDirectionCost(Direction) * (1.0f + OpenSpaceWeight / FMath::Max<uint8>(NeighborClearance, 1)));
+        }
+    }
+};
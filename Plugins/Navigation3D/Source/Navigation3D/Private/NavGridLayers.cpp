@@ -0,0 +1,192 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NavGridLayers.h"
+#include "NavSearchContext.h"
+
+void FNavGridMipChain::Build(const FNavGrid& Fine, int32 NumCoarseLevels, int32 MinSharedNeighborAxes)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavGridMipChain::Build"));
+
+    Empty();
+    if (Fine.IsEmpty())
+    {
+        return;
+    }
+
+    Levels.SetNum(FMath::Clamp(NumCoarseLevels, 0, MaxCoarseLevels));
+    const FNavGrid* Finer = &Fine;
+    for (FNavGrid& LevelGrid : Levels)
+    {
+        const FIntVector FinerSize = Finer->GetSize();
+        LevelGrid.Initialize(FMath::DivideAndRoundUp(FinerSize.X, 2), FMath::DivideAndRoundUp(FinerSize.Y, 2), FMath::DivideAndRoundUp(FinerSize.Z, 2), MinSharedNeighborAxes);
+
+        FNavGridRegion WholeLevel;
+        WholeLevel.Max = LevelGrid.GetSize() - FIntVector(1);
+        ReduceRegion(*Finer, LevelGrid, WholeLevel);
+        LevelGrid.RebuildNeighborMasks();
+        LevelGrid.RebuildClearance();
+        LevelGrid.RebuildNearestTraversable();
+        Finer = &LevelGrid;
+    }
+}
+
+void FNavGridMipChain::UpdateRegions(const FNavGrid& Fine, TConstArrayView<FNavGridRegion> DirtyRegions)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavGridMipChain::UpdateRegions"));
+
+    const FNavGrid* Finer = &Fine;
+    for (int32 LevelIndex = 0; LevelIndex < Levels.Num(); ++LevelIndex)
+    {
+        FNavGrid& LevelGrid = Levels[LevelIndex];
+        const FIntVector LevelMax = LevelGrid.GetSize() - FIntVector(1);
+        bool bAnyChanged = false;
+        for (const FNavGridRegion& Region : DirtyRegions)
+        {
+            // Level L - 1 was brought up to date first, so reducing it covers every dirty fine cell below.
+            FNavGridRegion LevelRegion;
+            LevelRegion.Min = ToLevelCoordinates(Region.Min, LevelIndex + 1);
+            LevelRegion.Max = ToLevelCoordinates(Region.Max, LevelIndex + 1);
+            LevelRegion.Max = FIntVector(FMath::Min(LevelRegion.Max.X, LevelMax.X), FMath::Min(LevelRegion.Max.Y, LevelMax.Y), FMath::Min(LevelRegion.Max.Z, LevelMax.Z));
+            if (ReduceRegion(*Finer, LevelGrid, LevelRegion))
+            {
+                LevelGrid.RebuildNeighborMasks(LevelRegion);
+                LevelGrid.RebuildClearance(LevelRegion);
+                bAnyChanged = true;
+            }
+        }
+        if (bAnyChanged)
+        {
+            LevelGrid.RebuildNearestTraversable();
+        }
+        Finer = &LevelGrid;
+    }
+}
+
+void FNavGridMipChain::Empty()
+{
+    Levels.Empty();
+}
+
+SIZE_T FNavGridMipChain::GetAllocatedSize() const
+{
+    SIZE_T Size = Levels.GetAllocatedSize();
+    for (const FNavGrid& Level : Levels)
+    {
+        Size += Level.GetAllocatedSize();
+    }
+    return Size;
+}
+
+bool FNavGridMipChain::ReduceRegion(const FNavGrid& Finer, FNavGrid& Coarse, const FNavGridRegion& CoarseRegion)
+{
+    bool bChanged = false;
+    for (int32 Z = CoarseRegion.Min.Z; Z <= CoarseRegion.Max.Z; ++Z)
+    {
+        for (int32 Y = CoarseRegion.Min.Y; Y <= CoarseRegion.Max.Y; ++Y)
+        {
+            for (int32 X = CoarseRegion.Min.X; X <= CoarseRegion.Max.X; ++X)
+            {
+                const FIntVector FirstChild(X * 2, Y * 2, Z * 2);
+                bool bFree = true;
+                for (int32 Child = 0; Child < 8 && bFree; ++Child)
+                {
+                    const FIntVector ChildCoordinates = FirstChild + FIntVector(Child & 1, (Child >> 1) & 1, Child >> 2);
+                    bFree = Finer.IsInBounds(ChildCoordinates) && Finer.IsTraversable(Finer.ToIndex(ChildCoordinates));
+                }
+
+                const int32 Index = Coarse.ToIndex(FIntVector(X, Y, Z));
+                if (Coarse.IsTraversable(Index) != bFree)
+                {
+                    Coarse.SetTraversable(Index, bFree);
+                    bChanged = true;
+                }
+            }
+        }
+    }
+    return bChanged;
+}
+
+int32 FNavGridMipChain::FindLevelCell(const FNavGrid& Fine, int32 Level, int32 FineIndex) const
+{
+    const FNavGrid& LevelGrid = GetLevel(Level);
+    const FIntVector Coordinates = ToLevelCoordinates(Fine.ToCoordinates(FineIndex), Level);
+    const int32 NearestIndex = LevelGrid.FindNearestTraversable(LevelGrid.ToIndex(Coordinates));
+    if (NearestIndex == INDEX_NONE)
+    {
+        return INDEX_NONE;
+    }
+
+    // Beyond a touching cell the level route would start or end out of the fine cell's reach.
+    const FIntVector Offset = LevelGrid.ToCoordinates(NearestIndex) - Coordinates;
+    return FMath::Max3(FMath::Abs(Offset.X), FMath::Abs(Offset.Y), FMath::Abs(Offset.Z)) <= 1 ? NearestIndex : INDEX_NONE;
+}
+
+ENavAStarStatus FNavGridMipChain::FindPath(const FNavGrid& Fine, int32 Level, int32 FineStartIndex, int32 FineGoalIndex, uint8 MinClearance,
+    float OpenSpaceWeight, FNavSearchContextPool& SearchContextPool, const std::atomic<bool>* bCancelled, TArray<int32>& OutPathIndices) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavGridMipChain::FindPath"));
+    OutPathIndices.Reset();
+
+    const int32 StartIndex = FindLevelCell(Fine, Level, FineStartIndex);
+    const int32 GoalIndex = FindLevelCell(Fine, Level, FineGoalIndex);
+    if (StartIndex == INDEX_NONE || GoalIndex == INDEX_NONE)
+    {
+        return ENavAStarStatus::NoPath;
+    }
+    if (StartIndex == GoalIndex)
+    {
+        OutPathIndices.Add(StartIndex);
+        return ENavAStarStatus::Found;
+    }
+
+    const FNavGrid& LevelGrid = GetLevel(Level);
+    FScopedNavSearchContext ScopedSearchContext(SearchContextPool, LevelGrid.Num());
+    FNavAStarParams Params;
+    Params.StartIndex = StartIndex;
+    Params.GoalIndex = GoalIndex;
+    Params.bCancelled = bCancelled;
+    FNavAStarNullVisitor Visitor;
+
+    ENavAStarStatus Status;
+    if (MinClearance > 1 || OpenSpaceWeight > 0.0f)
+    {
+        const FNavGridClearanceGraph ClearanceGraph(LevelGrid, GoalIndex, MinClearance, OpenSpaceWeight);
+        Status = RunNavAStar(ClearanceGraph, ScopedSearchContext.Get(), Params, Visitor);
+    }
+    else
+    {
+        const FNavGridGraph GridGraph(LevelGrid, LevelGrid.ToCoordinates(GoalIndex));
+        Status = RunNavAStar(GridGraph, ScopedSearchContext.Get(), Params, Visitor);
+    }
+
+    if (Status == ENavAStarStatus::Found)
+    {
+        ReconstructNavPath(ScopedSearchContext.Get(), GoalIndex, OutPathIndices);
+    }
+    return Status;
+}
+
+void FNavGridMipChain::BuildCorridor(int32 Level, TConstArrayView<int32> LevelPath, TBitArray<>& OutCorridor) const
+{
+    const FNavGrid& LevelGrid = GetLevel(Level);
+    OutCorridor.Init(false, LevelGrid.Num());
+    for (const int32 PathIndex : LevelPath)
+    {
+        const FIntVector Coordinates = LevelGrid.ToCoordinates(PathIndex);
+        for (int32 DZ = -1; DZ <= 1; ++DZ)
+        {
+            for (int32 DY = -1; DY <= 1; ++DY)
+            {
+                for (int32 DX = -1; DX <= 1; ++DX)
+                {
+                    const FIntVector Neighbor = Coordinates + FIntVector(DX, DY, DZ);
+                    if (LevelGrid.IsInBounds(Neighbor))
+                    {
+                        OutCorridor[LevelGrid.ToIndex(Neighbor)] = true;
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavGrid.h"
+#include "NavAStar.h"
+
+class FNavSearchContextPool;
+
+// Coarser copies of a dense FNavGrid, each at half the resolution of the one below it: cell C of level L covers
+// the fine cells [C * 2^L, (C + 1) * 2^L) on every axis. Levels are derived from the fine traversability alone by
+// OR-reducing blocked cells, and cells reaching past the fine grid's edge count as blocked, so a free cell of any
+// level keeps a cube of its own size clear and every route through free level cells also exists at full
+// resolution. Each level carries its own neighbour masks, clearance and nearest-traversable table, so the plain
+// grid graphs run on it unchanged. Read-only while queries run.
+class FNavGridMipChain
+{
+public:
+    static constexpr int32 MaxCoarseLevels = 3;
+
+    // Derives NumCoarseLevels levels (at most MaxCoarseLevels) from Fine, which must be fully built.
+    void Build(const FNavGrid& Fine, int32 NumCoarseLevels, int32 MinSharedNeighborAxes);
+
+    // Re-reduces the level cells covering DirtyRegions after the traversability of Fine changed inside them.
+    void UpdateRegions(const FNavGrid& Fine, TConstArrayView<FNavGridRegion> DirtyRegions);
+
+    void Empty();
+
+    FORCEINLINE int32 NumCoarseLevels() const { return Levels.Num(); }
+
+    // Level must be in [1, NumCoarseLevels()]; level 0 is the fine grid itself.
+    FORCEINLINE const FNavGrid& GetLevel(int32 Level) const { return Levels[Level - 1]; }
+
+    FORCEINLINE static FIntVector ToLevelCoordinates(const FIntVector& FineCoordinates, int32 Level)
+    {
+        return FIntVector(FineCoordinates.X >> Level, FineCoordinates.Y >> Level, FineCoordinates.Z >> Level);
+    }
+
+    // Centre of a level cell in fine cell space, where fine cell C spans [C, C + 1).
+    FORCEINLINE static FVector GetCellCenter(const FIntVector& LevelCoordinates, int32 Level)
+    {
+        return (FVector(LevelCoordinates) + 0.5) * static_cast<double>(1 << Level);
+    }
+
+    SIZE_T GetAllocatedSize() const;
+
+    // A* on one level between the level cells covering two free fine cells; OutPathIndices holds level cell
+    // indices. A blocked covering cell is replaced by the nearest free level cell if that one touches it.
+    // MinClearance and OpenSpaceWeight mean what they do for FNavGridClearanceGraph, in level cells. NoPath only
+    // says the level has no route: openings narrower than two level cells may have been closed by the reduction.
+    ENavAStarStatus FindPath(const FNavGrid& Fine, int32 Level, int32 FineStartIndex, int32 FineGoalIndex, uint8 MinClearance,
+        float OpenSpaceWeight, FNavSearchContextPool& SearchContextPool, const std::atomic<bool>* bCancelled, TArray<int32>& OutPathIndices) const;
+
+    // Marks the level cells of LevelPath and every cell touching one of them, for TNavCorridorGraph.
+    void BuildCorridor(int32 Level, TConstArrayView<int32> LevelPath, TBitArray<>& OutCorridor) const;
+
+private:
+    // Recomputes the traversability of Coarse's cells inside CoarseRegion from their eight children in Finer.
+    // Returns true if any of them changed.
+    static bool ReduceRegion(const FNavGrid& Finer, FNavGrid& Coarse, const FNavGridRegion& CoarseRegion);
+
+    int32 FindLevelCell(const FNavGrid& Fine, int32 Level, int32 FineIndex) const;
+
+    TArray<FNavGrid> Levels;
+};
+
+// Restricts a fine grid graph to the cells whose level-Level parent is set in Corridor (see
+// FNavGridMipChain::BuildCorridor), so a full-resolution search refines a coarse route instead of flooding the
+// grid. Edge costs and the heuristic are the wrapped graph's, so paths are the shortest inside the corridor only.
+template<typename GraphType>
+struct TNavCorridorGraph
+{
+    const GraphType& Graph;
+    const FNavGrid& Grid;
+    const FNavGrid& LevelGrid;
+    const int32 Level;
+    const TBitArray<>& Corridor;
+
+    TNavCorridorGraph(const GraphType& InGraph, const FNavGrid& InGrid, const FNavGrid& InLevelGrid, int32 InLevel, const TBitArray<>& InCorridor)
+        : Graph(InGraph)
+        , Grid(InGrid)
+        , LevelGrid(InLevelGrid)
+        , Level(InLevel)
+        , Corridor(InCorridor)
+    {
+    }
+
+    FORCEINLINE float Heuristic(int32 NodeIndex) const
+    {
+        return Graph.Heuristic(NodeIndex);
+    }
+
+    template<typename FuncType>
+    FORCEINLINE void ForEachNeighbor(int32 NodeIndex, FuncType&& Func) const
+    {
+        Graph.ForEachNeighbor(NodeIndex, [this, &Func](int32 NeighborIndex, float Cost)
+        {
+            const FIntVector LevelCoordinates = FNavGridMipChain::ToLevelCoordinates(Grid.ToCoordinates(NeighborIndex), Level);
+            if (Corridor[LevelGrid.ToIndex(LevelCoordinates)])
+            {
+                Func(NeighborIndex, Cost);
+            }
+        });
+    }
+};
@@ -0,0 +1,677 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NavHierarchy.h"
+#include "NavSearchContext.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+    // Whether a diagonal step from Cell along Direction can also be made as face steps through free cells.
+    bool HasFaceDetour(const FNavGrid& Grid, const FIntVector& Cell, const FIntVector& Direction)
+    {
+        FIntVector Steps[3];
+        int32 NumSteps = 0;
+        for (int32 Axis = 0; Axis < 3; ++Axis)
+        {
+            if (Direction[Axis] != 0)
+            {
+                FIntVector Step = FIntVector::ZeroValue;
+                Step[Axis] = Direction[Axis];
+                Steps[NumSteps++] = Step;
+            }
+        }
+
+        // The intermediate cells lie inside the box spanned by Cell and its neighbour, so they are in bounds.
+        for (int32 First = 0; First < NumSteps; ++First)
+        {
+            const FIntVector Via = Cell + Steps[First];
+            if (!Grid.IsTraversable(Grid.ToIndex(Via)))
+            {
+                continue;
+            }
+            if (NumSteps == 2)
+            {
+                return true;
+            }
+            for (int32 Second = 0; Second < NumSteps; ++Second)
+            {
+                if (Second != First && Grid.IsTraversable(Grid.ToIndex(Via + Steps[Second])))
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Reports the nodes of an abstract search to a grid visitor as the cells they stand for.
+    template<typename QueryGraphType, typename VisitorType>
+    struct TNavAbstractNodeVisitor
+    {
+        const QueryGraphType& QueryGraph;
+        VisitorType& Inner;
+
+        TNavAbstractNodeVisitor(const QueryGraphType& InQueryGraph, VisitorType& InInner)
+            : QueryGraph(InQueryGraph), Inner(InInner)
+        {
+        }
+
+        FORCEINLINE void OnPopped(int32 NodeIndex) { Inner.OnPopped(QueryGraph.GetCellIndex(NodeIndex)); }
+        FORCEINLINE void OnClosed(int32 NodeIndex) { Inner.OnClosed(QueryGraph.GetCellIndex(NodeIndex)); }
+        FORCEINLINE void OnNeighborConsidered(int32 FromIndex, int32 ToIndex) { Inner.OnNeighborConsidered(QueryGraph.GetCellIndex(FromIndex), QueryGraph.GetCellIndex(ToIndex)); }
+        FORCEINLINE void OnNeighborImproved(int32 FromIndex, int32 ToIndex) { Inner.OnNeighborImproved(QueryGraph.GetCellIndex(FromIndex), QueryGraph.GetCellIndex(ToIndex)); }
+    };
+}
+
+// Buffers of one FindPath call, kept per thread so steady-state queries do not allocate. The abstract search has
+// its own context because borrowing a grid-sized one from the pool would resize it on every query.
+struct FNavClusterHierarchy::FQueryScratch
+{
+    FNavSearchContext AbstractSearch;
+    TArray<FEntranceCost> StartCosts;
+    TArray<FEntranceCost> GoalCosts;
+    TArray<int32> AbstractPath;
+    TArray<int32> Segment;
+};
+
+// Abstract graph of one query: the shared entrance graph plus the query's start and goal, which only
+// this query knows about. Start is node NumAbstractNodes(), goal is the one after it.
+struct FNavClusterHierarchy::FQueryGraph
+{
+    const FNavClusterHierarchy& Hierarchy;
+    const FNavGrid& Grid;
+    const TArray<FEntranceCost>& StartCosts;
+    const TArray<FEntranceCost>& GoalCosts;
+    const int32 GoalCluster;
+    const FVector GoalCoordinates;
+    const int32 StartNode;
+    const int32 GoalNode;
+    const int32 GoalCellIndex;
+    const int32 StartCellIndex;
+
+    FQueryGraph(const FNavClusterHierarchy& InHierarchy, const FNavGrid& InGrid, int32 InStartCellIndex, int32 InGoalCellIndex,
+        const TArray<FEntranceCost>& InStartCosts, const TArray<FEntranceCost>& InGoalCosts)
+        : Hierarchy(InHierarchy)
+        , Grid(InGrid)
+        , StartCosts(InStartCosts)
+        , GoalCosts(InGoalCosts)
+        , GoalCluster(InHierarchy.GetClusterIndex(InGrid.ToCoordinates(InGoalCellIndex)))
+        , GoalCoordinates(InGrid.ToCoordinates(InGoalCellIndex))
+        , StartNode(InHierarchy.NumAbstractNodes())
+        , GoalNode(InHierarchy.NumAbstractNodes() + 1)
+        , GoalCellIndex(InGoalCellIndex)
+        , StartCellIndex(InStartCellIndex)
+    {
+    }
+
+    FORCEINLINE int32 GetCellIndex(int32 NodeIndex) const
+    {
+        if (NodeIndex == StartNode) return StartCellIndex;
+        if (NodeIndex == GoalNode) return GoalCellIndex;
+        return Hierarchy.AbstractNodeCells[NodeIndex];
+    }
+
+    FORCEINLINE float Heuristic(int32 NodeIndex) const
+    {
+        return FVector::Distance(GoalCoordinates, FVector(Grid.ToCoordinates(GetCellIndex(NodeIndex))));
+    }
+
+    template<typename FuncType>
+    void ForEachNeighbor(int32 NodeIndex, FuncType&& Func) const
+    {
+        if (NodeIndex == GoalNode)
+        {
+            return;
+        }
+        if (NodeIndex == StartNode)
+        {
+            for (const FEntranceCost& Entry : StartCosts)
+            {
+                Func(Entry.AbstractNode, Entry.Cost);
+            }
+            return;
+        }
+
+        for (int32 Edge = Hierarchy.EdgeOffsets[NodeIndex]; Edge < Hierarchy.EdgeOffsets[NodeIndex + 1]; ++Edge)
+        {
+            Func(Hierarchy.EdgeTargets[Edge], Hierarchy.EdgeCosts[Edge]);
+        }
+        if (Hierarchy.AbstractNodeClusters[NodeIndex] == GoalCluster)
+        {
+            for (const FEntranceCost& Entry : GoalCosts)
+            {
+                if (Entry.AbstractNode == NodeIndex)
+                {
+                    Func(GoalNode, Entry.Cost);
+                    break;
+                }
+            }
+        }
+    }
+};
+
+void FNavClusterHierarchy::Build(const FNavGrid& Grid, int32 InClusterSize, FNavSearchContextPool& SearchContextPool)
+{
+    BuildInternal(Grid, InClusterSize, SearchContextPool, nullptr, TConstArrayView<FNavGridRegion>());
+}
+
+void FNavClusterHierarchy::UpdateRegions(const FNavGrid& Grid, TConstArrayView<FNavGridRegion> DirtyRegions, FNavSearchContextPool& SearchContextPool)
+{
+    if (IsEmpty())
+    {
+        return;
+    }
+    const FNavClusterHierarchy Previous = MoveTemp(*this);
+    BuildInternal(Grid, Previous.ClusterSize, SearchContextPool, &Previous, DirtyRegions);
+}
+
+void FNavClusterHierarchy::BuildInternal(const FNavGrid& Grid, int32 InClusterSize, FNavSearchContextPool& SearchContextPool,
+    const FNavClusterHierarchy* Previous, TConstArrayView<FNavGridRegion> DirtyRegions)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavClusterHierarchy::Build"));
+
+    Empty();
+    if (Grid.IsEmpty() || InClusterSize <= 0)
+    {
+        return;
+    }
+
+    ClusterSize = InClusterSize;
+    GridSize = Grid.GetSize();
+    NumClusters = FIntVector(
+        FMath::DivideAndRoundUp(GridSize.X, ClusterSize),
+        FMath::DivideAndRoundUp(GridSize.Y, ClusterSize),
+        FMath::DivideAndRoundUp(GridSize.Z, ClusterSize));
+    const int32 TotalClusters = NumClusters.X * NumClusters.Y * NumClusters.Z;
+    check(!Previous || (Previous->ClusterSize == ClusterSize && Previous->GridSize == GridSize));
+
+    // 1. Entrances. For each axis, walk every boundary plane between two clusters and split the cells that can
+    //    step straight across it into 4-connected openings. Each opening contributes one entrance pair, taken
+    //    at the cell closest to the opening's centroid.
+    TMap<int32, int32> CellToAbstractNode;
+    TArray<TPair<int32, int32>> InterEdges;
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavClusterHierarchy::Build_Entrances"));
+
+        TArray<int32> OpeningLabels;
+        TArray<FIntPoint> FloodStack;
+        TArray<FIntPoint> OpeningCells;
+        for (int32 Axis = 0; Axis < 3; ++Axis)
+        {
+            const int32 AxisU = (Axis + 1) % 3;
+            const int32 AxisV = (Axis + 2) % 3;
+            const int32 PositiveFaceDirection = Axis * 2 + 1; // +X, +Y, +Z in FNavGrid's direction table.
+            const int32 PlaneSizeU = GridSize[AxisU];
+            const int32 PlaneSizeV = GridSize[AxisV];
+
+            for (int32 Boundary = ClusterSize; Boundary < GridSize[Axis]; Boundary += ClusterSize)
+            {
+                auto ToCell = [&](const FIntPoint& PlanePoint)
+                {
+                    FIntVector Cell;
+                    Cell[Axis] = Boundary - 1;
+                    Cell[AxisU] = PlanePoint.X;
+                    Cell[AxisV] = PlanePoint.Y;
+                    return Cell;
+                };
+                auto IsOpen = [&](const FIntPoint& PlanePoint)
+                {
+                    return (Grid.GetOpenNeighborMask(Grid.ToIndex(ToCell(PlanePoint))) & (1u << PositiveFaceDirection)) != 0;
+                };
+
+                // Openings are also cut where the plane crosses a cluster border, so each belongs to exactly one cluster pair.
+                OpeningLabels.Reset();
+                OpeningLabels.SetNumZeroed(PlaneSizeU * PlaneSizeV);
+                for (int32 V = 0; V < PlaneSizeV; ++V)
+                {
+                    for (int32 U = 0; U < PlaneSizeU; ++U)
+                    {
+                        if (OpeningLabels[V * PlaneSizeU + U] != 0 || !IsOpen(FIntPoint(U, V)))
+                        {
+                            continue;
+                        }
+
+                        const int32 TileU = U / ClusterSize;
+                        const int32 TileV = V / ClusterSize;
+                        OpeningCells.Reset();
+                        FloodStack.Reset();
+                        FloodStack.Add(FIntPoint(U, V));
+                        OpeningLabels[V * PlaneSizeU + U] = 1;
+                        FVector2D Centroid = FVector2D::ZeroVector;
+                        while (FloodStack.Num() > 0)
+                        {
+                            const FIntPoint Point = FloodStack.Pop(EAllowShrinking::No);
+                            OpeningCells.Add(Point);
+                            Centroid += FVector2D(Point.X, Point.Y);
+
+                            const FIntPoint Offsets[4] = { FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1) };
+                            for (const FIntPoint& Offset : Offsets)
+                            {
+                                const FIntPoint Next = Point + Offset;
+                                if (Next.X < 0 || Next.X >= PlaneSizeU || Next.Y < 0 || Next.Y >= PlaneSizeV) continue;
+                                if (Next.X / ClusterSize != TileU || Next.Y / ClusterSize != TileV) continue;
+                                if (OpeningLabels[Next.Y * PlaneSizeU + Next.X] != 0 || !IsOpen(Next)) continue;
+
+                                OpeningLabels[Next.Y * PlaneSizeU + Next.X] = 1;
+                                FloodStack.Add(Next);
+                            }
+                        }
+
+                        Centroid /= OpeningCells.Num();
+                        FIntPoint EntrancePoint = OpeningCells[0];
+                        float BestDistanceSquared = std::numeric_limits<float>::max();
+                        for (const FIntPoint& Point : OpeningCells)
+                        {
+                            const float DistanceSquared = FVector2D::DistSquared(Centroid, FVector2D(Point.X, Point.Y));
+                            if (DistanceSquared < BestDistanceSquared)
+                            {
+                                BestDistanceSquared = DistanceSquared;
+                                EntrancePoint = Point;
+                            }
+                        }
+
+                        const FIntVector NearCell = ToCell(EntrancePoint);
+                        const FIntVector FarCell = NearCell + FNavGrid::GetDirection(PositiveFaceDirection);
+                        const int32 NearNode = FindOrAddAbstractNode(Grid.ToIndex(NearCell), GetClusterIndex(NearCell), CellToAbstractNode);
+                        const int32 FarNode = FindOrAddAbstractNode(Grid.ToIndex(FarCell), GetClusterIndex(FarCell), CellToAbstractNode);
+                        InterEdges.Add(TPair<int32, int32>(NearNode, FarNode));
+                    }
+                }
+            }
+        }
+        bCompleteConnectivity = !HasDiagonalOnlyCrossing(Grid);
+    }
+
+    // 2. Group abstract nodes per cluster.
+    const int32 NumNodes = AbstractNodeCells.Num();
+    ClusterNodeOffsets.SetNumZeroed(TotalClusters + 1);
+    for (const int32 Cluster : AbstractNodeClusters)
+    {
+        ++ClusterNodeOffsets[Cluster + 1];
+    }
+    for (int32 Cluster = 0; Cluster < TotalClusters; ++Cluster)
+    {
+        ClusterNodeOffsets[Cluster + 1] += ClusterNodeOffsets[Cluster];
+    }
+    ClusterNodes.SetNumUninitialized(NumNodes);
+    {
+        TArray<int32> Cursor(ClusterNodeOffsets.GetData(), TotalClusters);
+        for (int32 Node = 0; Node < NumNodes; ++Node)
+        {
+            ClusterNodes[Cursor[AbstractNodeClusters[Node]]++] = Node;
+        }
+    }
+
+    // 3. Intra-cluster costs: one bounded Dijkstra per entrance. Clusters are independent, so they bake in parallel.
+    TArray<TArray<FEntranceCost>> IntraEdges;
+    IntraEdges.SetNum(NumNodes);
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavClusterHierarchy::Build_IntraClusterCosts"));
+        ParallelFor(TotalClusters, [&](int32 Cluster)
+        {
+            if (ClusterNodeOffsets[Cluster] == ClusterNodeOffsets[Cluster + 1])
+            {
+                return;
+            }
+            if (Previous && ReuseIntraClusterCosts(*Previous, Cluster, DirtyRegions, IntraEdges))
+            {
+                return;
+            }
+            FScopedNavSearchContext ScopedSearchContext(SearchContextPool, Grid.Num());
+            FNavAStarNullVisitor Visitor;
+            for (int32 Slot = ClusterNodeOffsets[Cluster]; Slot < ClusterNodeOffsets[Cluster + 1]; ++Slot)
+            {
+                const int32 Node = ClusterNodes[Slot];
+                GatherEntranceCosts(Grid, AbstractNodeCells[Node], INDEX_NONE, ScopedSearchContext.Get(), IntraEdges[Node], Visitor);
+            }
+        });
+    }
+
+    // 4. Flatten into the compressed adjacency. Each entrance's Dijkstra also reached itself; those entries are dropped.
+    TArray<int32> NumEdgesPerNode;
+    NumEdgesPerNode.SetNumZeroed(NumNodes);
+    for (int32 Node = 0; Node < NumNodes; ++Node)
+    {
+        NumEdgesPerNode[Node] = IntraEdges[Node].Num() - 1;
+    }
+    for (const TPair<int32, int32>& InterEdge : InterEdges)
+    {
+        ++NumEdgesPerNode[InterEdge.Key];
+        ++NumEdgesPerNode[InterEdge.Value];
+    }
+
+    EdgeOffsets.SetNumUninitialized(NumNodes + 1);
+    EdgeOffsets[0] = 0;
+    for (int32 Node = 0; Node < NumNodes; ++Node)
+    {
+        EdgeOffsets[Node + 1] = EdgeOffsets[Node] + NumEdgesPerNode[Node];
+    }
+    EdgeTargets.SetNumUninitialized(EdgeOffsets[NumNodes]);
+    EdgeCosts.SetNumUninitialized(EdgeOffsets[NumNodes]);
+
+    TArray<int32> Cursor(EdgeOffsets.GetData(), NumNodes);
+    auto AddEdge = [&](int32 From, int32 To, float Cost)
+    {
+        const int32 Edge = Cursor[From]++;
+        EdgeTargets[Edge] = To;
+        EdgeCosts[Edge] = Cost;
+    };
+    for (int32 Node = 0; Node < NumNodes; ++Node)
+    {
+        for (const FEntranceCost& Entry : IntraEdges[Node])
+        {
+            if (Entry.AbstractNode != Node)
+            {
+                AddEdge(Node, Entry.AbstractNode, Entry.Cost);
+            }
+        }
+    }
+    for (const TPair<int32, int32>& InterEdge : InterEdges)
+    {
+        AddEdge(InterEdge.Key, InterEdge.Value, 1.0f);
+        AddEdge(InterEdge.Value, InterEdge.Key, 1.0f);
+    }
+}
+
+void FNavClusterHierarchy::Empty()
+{
+    ClusterSize = 0;
+    bCompleteConnectivity = false;
+    GridSize = NumClusters = FIntVector::ZeroValue;
+    AbstractNodeCells.Empty();
+    AbstractNodeClusters.Empty();
+    ClusterNodeOffsets.Empty();
+    ClusterNodes.Empty();
+    EdgeOffsets.Empty();
+    EdgeTargets.Empty();
+    EdgeCosts.Empty();
+}
+
+bool FNavClusterHierarchy::ReuseIntraClusterCosts(const FNavClusterHierarchy& Previous, int32 Cluster, TConstArrayView<FNavGridRegion> DirtyRegions,
+    TArray<TArray<FEntranceCost>>& OutIntraEdges) const
+{
+    // Intra-cluster searches never leave the cluster, so only its own cells can change its costs.
+    FIntVector ClusterMin, ClusterMax;
+    GetClusterBounds(Cluster, ClusterMin, ClusterMax);
+    for (const FNavGridRegion& Region : DirtyRegions)
+    {
+        if (Region.Intersects(ClusterMin, ClusterMax - FIntVector(1)))
+        {
+            return false;
+        }
+    }
+
+    const int32 FirstSlot = ClusterNodeOffsets[Cluster];
+    const int32 NumClusterNodes = ClusterNodeOffsets[Cluster + 1] - FirstSlot;
+    const int32 PreviousFirstSlot = Previous.ClusterNodeOffsets[Cluster];
+    if (Previous.ClusterNodeOffsets[Cluster + 1] - PreviousFirstSlot != NumClusterNodes)
+    {
+        return false;
+    }
+
+    // Entrances are matched by cell; any entrance that moved invalidates the whole cluster.
+    TArray<int32, TInlineAllocator<32>> PreviousNodes;
+    PreviousNodes.SetNumUninitialized(NumClusterNodes);
+    for (int32 Slot = 0; Slot < NumClusterNodes; ++Slot)
+    {
+        const int32 Cell = AbstractNodeCells[ClusterNodes[FirstSlot + Slot]];
+        PreviousNodes[Slot] = INDEX_NONE;
+        for (int32 PreviousSlot = 0; PreviousSlot < NumClusterNodes; ++PreviousSlot)
+        {
+            const int32 PreviousNode = Previous.ClusterNodes[PreviousFirstSlot + PreviousSlot];
+            if (Previous.AbstractNodeCells[PreviousNode] == Cell)
+            {
+                PreviousNodes[Slot] = PreviousNode;
+                break;
+            }
+        }
+        if (PreviousNodes[Slot] == INDEX_NONE)
+        {
+            return false;
+        }
+    }
+
+    for (int32 Slot = 0; Slot < NumClusterNodes; ++Slot)
+    {
+        const int32 Node = ClusterNodes[FirstSlot + Slot];
+        const int32 PreviousNode = PreviousNodes[Slot];
+        TArray<FEntranceCost>& Costs = OutIntraEdges[Node];
+        Costs.Add({Node, 0.0f}); // Stands in for the self entry a fresh Dijkstra would produce.
+        for (int32 Edge = Previous.EdgeOffsets[PreviousNode]; Edge < Previous.EdgeOffsets[PreviousNode + 1]; ++Edge)
+        {
+            const int32 Target = Previous.EdgeTargets[Edge];
+            if (Previous.AbstractNodeClusters[Target] != Cluster)
+            {
+                continue; // Inter-cluster edge; those are rebuilt from the entrances.
+            }
+            const int32 TargetSlot = PreviousNodes.IndexOfByKey(Target);
+            Costs.Add({ClusterNodes[FirstSlot + TargetSlot], Previous.EdgeCosts[Edge]});
+        }
+    }
+    return true;
+}
+
+void FNavClusterHierarchy::GetClusterBounds(int32 ClusterIndex, FIntVector& OutMin, FIntVector& OutMax) const
+{
+    const FIntVector Cluster(
+        ClusterIndex % NumClusters.X,
+        (ClusterIndex / NumClusters.X) % NumClusters.Y,
+        ClusterIndex / (NumClusters.X * NumClusters.Y));
+    OutMin = Cluster * ClusterSize;
+    OutMax = FIntVector(
+        FMath::Min(OutMin.X + ClusterSize, GridSize.X),
+        FMath::Min(OutMin.Y + ClusterSize, GridSize.Y),
+        FMath::Min(OutMin.Z + ClusterSize, GridSize.Z));
+}
+
+int32 FNavClusterHierarchy::FindOrAddAbstractNode(int32 CellIndex, int32 ClusterIndex, TMap<int32, int32>& CellToAbstractNode)
+{
+    if (const int32* Existing = CellToAbstractNode.Find(CellIndex))
+    {
+        return *Existing;
+    }
+    const int32 Node = AbstractNodeCells.Add(CellIndex);
+    AbstractNodeClusters.Add(ClusterIndex);
+    CellToAbstractNode.Add(CellIndex, Node);
+    return Node;
+}
+
+bool FNavClusterHierarchy::HasDiagonalOnlyCrossing(const FNavGrid& Grid) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavClusterHierarchy::HasDiagonalOnlyCrossing"));
+
+    // Directions 0 to 5 are the faces in FNavGrid's direction table.
+    const uint32 DiagonalMask = Grid.GetAllowedDirectionsMask() & ~0x3Fu;
+    if (DiagonalMask == 0)
+    {
+        return false;
+    }
+
+    // A step across a cluster face on some axis starts, either itself or reversed, on the last cell of a cluster
+    // along that axis and moves up it. Masks and detours are symmetric, so those steps cover every crossing.
+    for (int32 Axis = 0; Axis < 3; ++Axis)
+    {
+        const int32 AxisU = (Axis + 1) % 3;
+        const int32 AxisV = (Axis + 2) % 3;
+        for (int32 Boundary = ClusterSize; Boundary < GridSize[Axis]; Boundary += ClusterSize)
+        {
+            for (int32 V = 0; V < GridSize[AxisV]; ++V)
+            {
+                for (int32 U = 0; U < GridSize[AxisU]; ++U)
+                {
+                    FIntVector Cell;
+                    Cell[Axis] = Boundary - 1;
+                    Cell[AxisU] = U;
+                    Cell[AxisV] = V;
+                    uint32 OpenDiagonals = Grid.GetOpenNeighborMask(Grid.ToIndex(Cell)) & DiagonalMask;
+                    while (OpenDiagonals != 0)
+                    {
+                        const int32 Direction = FMath::CountTrailingZeros(OpenDiagonals);
+                        OpenDiagonals &= OpenDiagonals - 1;
+                        const FIntVector& Step = FNavGrid::GetDirection(Direction);
+                        if (Step[Axis] == 1 && !HasFaceDetour(Grid, Cell, Step))
+                        {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+template<typename VisitorType>
+void FNavClusterHierarchy::GatherEntranceCosts(const FNavGrid& Grid, int32 CellIndex, int32 ExtraSettleIndex, FNavSearchContext& Search,
+    TArray<FEntranceCost>& OutCosts, VisitorType& Visitor) const
+{
+    const int32 Cluster = GetClusterIndex(Grid.ToCoordinates(CellIndex));
+    FIntVector ClusterMin, ClusterMax;
+    GetClusterBounds(Cluster, ClusterMin, ClusterMax);
+
+    TArray<int32, TInlineAllocator<64>> SettleIndices;
+    for (int32 Slot = ClusterNodeOffsets[Cluster]; Slot < ClusterNodeOffsets[Cluster + 1]; ++Slot)
+    {
+        SettleIndices.Add(AbstractNodeCells[ClusterNodes[Slot]]);
+    }
+    if (ExtraSettleIndex != INDEX_NONE)
+    {
+        SettleIndices.AddUnique(ExtraSettleIndex);
+    }
+    SettleIndices.Sort();
+
+    Search.BeginSearch(Grid.Num());
+    const FNavGridBoxGraph ClusterGraph(Grid, ClusterMin, ClusterMax, FIntVector::ZeroValue, false);
+    FNavAStarParams Params;
+    Params.StartIndex = CellIndex; // No goal: a Dijkstra that ends once the cells above are settled.
+    Params.SettleIndices = SettleIndices;
+    RunNavAStar(ClusterGraph, Search, Params, Visitor);
+
+    for (int32 Slot = ClusterNodeOffsets[Cluster]; Slot < ClusterNodeOffsets[Cluster + 1]; ++Slot)
+    {
+        const int32 Node = ClusterNodes[Slot];
+        const float Cost = Search.GetGScore(AbstractNodeCells[Node]);
+        if (Cost != std::numeric_limits<float>::max())
+        {
+            OutCosts.Add({Node, Cost});
+        }
+    }
+}
+
+ENavAStarStatus FNavClusterHierarchy::FindPath(const FNavGrid& Grid, int32 StartIndex, int32 GoalIndex, FNavSearchContextPool& SearchContextPool,
+    const std::atomic<bool>* bCancelled, TArray<int32>& OutPathIndices, INavAStarVisitor* Visitor) const
+{
+    static thread_local FQueryScratch Scratch;
+    if (Visitor)
+    {
+        return FindPathWithVisitor(Grid, StartIndex, GoalIndex, SearchContextPool, bCancelled, Scratch, OutPathIndices, *Visitor);
+    }
+    FNavAStarNullVisitor NullVisitor;
+    return FindPathWithVisitor(Grid, StartIndex, GoalIndex, SearchContextPool, bCancelled, Scratch, OutPathIndices, NullVisitor);
+}
+
+template<typename VisitorType>
+ENavAStarStatus FNavClusterHierarchy::FindPathWithVisitor(const FNavGrid& Grid, int32 StartIndex, int32 GoalIndex, FNavSearchContextPool& SearchContextPool,
+    const std::atomic<bool>* bCancelled, FQueryScratch& Scratch, TArray<int32>& OutPathIndices, VisitorType& Visitor) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavClusterHierarchy::FindPath"));
+    OutPathIndices.Reset();
+
+    // One grid-sized context serves the endpoint searches and every refinement.
+    FScopedNavSearchContext ScopedSearchContext(SearchContextPool, Grid.Num());
+    FNavSearchContext& Search = ScopedSearchContext.Get();
+
+    // Connect start and goal to the entrances of their own clusters.
+    Scratch.StartCosts.Reset();
+    Scratch.GoalCosts.Reset();
+    float DirectCost = std::numeric_limits<float>::max();
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavClusterHierarchy::FindPath_ConnectEndpoints"));
+        const bool bSameCluster = GetClusterIndex(Grid.ToCoordinates(StartIndex)) == GetClusterIndex(Grid.ToCoordinates(GoalIndex));
+        GatherEntranceCosts(Grid, StartIndex, bSameCluster ? GoalIndex : INDEX_NONE, Search, Scratch.StartCosts, Visitor);
+        if (bSameCluster)
+        {
+            DirectCost = Search.GetGScore(GoalIndex);
+        }
+        GatherEntranceCosts(Grid, GoalIndex, INDEX_NONE, Search, Scratch.GoalCosts, Visitor);
+    }
+
+    const FQueryGraph QueryGraph(*this, Grid, StartIndex, GoalIndex, Scratch.StartCosts, Scratch.GoalCosts);
+    if (DirectCost != std::numeric_limits<float>::max())
+    {
+        Scratch.StartCosts.Add({QueryGraph.GoalNode, DirectCost});
+    }
+
+    TArray<int32>& AbstractPath = Scratch.AbstractPath;
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavClusterHierarchy::FindPath_AbstractSearch"));
+        Scratch.AbstractSearch.BeginSearch(NumAbstractNodes() + 2);
+        FNavAStarParams Params;
+        Params.StartIndex = QueryGraph.StartNode;
+        Params.GoalIndex = QueryGraph.GoalNode;
+        Params.bCancelled = bCancelled;
+        TNavAbstractNodeVisitor<FQueryGraph, VisitorType> AbstractVisitor(QueryGraph, Visitor);
+        const ENavAStarStatus Status = RunNavAStar(QueryGraph, Scratch.AbstractSearch, Params, AbstractVisitor);
+        if (Status != ENavAStarStatus::Found)
+        {
+            return Status;
+        }
+        ReconstructNavPath(Scratch.AbstractSearch, QueryGraph.GoalNode, AbstractPath);
+    }
+
+    // Refine. Consecutive abstract nodes are either in the same cluster (search inside it) or one step apart across a face.
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavClusterHierarchy::FindPath_Refine"));
+    TArray<int32>& Segment = Scratch.Segment;
+    OutPathIndices.Add(StartIndex);
+    for (int32 PathIndex = 1; PathIndex < AbstractPath.Num(); ++PathIndex)
+    {
+        const int32 FromCell = QueryGraph.GetCellIndex(AbstractPath[PathIndex - 1]);
+        const int32 ToCell = QueryGraph.GetCellIndex(AbstractPath[PathIndex]);
+        const FIntVector ToCoordinates = Grid.ToCoordinates(ToCell);
+        const int32 Cluster = GetClusterIndex(Grid.ToCoordinates(FromCell));
+        if (Cluster != GetClusterIndex(ToCoordinates))
+        {
+            OutPathIndices.Add(ToCell);
+            continue;
+        }
+
+        FIntVector ClusterMin, ClusterMax;
+        GetClusterBounds(Cluster, ClusterMin, ClusterMax);
+        Search.BeginSearch(Grid.Num());
+        const FNavGridBoxGraph ClusterGraph(Grid, ClusterMin, ClusterMax, ToCoordinates, true);
+        FNavAStarParams Params;
+        Params.StartIndex = FromCell;
+        Params.GoalIndex = ToCell;
+        Params.bCancelled = bCancelled;
+        const ENavAStarStatus Status = RunNavAStar(ClusterGraph, Search, Params, Visitor);
+        if (Status != ENavAStarStatus::Found)
+        {
+            OutPathIndices.Reset();
+            return Status;
+        }
+
+        ReconstructNavPath(Search, ToCell, Segment);
+        OutPathIndices.Append(Segment.GetData() + 1, Segment.Num() - 1);
+    }
+    return ENavAStarStatus::Found;
+}
+
+SIZE_T FNavClusterHierarchy::GetAllocatedSize() const
+{
+    return AbstractNodeCells.GetAllocatedSize() + AbstractNodeClusters.GetAllocatedSize()
+        + ClusterNodeOffsets.GetAllocatedSize() + ClusterNodes.GetAllocatedSize()
+        + EdgeOffsets.GetAllocatedSize() + EdgeTargets.GetAllocatedSize() + EdgeCosts.GetAllocatedSize();
+}
+
+void FNavClusterHierarchy::Serialize(FArchive& Ar)
+{
+    Ar << ClusterSize << bCompleteConnectivity << GridSize << NumClusters;
+    AbstractNodeCells.BulkSerialize(Ar);
+    AbstractNodeClusters.BulkSerialize(Ar);
+    ClusterNodeOffsets.BulkSerialize(Ar);
+    ClusterNodes.BulkSerialize(Ar);
+    EdgeOffsets.BulkSerialize(Ar);
+    EdgeTargets.BulkSerialize(Ar);
+    EdgeCosts.BulkSerialize(Ar);
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavGrid.h"
+#include "NavAStar.h"
+
+class FNavSearchContextPool;
+
+// FNavGrid restricted to the cells inside [Min, Max) on each axis. With bUseHeuristic false the search is a
+// plain Dijkstra, which RunNavAStar runs to exhaustion when no goal is given.
+struct FNavGridBoxGraph
+{
+    const FNavGrid& Grid;
+    const FIntVector Min;
+    const FIntVector Max;
+    const FVector GoalCoordinates;
+    const bool bUseHeuristic;
+
+    FNavGridBoxGraph(const FNavGrid& InGrid, const FIntVector& InMin, const FIntVector& InMax, const FIntVector& InGoalCoordinates, bool bInUseHeuristic)
+        : Grid(InGrid)
+        , Min(InMin)
+        , Max(InMax)
+        , GoalCoordinates(InGoalCoordinates)
+        , bUseHeuristic(bInUseHeuristic)
+    {
+    }
+
+    FORCEINLINE float Heuristic(int32 NodeIndex) const
+    {
+        return bUseHeuristic ? FVector::Distance(GoalCoordinates, FVector(Grid.ToCoordinates(NodeIndex))) : 0.0f;
+    }
+
+    template<typename FuncType>
+    FORCEINLINE void ForEachNeighbor(int32 NodeIndex, FuncType&& Func) const
+    {
+        const FIntVector Coordinates = Grid.ToCoordinates(NodeIndex);
+        uint32 OpenNeighbors = Grid.GetOpenNeighborMask(NodeIndex);
+        while (OpenNeighbors != 0)
+        {
+            const int32 Direction = FMath::CountTrailingZeros(OpenNeighbors);
+            OpenNeighbors &= OpenNeighbors - 1;
+
+            const FIntVector NeighborCoordinates = Coordinates + FNavGrid::GetDirection(Direction);
+            if (NeighborCoordinates.X < Min.X || NeighborCoordinates.X >= Max.X ||
+                NeighborCoordinates.Y < Min.Y || NeighborCoordinates.Y >= Max.Y ||
+                NeighborCoordinates.Z < Min.Z || NeighborCoordinates.Z >= Max.Z)
+            {
+                continue;
+            }
+            Func(NodeIndex + Grid.GetIndexOffset(Direction), FNavGrid::GetDirectionCost(Direction));
+        }
+    }
+};
+
+// HPA*-style abstraction of an FNavGrid. The grid is cut into cubic clusters; every connected opening
+// between two face-adjacent clusters gets one entrance cell on each side. Entrances are linked by inter-cluster
+// edges (one step across the face) and by precomputed intra-cluster shortest-path costs.
+// A query connects its start and goal to the entrances of their clusters, searches the small abstract graph,
+// then refines each abstract edge with an A* that never leaves the cluster it runs in.
+// Built after the grid's neighbour masks and read-only while queries run, so they can run concurrently.
+class NAVIGATION3D_API FNavClusterHierarchy
+{
+public:
+    void Build(const FNavGrid& Grid, int32 InClusterSize, FNavSearchContextPool& SearchContextPool);
+
+    // Rebuilds after the traversability of the cells in DirtyRegions changed. Entrances are recomputed everywhere
+    // (a plane scan), but intra-cluster costs are re-baked only for clusters that contain a dirty cell or whose
+    // entrances moved; every other cluster keeps its previous costs.
+    void UpdateRegions(const FNavGrid& Grid, TConstArrayView<FNavGridRegion> DirtyRegions, FNavSearchContextPool& SearchContextPool);
+
+    void Empty();
+
+    FORCEINLINE bool IsEmpty() const { return ClusterSize == 0; }
+    FORCEINLINE int32 NumAbstractNodes() const { return AbstractNodeCells.Num(); }
+
+    // True if every step between two clusters can also be taken as face steps through free cells. Entrances only
+    // cover face openings, so only then does the abstract graph connect everything the grid connects. Always true
+    // with face neighbours only; with diagonals, one diagonal-only gap across any cluster face makes it false.
+    FORCEINLINE bool HasCompleteConnectivity() const { return bCompleteConnectivity; }
+
+    // Finds a path between two traversable cells. Returns NoPath if the abstract graph does not connect them. That
+    // is exact when HasCompleteConnectivity(); otherwise callers should fall back to a flat search. Visitor, if set,
+    // sees the endpoint, abstract and refinement searches, with abstract nodes reported as their entrance cells.
+    ENavAStarStatus FindPath(const FNavGrid& Grid, int32 StartIndex, int32 GoalIndex, FNavSearchContextPool& SearchContextPool,
+        const std::atomic<bool>* bCancelled, TArray<int32>& OutPathIndices, INavAStarVisitor* Visitor = nullptr) const;
+
+    SIZE_T GetAllocatedSize() const;
+
+    // Everything Build produces, as stored in baked navigation data.
+    void Serialize(FArchive& Ar);
+
+private:
+    struct FEntranceCost
+    {
+        int32 AbstractNode;
+        float Cost;
+    };
+
+    struct FQueryGraph;
+    struct FQueryScratch;
+
+    FORCEINLINE FIntVector GetClusterCoordinates(const FIntVector& CellCoordinates) const
+    {
+        return FIntVector(CellCoordinates.X / ClusterSize, CellCoordinates.Y / ClusterSize, CellCoordinates.Z / ClusterSize);
+    }
+
+    FORCEINLINE int32 GetClusterIndex(const FIntVector& CellCoordinates) const
+    {
+        const FIntVector Cluster = GetClusterCoordinates(CellCoordinates);
+        return (Cluster.Z * NumClusters.Y + Cluster.Y) * NumClusters.X + Cluster.X;
+    }
+
+    void BuildInternal(const FNavGrid& Grid, int32 InClusterSize, FNavSearchContextPool& SearchContextPool,
+        const FNavClusterHierarchy* Previous, TConstArrayView<FNavGridRegion> DirtyRegions);
+
+    // Copies a cluster's intra-cluster costs from Previous if none of its cells is dirty and it has the same entrances.
+    bool ReuseIntraClusterCosts(const FNavClusterHierarchy& Previous, int32 Cluster, TConstArrayView<FNavGridRegion> DirtyRegions,
+        TArray<TArray<FEntranceCost>>& OutIntraEdges) const;
+
+    void GetClusterBounds(int32 ClusterIndex, FIntVector& OutMin, FIntVector& OutMax) const;
+    int32 FindOrAddAbstractNode(int32 CellIndex, int32 ClusterIndex, TMap<int32, int32>& CellToAbstractNode);
+
+    // Dijkstra from CellIndex inside its cluster; appends the cost to every reachable entrance of that cluster. Stops
+    // once those entrances and ExtraSettleIndex (if set) are settled, so the rest of the cluster is skipped.
+    template<typename VisitorType>
+    void GatherEntranceCosts(const FNavGrid& Grid, int32 CellIndex, int32 ExtraSettleIndex, FNavSearchContext& Search,
+        TArray<FEntranceCost>& OutCosts, VisitorType& Visitor) const;
+
+    template<typename VisitorType>
+    ENavAStarStatus FindPathWithVisitor(const FNavGrid& Grid, int32 StartIndex, int32 GoalIndex, FNavSearchContextPool& SearchContextPool,
+        const std::atomic<bool>* bCancelled, FQueryScratch& Scratch, TArray<int32>& OutPathIndices, VisitorType& Visitor) const;
+
+    // Whether some diagonal step across a cluster face has no face-step detour; see HasCompleteConnectivity.
+    bool HasDiagonalOnlyCrossing(const FNavGrid& Grid) const;
+
+    int32 ClusterSize = 0;
+    bool bCompleteConnectivity = false;
+    FIntVector GridSize = FIntVector::ZeroValue;
+    FIntVector NumClusters = FIntVector::ZeroValue;
+
+    // Abstract nodes, grouped per cluster: nodes of cluster C are ClusterNodes[ClusterNodeOffsets[C] .. ClusterNodeOffsets[C + 1]).
+    TArray<int32> AbstractNodeCells;
+    TArray<int32> AbstractNodeClusters;
+    TArray<int32> ClusterNodeOffsets;
+    TArray<int32> ClusterNodes;
+
+    // Compressed abstract adjacency, same layout as FNavOctree's.
+    TArray<int32> EdgeOffsets;
+    TArray<int32> EdgeTargets;
+    TArray<float> EdgeCosts;
+};
@@ -0,0 +1,175 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NavJumpPoint.h"
+
+void FNavJumpPointRules::Build(uint32 AllowedDirectionsMask)
+{
+    constexpr uint32 AllDirectionsMask = (1u << FNavGrid::NumDirections) - 1;
+    constexpr float CostTolerance = 1.e-4f;
+
+    bSupported = AllowedDirectionsMask == AllDirectionsMask;
+    BlockerOffsets.Reset();
+    for (int32 Direction = 0; Direction < FNavGrid::NumDirections; ++Direction)
+    {
+        NaturalMasks[Direction] = 0;
+        ForcedRules[Direction].Reset();
+    }
+    if (!bSupported)
+    {
+        return;
+    }
+
+    // Offsets below are relative to the parent P; D = X - P and E = N - X.
+    for (int32 ParentDirection = 0; ParentDirection < FNavGrid::NumDirections; ++ParentDirection)
+    {
+        const FIntVector& D = FNavGrid::GetDirection(ParentDirection);
+        const float FirstStepCost = FNavGrid::GetDirectionCost(ParentDirection);
+
+        for (int32 NextDirection = 0; NextDirection < FNavGrid::NumDirections; ++NextDirection)
+        {
+            const FIntVector& E = FNavGrid::GetDirection(NextDirection);
+            const FIntVector ParentToNeighbor = D + E;
+            if (ParentToNeighbor == FIntVector::ZeroValue || FNavGrid::FindDirection(ParentToNeighbor) != INDEX_NONE)
+            {
+                continue; // Back to the parent, or the parent reaches N in one step: always pruned.
+            }
+
+            const float ViaCost = FirstStepCost + FNavGrid::GetDirectionCost(NextDirection);
+            const int32 FirstBlocker = BlockerOffsets.Num();
+            for (int32 AlternativeDirection = 0; AlternativeDirection < FNavGrid::NumDirections; ++AlternativeDirection)
+            {
+                if (AlternativeDirection == ParentDirection) continue;
+
+                const FIntVector& A = FNavGrid::GetDirection(AlternativeDirection);
+                const int32 SecondDirection = FNavGrid::FindDirection(ParentToNeighbor - A);
+                if (SecondDirection == INDEX_NONE) continue;
+
+                const float AlternativeFirstCost = FNavGrid::GetDirectionCost(AlternativeDirection);
+                const float AlternativeCost = AlternativeFirstCost + FNavGrid::GetDirectionCost(SecondDirection);
+                const bool bShorter = AlternativeCost < ViaCost - CostTolerance;
+                const bool bCanonicalTie = FMath::Abs(AlternativeCost - ViaCost) <= CostTolerance && AlternativeFirstCost > FirstStepCost + CostTolerance;
+                if (bShorter || bCanonicalTie)
+                {
+                    BlockerOffsets.Add(A - D);
+                }
+            }
+
+            if (BlockerOffsets.Num() == FirstBlocker)
+            {
+                NaturalMasks[ParentDirection] |= 1u << NextDirection;
+            }
+            else
+            {
+                FForcedRule& Rule = ForcedRules[ParentDirection].AddDefaulted_GetRef();
+                Rule.Direction = NextDirection;
+                Rule.FirstBlocker = FirstBlocker;
+                Rule.NumBlockers = BlockerOffsets.Num() - FirstBlocker;
+            }
+        }
+    }
+}
+
+bool FNavJumpPointRules::IsRuleActive(const FNavGrid& Grid, uint32 OpenNeighbors, const FIntVector& Coordinates, const FForcedRule& Rule) const
+{
+    if (!(OpenNeighbors & (1u << Rule.Direction)))
+    {
+        return false;
+    }
+    for (int32 Blocker = Rule.FirstBlocker; Blocker < Rule.FirstBlocker + Rule.NumBlockers; ++Blocker)
+    {
+        if (!IsBlockedOrOutside(Grid, Coordinates + BlockerOffsets[Blocker]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32 FNavJumpPointRules::GetSuccessorMask(const FNavGrid& Grid, int32 CellIndex, const FIntVector& Coordinates, int32 ParentDirection) const
+{
+    const uint32 OpenNeighbors = Grid.GetOpenNeighborMask(CellIndex);
+    uint32 Successors = NaturalMasks[ParentDirection] & OpenNeighbors;
+    for (const FForcedRule& Rule : ForcedRules[ParentDirection])
+    {
+        if (IsRuleActive(Grid, OpenNeighbors, Coordinates, Rule))
+        {
+            Successors |= 1u << Rule.Direction;
+        }
+    }
+    return Successors;
+}
+
+bool FNavJumpPointRules::HasForcedNeighbor(const FNavGrid& Grid, int32 CellIndex, const FIntVector& Coordinates, int32 ParentDirection) const
+{
+    const uint32 OpenNeighbors = Grid.GetOpenNeighborMask(CellIndex);
+    for (const FForcedRule& Rule : ForcedRules[ParentDirection])
+    {
+        if (IsRuleActive(Grid, OpenNeighbors, Coordinates, Rule))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int32 FNavJumpPointGraph::Jump(int32 FromIndex, FIntVector Coordinates, int32 Direction, int32& OutNumSteps) const
+{
+    const FIntVector& Step = FNavGrid::GetDirection(Direction);
+    const int32 IndexStep = Grid.GetIndexOffset(Direction);
+    const uint32 ComponentDirections = Rules.GetNaturalMask(Direction) & ~(1u << Direction);
+
+    OutNumSteps = 0;
+    int32 CurrentIndex = FromIndex;
+    while (Grid.GetOpenNeighborMask(CurrentIndex) & (1u << Direction))
+    {
+        CurrentIndex += IndexStep;
+        Coordinates += Step;
+        ++OutNumSteps;
+
+        if (CurrentIndex == GoalIndex || Rules.HasForcedNeighbor(Grid, CurrentIndex, Coordinates, Direction))
+        {
+            return CurrentIndex;
+        }
+
+        uint32 Components = ComponentDirections;
+        while (Components != 0)
+        {
+            const int32 ComponentDirection = FMath::CountTrailingZeros(Components);
+            Components &= Components - 1;
+
+            int32 ComponentSteps = 0;
+            if (Jump(CurrentIndex, Coordinates, ComponentDirection, ComponentSteps) != INDEX_NONE)
+            {
+                return CurrentIndex;
+            }
+        }
+    }
+    return INDEX_NONE;
+}
+
+void ExpandJumpPointPath(const FNavGrid& Grid, TArray<int32>& InOutPathIndices)
+{
+    if (InOutPathIndices.Num() < 2)
+    {
+        return;
+    }
+
+    TArray<int32> JumpPoints = MoveTemp(InOutPathIndices);
+    InOutPathIndices.Reset();
+    InOutPathIndices.Add(JumpPoints[0]);
+    for (int32 PathIndex = 1; PathIndex < JumpPoints.Num(); ++PathIndex)
+    {
+        const FIntVector From = Grid.ToCoordinates(JumpPoints[PathIndex - 1]);
+        const FIntVector Delta = Grid.ToCoordinates(JumpPoints[PathIndex]) - From;
+        const int32 Direction = FNavGrid::FindDirection(FIntVector(FMath::Sign(Delta.X), FMath::Sign(Delta.Y), FMath::Sign(Delta.Z)));
+        const int32 NumSteps = FMath::Max3(FMath::Abs(Delta.X), FMath::Abs(Delta.Y), FMath::Abs(Delta.Z));
+
+        int32 CellIndex = JumpPoints[PathIndex - 1];
+        for (int32 StepIndex = 0; StepIndex < NumSteps; ++StepIndex)
+        {
+            CellIndex += Grid.GetIndexOffset(Direction);
+            InOutPathIndices.Add(CellIndex);
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavGrid.h"
+#include "NavSearchContext.h"
+
+// Pruning tables for 3D jump point search on an FNavGrid.
+//
+// For a cell X entered from parent P in direction D, a neighbour N = X + E is only worth generating from X if
+// no equally good or better two-step route P -> M -> N avoids X. "Better" means strictly shorter, or equally long
+// with a longer first step (diagonals first, the usual JPS canonical order). Neighbours that no alternative
+// can beat are natural successors of D; the rest are forced once every better intermediate cell M is blocked.
+// The tables are derived from those rules at build time rather than written out by hand.
+//
+// Only full 26-neighbour connectivity is supported: with fewer directions some optimal paths are never canonical
+// under this ordering, so IsSupported() is false and callers should run plain A* instead.
+class NAVIGATION3D_API FNavJumpPointRules
+{
+public:
+    void Build(uint32 AllowedDirectionsMask);
+
+    FORCEINLINE bool IsSupported() const { return bSupported; }
+
+    // Directions to keep following from a cell entered in ParentDirection, ignoring obstacles.
+    FORCEINLINE uint32 GetNaturalMask(int32 ParentDirection) const { return NaturalMasks[ParentDirection]; }
+
+    // Natural successors plus every forced successor at the cell, restricted to open neighbours.
+    uint32 GetSuccessorMask(const FNavGrid& Grid, int32 CellIndex, const FIntVector& Coordinates, int32 ParentDirection) const;
+
+    bool HasForcedNeighbor(const FNavGrid& Grid, int32 CellIndex, const FIntVector& Coordinates, int32 ParentDirection) const;
+
+private:
+    struct FForcedRule
+    {
+        int32 Direction = INDEX_NONE;
+        int32 FirstBlocker = 0; // Cells (relative to X) that must all be blocked: BlockerOffsets[FirstBlocker .. + NumBlockers).
+        int32 NumBlockers = 0;
+    };
+
+    bool IsBlockedOrOutside(const FNavGrid& Grid, const FIntVector& Coordinates) const
+    {
+        return !Grid.IsInBounds(Coordinates) || !Grid.IsTraversable(Grid.ToIndex(Coordinates));
+    }
+
+    bool IsRuleActive(const FNavGrid& Grid, uint32 OpenNeighbors, const FIntVector& Coordinates, const FForcedRule& Rule) const;
+
+    bool bSupported = false;
+    uint32 NaturalMasks[FNavGrid::NumDirections] = {};
+    TArray<FForcedRule> ForcedRules[FNavGrid::NumDirections];
+    TArray<FIntVector> BlockerOffsets;
+};
+
+// FNavGrid as a jump point graph (see NavAStar.h). Successors are the next jump points along each pruned
+// direction, so one edge can span many cells; its cost is the straight-line cost in cell units.
+// Reads the parent of the cell being expanded from the running search's context.
+struct NAVIGATION3D_API FNavJumpPointGraph
+{
+    const FNavGrid& Grid;
+    const FNavJumpPointRules& Rules;
+    const FNavSearchContext& Search;
+    const int32 GoalIndex;
+    const FVector GoalCoordinates;
+
+    FNavJumpPointGraph(const FNavGrid& InGrid, const FNavJumpPointRules& InRules, const FNavSearchContext& InSearch, int32 InGoalIndex)
+        : Grid(InGrid)
+        , Rules(InRules)
+        , Search(InSearch)
+        , GoalIndex(InGoalIndex)
+        , GoalCoordinates(InGrid.ToCoordinates(InGoalIndex))
+    {
+    }
+
+    FORCEINLINE float Heuristic(int32 NodeIndex) const
+    {
+        return FVector::Distance(GoalCoordinates, FVector(Grid.ToCoordinates(NodeIndex)));
+    }
+
+    template<typename FuncType>
+    void ForEachNeighbor(int32 NodeIndex, FuncType&& Func) const
+    {
+        const FIntVector Coordinates = Grid.ToCoordinates(NodeIndex);
+
+        uint32 Successors = Grid.GetOpenNeighborMask(NodeIndex);
+        const int32 ParentIndex = Search.GetCameFrom(NodeIndex);
+        if (ParentIndex != INDEX_NONE)
+        {
+            const FIntVector Delta = Coordinates - Grid.ToCoordinates(ParentIndex);
+            const int32 ParentDirection = FNavGrid::FindDirection(FIntVector(FMath::Sign(Delta.X), FMath::Sign(Delta.Y), FMath::Sign(Delta.Z)));
+            Successors = Rules.GetSuccessorMask(Grid, NodeIndex, Coordinates, ParentDirection);
+        }
+
+        while (Successors != 0)
+        {
+            const int32 Direction = FMath::CountTrailingZeros(Successors);
+            Successors &= Successors - 1;
+
+            int32 NumSteps = 0;
+            const int32 JumpPoint = Jump(NodeIndex, Coordinates, Direction, NumSteps);
+            if (JumpPoint != INDEX_NONE)
+            {
+                Func(JumpPoint, NumSteps * FNavGrid::GetDirectionCost(Direction));
+            }
+        }
+    }
+
+    // Walks from a cell in one direction until it reaches the goal, a cell with a forced neighbour or (for
+    // diagonals) a cell from which one of the natural component directions reaches a jump point.
+    int32 Jump(int32 FromIndex, FIntVector Coordinates, int32 Direction, int32& OutNumSteps) const;
+};
+
+// Fills in the cells between consecutive jump points, which always lie on a straight or diagonal line.
+NAVIGATION3D_API void ExpandJumpPointPath(const FNavGrid& Grid, TArray<int32>& InOutPathIndices);
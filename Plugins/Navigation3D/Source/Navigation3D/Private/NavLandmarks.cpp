@@ -0,0 +1,130 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NavLandmarks.h"
+#include "NavGrid.h"
+#include "NavHierarchy.h"
+#include "NavSearchContext.h"
+
+void FNavLandmarks::Build(const FNavGrid& Grid, int32 InNumLandmarks, FNavSearchContextPool& SearchContextPool)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavLandmarks::Build"));
+
+    Empty();
+    const int32 MaxToPlace = FMath::Clamp(InNumLandmarks, 0, FNavLandmarkHeuristic::MaxLandmarks);
+    if (MaxToPlace == 0 || Grid.IsEmpty())
+    {
+        return;
+    }
+
+    // Selection starts from the free cell nearest the middle of the grid; its own distances are discarded.
+    const int32 SeedIndex = Grid.FindNearestTraversable(Grid.ToIndex(Grid.GetSize() / 2));
+    if (SeedIndex == INDEX_NONE)
+    {
+        return;
+    }
+
+    FScopedNavSearchContext ScopedSearchContext(SearchContextPool, Grid.Num());
+    FNavSearchContext& Search = ScopedSearchContext.Get();
+    const FNavGridBoxGraph WholeGrid(Grid, FIntVector::ZeroValue, Grid.GetSize(), FIntVector::ZeroValue, false);
+    auto Flood = [&](int32 SourceIndex)
+    {
+        Search.BeginSearch(Grid.Num());
+        FNavAStarParams Params;
+        Params.StartIndex = SourceIndex; // No goal: floods everything reachable.
+        FNavAStarNullVisitor Visitor;
+        RunNavAStar(WholeGrid, Search, Params, Visitor);
+    };
+
+    // Distance from every cell to its nearest landmark so far; the next landmark is the reachable cell farthest from all of them.
+    TArray<float> NearestLandmarkDistances;
+    NearestLandmarkDistances.SetNumUninitialized(Grid.Num());
+    Flood(SeedIndex);
+    for (int32 CellIndex = 0; CellIndex < Grid.Num(); ++CellIndex)
+    {
+        NearestLandmarkDistances[CellIndex] = Search.GetGScore(CellIndex);
+    }
+
+    TArray<TArray<float>> LandmarkDistances;
+    while (LandmarkDistances.Num() < MaxToPlace)
+    {
+        int32 FarthestIndex = INDEX_NONE;
+        float FarthestDistance = 0.0f;
+        for (int32 CellIndex = 0; CellIndex < Grid.Num(); ++CellIndex)
+        {
+            const float Distance = NearestLandmarkDistances[CellIndex];
+            if (Distance != FNavLandmarkHeuristic::Unreachable && Distance > FarthestDistance)
+            {
+                FarthestDistance = Distance;
+                FarthestIndex = CellIndex;
+            }
+        }
+        // Every reachable cell already is a landmark.
+        if (FarthestIndex == INDEX_NONE)
+        {
+            break;
+        }
+
+        Flood(FarthestIndex);
+        TArray<float>& FloodDistances = LandmarkDistances.AddDefaulted_GetRef();
+        FloodDistances.SetNumUninitialized(Grid.Num());
+        const bool bFirstLandmark = LandmarkDistances.Num() == 1;
+        for (int32 CellIndex = 0; CellIndex < Grid.Num(); ++CellIndex)
+        {
+            FloodDistances[CellIndex] = Search.GetGScore(CellIndex);
+            NearestLandmarkDistances[CellIndex] = bFirstLandmark ? FloodDistances[CellIndex] : FMath::Min(NearestLandmarkDistances[CellIndex], FloodDistances[CellIndex]);
+        }
+        LandmarkCells.Add(FarthestIndex);
+    }
+
+    // Transposed so a heuristic evaluation touches one cache line instead of one per landmark.
+    NumLandmarks = LandmarkCells.Num();
+    NumCells = Grid.Num();
+    Distances.SetNumUninitialized(NumLandmarks * NumCells);
+    for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+    {
+        for (int32 Landmark = 0; Landmark < NumLandmarks; ++Landmark)
+        {
+            Distances[CellIndex * NumLandmarks + Landmark] = LandmarkDistances[Landmark][CellIndex];
+        }
+    }
+}
+
+void FNavLandmarks::Empty()
+{
+    NumLandmarks = 0;
+    NumCells = 0;
+    LandmarkCells.Empty();
+    Distances.Empty();
+}
+
+FNavLandmarkHeuristic FNavLandmarks::MakeHeuristic(int32 TargetIndex) const
+{
+    FNavLandmarkHeuristic Heuristic;
+    if (NumLandmarks > 0 && TargetIndex >= 0 && TargetIndex < NumCells)
+    {
+        Heuristic.Distances = Distances.GetData();
+        Heuristic.NumLandmarks = NumLandmarks;
+        FMemory::Memcpy(Heuristic.TargetDistances, &Distances[TargetIndex * NumLandmarks], NumLandmarks * sizeof(float));
+    }
+    return Heuristic;
+}
+
+SIZE_T FNavLandmarks::GetAllocatedSize() const
+{
+    return LandmarkCells.GetAllocatedSize() + Distances.GetAllocatedSize();
+}
+
+void FNavLandmarks::Serialize(FArchive& Ar)
+{
+    Ar << NumLandmarks << NumCells;
+    LandmarkCells.BulkSerialize(Ar);
+    Distances.BulkSerialize(Ar);
+
+    if (Ar.IsLoading() && (NumLandmarks < 0 || NumLandmarks > FNavLandmarkHeuristic::MaxLandmarks
+        || LandmarkCells.Num() != NumLandmarks || Distances.Num() != NumLandmarks * NumCells))
+    {
+        Ar.SetError();
+        Empty();
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <limits>
+
+struct FNavGrid;
+class FNavSearchContextPool;
+
+// A query's view of FNavLandmarks: the target cell's row of landmark distances, copied once so every heuristic
+// call reads a single row of the table. With no landmarks the bound is always 0.
+struct FNavLandmarkHeuristic
+{
+    static constexpr int32 MaxLandmarks = 16;
+    static constexpr float Unreachable = std::numeric_limits<float>::max();
+
+    const float* Distances = nullptr;
+    int32 NumLandmarks = 0;
+    float TargetDistances[MaxLandmarks];
+
+    FORCEINLINE bool IsEmpty() const { return NumLandmarks == 0; }
+
+    // Triangle inequality: for any landmark L, |d(L, Node) - d(L, Target)| <= d(Node, Target).
+    // Landmarks that cannot reach either cell say nothing and are skipped.
+    FORCEINLINE float LowerBound(int32 NodeIndex) const
+    {
+        const float* Row = Distances + static_cast<int64>(NodeIndex) * NumLandmarks;
+        float Bound = 0.0f;
+        for (int32 Landmark = 0; Landmark < NumLandmarks; ++Landmark)
+        {
+            const float NodeDistance = Row[Landmark];
+            const float TargetDistance = TargetDistances[Landmark];
+            if (NodeDistance != Unreachable && TargetDistance != Unreachable)
+            {
+                Bound = FMath::Max(Bound, FMath::Abs(NodeDistance - TargetDistance));
+            }
+        }
+        return Bound;
+    }
+};
+
+// ALT ("A*, landmarks, triangle inequality") tables for the dense grid: exact path distances from a few landmark
+// cells to every cell, giving a lower bound that is much tighter than the straight line around walls and in mazes.
+// Landmarks are picked by farthest-point selection so they sit on the edges of the navigable space, where the
+// bounds are tightest. Memory is NumLandmarks * 4 bytes per cell.
+//
+// The bounds stay admissible when cells become blocked (distances only grow) but not when cells open up, so
+// the owner drops the tables on such updates until the next full build. Read-only while queries run.
+class NAVIGATION3D_API FNavLandmarks
+{
+public:
+    // Floods the grid once per landmark plus once to find the first one.
+    void Build(const FNavGrid& Grid, int32 InNumLandmarks, FNavSearchContextPool& SearchContextPool);
+
+    void Empty();
+
+    FORCEINLINE bool IsEmpty() const { return NumLandmarks == 0; }
+    FORCEINLINE int32 Num() const { return NumLandmarks; }
+    FORCEINLINE int32 NumTableCells() const { return NumCells; }
+
+    // Lower bounds towards TargetIndex; empty if there are no tables.
+    FNavLandmarkHeuristic MakeHeuristic(int32 TargetIndex) const;
+
+    SIZE_T GetAllocatedSize() const;
+
+    // Everything Build produces, as stored in baked navigation data.
+    void Serialize(FArchive& Ar);
+
+private:
+    int32 NumLandmarks = 0;
+    int32 NumCells = 0;
+    TArray<int32> LandmarkCells;
+
+    // Cell-major: the distances of cell C are Distances[C * NumLandmarks .. (C + 1) * NumLandmarks).
+    TArray<float> Distances;
+};
+
+// Any grid graph with its heuristic raised to the landmark bound. Both bounds are admissible, so their maximum is.
+template<typename GraphType>
+struct TNavLandmarkGraph
+{
+    const GraphType& Graph;
+    const FNavLandmarkHeuristic& Landmarks;
+
+    TNavLandmarkGraph(const GraphType& InGraph, const FNavLandmarkHeuristic& InLandmarks)
+        : Graph(InGraph)
+        , Landmarks(InLandmarks)
+    {
+    }
+
+    FORCEINLINE float Heuristic(int32 NodeIndex) const
+    {
+        return FMath::Max(Graph.Heuristic(NodeIndex), Landmarks.LowerBound(NodeIndex));
+    }
+
+    template<typename FuncType>
+    FORCEINLINE void ForEachNeighbor(int32 NodeIndex, FuncType&& Func) const
+    {
+        Graph.ForEachNeighbor(NodeIndex, Forward<FuncType>(Func));
+    }
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Voxel line-of-sight over a volume's cells, independent of the navigation backend.
+// Positions are in cell space: cell (X, Y, Z) spans [X, X + 1) on each axis, so its centre is (X + 0.5, ...).
+// IsCellFree is called as bool(const FIntVector& Cell) and must return false outside the volume.
+
+// Walks every cell the segment passes through (Amanatides-Woo DDA) and stops at the first blocked one.
+// Where the segment crosses an edge or corner exactly, the cells touching it must be free as well, so a
+// line of sight never squeezes diagonally between two obstacles. Returns true if a blocked cell was found,
+// with OutHitTime the fraction of the segment (0..1) at which the line enters it.
+template<typename IsCellFreeType>
+bool FindNavLineOfSightBlock(const FVector& From, const FVector& To, IsCellFreeType&& IsCellFree, double& OutHitTime)
+{
+    FIntVector Cell(FMath::FloorToInt(From.X), FMath::FloorToInt(From.Y), FMath::FloorToInt(From.Z));
+    const FIntVector EndCell(FMath::FloorToInt(To.X), FMath::FloorToInt(To.Y), FMath::FloorToInt(To.Z));
+    OutHitTime = 0.0;
+    if (!IsCellFree(Cell))
+    {
+        return true;
+    }
+
+    const FVector Delta = To - From;
+    FIntVector Step;
+    FVector TMax;
+    FVector TDelta;
+    for (int32 Axis = 0; Axis < 3; ++Axis)
+    {
+        if (Delta[Axis] > UE_KINDA_SMALL_NUMBER)
+        {
+            Step[Axis] = 1;
+            TDelta[Axis] = 1.0 / Delta[Axis];
+            TMax[Axis] = (Cell[Axis] + 1 - From[Axis]) * TDelta[Axis];
+        }
+        else if (Delta[Axis] < -UE_KINDA_SMALL_NUMBER)
+        {
+            Step[Axis] = -1;
+            TDelta[Axis] = -1.0 / Delta[Axis];
+            TMax[Axis] = (From[Axis] - Cell[Axis]) * TDelta[Axis];
+        }
+        else
+        {
+            Step[Axis] = 0;
+            TDelta[Axis] = TNumericLimits<double>::Max();
+            TMax[Axis] = TNumericLimits<double>::Max();
+        }
+    }
+
+    constexpr double TieTolerance = 1.e-6;
+    const int32 MaxSteps = FMath::Abs(EndCell.X - Cell.X) + FMath::Abs(EndCell.Y - Cell.Y) + FMath::Abs(EndCell.Z - Cell.Z);
+    for (int32 StepIndex = 0; StepIndex < MaxSteps && Cell != EndCell; ++StepIndex)
+    {
+        const double TNext = FMath::Min3(TMax.X, TMax.Y, TMax.Z);
+        if (TNext > 1.0)
+        {
+            break;
+        }
+
+        int32 TiedAxes[3];
+        int32 NumTied = 0;
+        for (int32 Axis = 0; Axis < 3; ++Axis)
+        {
+            if (TMax[Axis] <= TNext + TieTolerance)
+            {
+                TiedAxes[NumTied++] = Axis;
+            }
+        }
+
+        // Crossing an edge (two axes) or corner (three): check every cell that shares it.
+        if (NumTied > 1)
+        {
+            for (int32 Subset = 1; Subset < (1 << NumTied) - 1; ++Subset)
+            {
+                FIntVector SideCell = Cell;
+                for (int32 Tied = 0; Tied < NumTied; ++Tied)
+                {
+                    if (Subset & (1 << Tied))
+                    {
+                        SideCell[TiedAxes[Tied]] += Step[TiedAxes[Tied]];
+                    }
+                }
+                if (!IsCellFree(SideCell))
+                {
+                    OutHitTime = TNext;
+                    return true;
+                }
+            }
+        }
+
+        for (int32 Tied = 0; Tied < NumTied; ++Tied)
+        {
+            Cell[TiedAxes[Tied]] += Step[TiedAxes[Tied]];
+            TMax[TiedAxes[Tied]] += TDelta[TiedAxes[Tied]];
+        }
+        if (!IsCellFree(Cell))
+        {
+            OutHitTime = TNext;
+            return true;
+        }
+    }
+    OutHitTime = 1.0;
+    return false;
+}
+
+template<typename IsCellFreeType>
+bool HasNavLineOfSight(const FVector& From, const FVector& To, IsCellFreeType&& IsCellFree)
+{
+    double HitTime;
+    return !FindNavLineOfSightBlock(From, To, IsCellFree, HitTime);
+}
+
+// String pulling: keeps a waypoint only where the line of sight from the previous kept waypoint breaks.
+// Points are in cell space; the first and last point are always kept.
+template<typename IsCellFreeType>
+void SmoothNavPath(TArray<FVector>& InOutPoints, IsCellFreeType&& IsCellFree)
+{
+    if (InOutPoints.Num() < 3)
+    {
+        return;
+    }
+
+    int32 NumKept = 1;
+    int32 Anchor = 0;
+    for (int32 Candidate = 2; Candidate < InOutPoints.Num(); ++Candidate)
+    {
+        if (!HasNavLineOfSight(InOutPoints[Anchor], InOutPoints[Candidate], IsCellFree))
+        {
+            Anchor = Candidate - 1;
+            InOutPoints[NumKept++] = InOutPoints[Anchor];
+        }
+    }
+    InOutPoints[NumKept++] = InOutPoints.Last();
+    InOutPoints.SetNum(NumKept, EAllowShrinking::No);
+}
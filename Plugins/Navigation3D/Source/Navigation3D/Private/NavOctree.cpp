@@ -0,0 +1,199 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NavOctree.h"
+
+void FNavOctree::Build(const FIntVector& InGridSize, FBlockedTest IsBlocked)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavOctree::Build"));
+
+    Empty();
+    GridSize = InGridSize;
+
+    const int32 MaxDimension = FMath::Max3(GridSize.X, GridSize.Y, GridSize.Z);
+    if (MaxDimension <= 0)
+    {
+        return;
+    }
+
+    FNode& Root = Nodes.AddDefaulted_GetRef();
+    Root.Min = FIntVector::ZeroValue;
+    Root.Size = static_cast<int32>(FMath::RoundUpToPowerOfTwo(static_cast<uint32>(MaxDimension)));
+    BuildNode(0, IsBlocked);
+
+    Nodes.Shrink();
+    Leaves.Shrink();
+    BuildAdjacency();
+}
+
+void FNavOctree::Empty()
+{
+    GridSize = FIntVector::ZeroValue;
+    Nodes.Empty();
+    Leaves.Empty();
+    NeighborOffsets.Empty();
+    NeighborLeaves.Empty();
+    NeighborCosts.Empty();
+}
+
+void FNavOctree::BuildNode(int32 NodeIndex, FBlockedTest IsBlocked)
+{
+    // Nodes may reallocate while children are added, so never hold a reference across the recursion.
+    const FIntVector Min = Nodes[NodeIndex].Min;
+    const int32 Size = Nodes[NodeIndex].Size;
+    const FIntVector Max = Min + FIntVector(Size);
+
+    if (Min.X >= GridSize.X || Min.Y >= GridSize.Y || Min.Z >= GridSize.Z)
+    {
+        Nodes[NodeIndex].State = ENodeState::Outside;
+        return;
+    }
+
+    const bool bFullyInside = Max.X <= GridSize.X && Max.Y <= GridSize.Y && Max.Z <= GridSize.Z;
+    if (bFullyInside)
+    {
+        if (!IsBlocked(Min, Size))
+        {
+            Nodes[NodeIndex].State = ENodeState::Free;
+            Nodes[NodeIndex].LeafIndex = Leaves.Add({Min, Size});
+            return;
+        }
+        if (Size == 1)
+        {
+            Nodes[NodeIndex].State = ENodeState::Blocked;
+            return;
+        }
+    }
+
+    const int32 FirstChild = Nodes.Num();
+    const int32 HalfSize = Size / 2;
+    Nodes[NodeIndex].State = ENodeState::Subdivided;
+    Nodes[NodeIndex].FirstChild = FirstChild;
+    Nodes.AddDefaulted(8);
+    for (int32 Child = 0; Child < 8; ++Child)
+    {
+        FNode& ChildNode = Nodes[FirstChild + Child];
+        ChildNode.Min = Min + FIntVector((Child & 1) ? HalfSize : 0, (Child & 2) ? HalfSize : 0, (Child & 4) ? HalfSize : 0);
+        ChildNode.Size = HalfSize;
+    }
+    for (int32 Child = 0; Child < 8; ++Child)
+    {
+        BuildNode(FirstChild + Child, IsBlocked);
+    }
+}
+
+void FNavOctree::BuildAdjacency()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavOctree::BuildAdjacency"));
+
+    NeighborOffsets.SetNumUninitialized(Leaves.Num() + 1);
+    TArray<int32> FaceNeighbors;
+
+    for (int32 LeafIndex = 0; LeafIndex < Leaves.Num(); ++LeafIndex)
+    {
+        NeighborOffsets[LeafIndex] = NeighborLeaves.Num();
+
+        const FLeaf& Leaf = Leaves[LeafIndex];
+        const FIntVector LeafMax = Leaf.Min + FIntVector(Leaf.Size - 1);
+        const FVector LeafCenter = GetLeafCenter(LeafIndex);
+
+        for (int32 Axis = 0; Axis < 3; ++Axis)
+        {
+            for (int32 Side = 0; Side < 2; ++Side)
+            {
+                // One-cell-thick slab just outside this face.
+                FIntVector SlabMin = Leaf.Min;
+                FIntVector SlabMax = LeafMax;
+                SlabMin[Axis] = SlabMax[Axis] = Side == 0 ? Leaf.Min[Axis] - 1 : LeafMax[Axis] + 1;
+
+                FaceNeighbors.Reset();
+                GatherLeavesInBox(SlabMin, SlabMax, FaceNeighbors);
+                for (const int32 NeighborIndex : FaceNeighbors)
+                {
+                    NeighborLeaves.Add(NeighborIndex);
+                    NeighborCosts.Add(FVector::Distance(LeafCenter, GetLeafCenter(NeighborIndex)));
+                }
+            }
+        }
+    }
+    NeighborOffsets[Leaves.Num()] = NeighborLeaves.Num();
+}
+
+int32 FNavOctree::FindLeaf(const FIntVector& Coordinates) const
+{
+    if (Nodes.IsEmpty() ||
+        Coordinates.X < 0 || Coordinates.X >= GridSize.X ||
+        Coordinates.Y < 0 || Coordinates.Y >= GridSize.Y ||
+        Coordinates.Z < 0 || Coordinates.Z >= GridSize.Z)
+    {
+        return INDEX_NONE;
+    }
+
+    int32 NodeIndex = 0;
+    while (Nodes[NodeIndex].State == ENodeState::Subdivided)
+    {
+        const FNode& Node = Nodes[NodeIndex];
+        const int32 HalfSize = Node.Size / 2;
+        const int32 Child = (Coordinates.X >= Node.Min.X + HalfSize ? 1 : 0)
+                          | (Coordinates.Y >= Node.Min.Y + HalfSize ? 2 : 0)
+                          | (Coordinates.Z >= Node.Min.Z + HalfSize ? 4 : 0);
+        NodeIndex = Node.FirstChild + Child;
+    }
+    return Nodes[NodeIndex].State == ENodeState::Free ? Nodes[NodeIndex].LeafIndex : INDEX_NONE;
+}
+
+void FNavOctree::GatherLeavesInBox(const FIntVector& Min, const FIntVector& Max, TArray<int32>& OutLeafIndices) const
+{
+    if (Nodes.IsEmpty())
+    {
+        return;
+    }
+
+    TArray<int32, TInlineAllocator<64>> Stack;
+    Stack.Add(0);
+    while (Stack.Num() > 0)
+    {
+        const FNode& Node = Nodes[Stack.Pop(EAllowShrinking::No)];
+        const FIntVector NodeMax = Node.Min + FIntVector(Node.Size - 1);
+        if (NodeMax.X < Min.X || Node.Min.X > Max.X ||
+            NodeMax.Y < Min.Y || Node.Min.Y > Max.Y ||
+            NodeMax.Z < Min.Z || Node.Min.Z > Max.Z)
+        {
+            continue;
+        }
+
+        if (Node.State == ENodeState::Free)
+        {
+            OutLeafIndices.Add(Node.LeafIndex);
+        }
+        else if (Node.State == ENodeState::Subdivided)
+        {
+            for (int32 Child = 0; Child < 8; ++Child)
+            {
+                Stack.Add(Node.FirstChild + Child);
+            }
+        }
+    }
+}
+
+FVector FNavOctree::GetPortalCenter(int32 FromLeaf, int32 ToLeaf) const
+{
+    const FLeaf& A = Leaves[FromLeaf];
+    const FLeaf& B = Leaves[ToLeaf];
+
+    FVector Portal;
+    for (int32 Axis = 0; Axis < 3; ++Axis)
+    {
+        // On the touching axis the overlap collapses to the shared plane; elsewhere take the overlap's middle.
+        const int32 Low = FMath::Max(A.Min[Axis], B.Min[Axis]);
+        const int32 High = FMath::Min(A.Min[Axis] + A.Size, B.Min[Axis] + B.Size);
+        Portal[Axis] = (Low + High) * 0.5f;
+    }
+    return Portal;
+}
+
+SIZE_T FNavOctree::GetAllocatedSize() const
+{
+    return Nodes.GetAllocatedSize() + Leaves.GetAllocatedSize() +
+           NeighborOffsets.GetAllocatedSize() + NeighborLeaves.GetAllocatedSize() + NeighborCosts.GetAllocatedSize();
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Sparse voxel octree alternative to FNavGrid for large, mostly empty volumes.
+// The octree spans the volume's cell grid (padded to a power of two). Regions without geometry collapse into
+// a single free leaf, so full cell resolution is only kept next to obstacles. Free leaves form the search graph;
+// two leaves are neighbours when they share part of a face.
+// All coordinates are in cell units of the owning volume, so leaves and dense-grid cells are directly comparable.
+class FNavOctree
+{
+public:
+    // Returns true if anything blocks the block of cells [Min, Min + Size) along each axis.
+    using FBlockedTest = TFunctionRef<bool(const FIntVector& Min, int32 Size)>;
+
+    struct FLeaf
+    {
+        FIntVector Min = FIntVector::ZeroValue;
+        int32 Size = 0;
+    };
+
+    void Build(const FIntVector& InGridSize, FBlockedTest IsBlocked);
+    void Empty();
+
+    FORCEINLINE bool IsEmpty() const { return Leaves.Num() == 0; }
+    FORCEINLINE int32 NumLeaves() const { return Leaves.Num(); }
+    FORCEINLINE const FLeaf& GetLeaf(int32 LeafIndex) const { return Leaves[LeafIndex]; }
+
+    // Centre of a leaf in cell units (cell (0,0,0) spans [0,1) on each axis).
+    FORCEINLINE FVector GetLeafCenter(int32 LeafIndex) const
+    {
+        const FLeaf& Leaf = Leaves[LeafIndex];
+        return FVector(Leaf.Min) + FVector(Leaf.Size * 0.5f);
+    }
+
+    // Free leaf containing the cell, or INDEX_NONE if the cell is blocked or outside the grid.
+    int32 FindLeaf(const FIntVector& Coordinates) const;
+
+    // Appends every free leaf that overlaps the cell box [Min, Max] (inclusive).
+    void GatherLeavesInBox(const FIntVector& Min, const FIntVector& Max, TArray<int32>& OutLeafIndices) const;
+
+    // Centre of the face region shared by two neighbouring leaves, in cell units.
+    FVector GetPortalCenter(int32 FromLeaf, int32 ToLeaf) const;
+
+    template<typename FuncType>
+    FORCEINLINE void ForEachNeighbor(int32 LeafIndex, FuncType&& Func) const
+    {
+        for (int32 Edge = NeighborOffsets[LeafIndex]; Edge < NeighborOffsets[LeafIndex + 1]; ++Edge)
+        {
+            Func(NeighborLeaves[Edge], NeighborCosts[Edge]);
+        }
+    }
+
+    SIZE_T GetAllocatedSize() const;
+
+private:
+    enum class ENodeState : uint8
+    {
+        Free,
+        Blocked,
+        Outside,
+        Subdivided
+    };
+
+    struct FNode
+    {
+        FIntVector Min = FIntVector::ZeroValue;
+        int32 Size = 0;
+        int32 FirstChild = INDEX_NONE; // Children are stored contiguously.
+        int32 LeafIndex = INDEX_NONE;  // Only set for free leaves.
+        ENodeState State = ENodeState::Outside;
+    };
+
+    void BuildNode(int32 NodeIndex, FBlockedTest IsBlocked);
+    void BuildAdjacency();
+
+    FIntVector GridSize = FIntVector::ZeroValue;
+    TArray<FNode> Nodes;
+    TArray<FLeaf> Leaves;
+
+    // Compressed adjacency: neighbours of leaf L are NeighborLeaves[NeighborOffsets[L] .. NeighborOffsets[L + 1]).
+    TArray<int32> NeighborOffsets;
+    TArray<int32> NeighborLeaves;
+    TArray<float> NeighborCosts;
+};
+
+// FNavOctree leaves as an A* graph (see NavAStar.h). Costs are distances between leaf centres in cell units.
+struct FNavOctreeGraph
+{
+    const FNavOctree& Octree;
+    const FVector GoalCenter;
+
+    FNavOctreeGraph(const FNavOctree& InOctree, int32 GoalLeaf)
+        : Octree(InOctree)
+        , GoalCenter(InOctree.GetLeafCenter(GoalLeaf))
+    {
+    }
+
+    FORCEINLINE float Heuristic(int32 LeafIndex) const
+    {
+        return FVector::Distance(GoalCenter, Octree.GetLeafCenter(LeafIndex));
+    }
+
+    template<typename FuncType>
+    FORCEINLINE void ForEachNeighbor(int32 LeafIndex, FuncType&& Func) const
+    {
+        Octree.ForEachNeighbor(LeafIndex, Forward<FuncType>(Func));
+    }
+};
@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NavPathPool.h"
+
+FNavPathFreeList::~FNavPathFreeList()
+{
+    for (FNavPath* Path : Paths)
+    {
+        delete Path;
+    }
+}
+
+uint32 FNavPath::Release() const
+{
+    const uint32 Remaining = RefCount.fetch_sub(1, std::memory_order_acq_rel) - 1;
+    if (Remaining == 0)
+    {
+        FNavPath* MutableThis = const_cast<FNavPath*>(this);
+        if (const TSharedPtr<FNavPathFreeList, ESPMode::ThreadSafe> Owner = FreeList.Pin())
+        {
+            MutableThis->Points.Reset();
+            FScopeLock Lock(&Owner->Mutex);
+            Owner->Paths.Add(MutableThis);
+        }
+        else
+        {
+            delete MutableThis;
+        }
+    }
+    return Remaining;
+}
+
+FNavPathPool::FNavPathPool()
+    : FreeList(MakeShared<FNavPathFreeList, ESPMode::ThreadSafe>())
+{
+}
+
+FNavPathRef FNavPathPool::Acquire()
+{
+    FNavPath* Path = nullptr;
+    {
+        FScopeLock Lock(&FreeList->Mutex);
+        if (FreeList->Paths.Num() > 0)
+        {
+            Path = FreeList->Paths.Pop(EAllowShrinking::No);
+        }
+    }
+
+    if (!Path)
+    {
+        Path = new FNavPath();
+        Path->FreeList = FreeList;
+    }
+    return FNavPathRef(Path);
+}
+
+void FNavPathPool::Empty()
+{
+    TArray<FNavPath*> IdlePaths;
+    {
+        FScopeLock Lock(&FreeList->Mutex);
+        IdlePaths = MoveTemp(FreeList->Paths);
+    }
+    for (FNavPath* Path : IdlePaths)
+    {
+        delete Path;
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/RefCounting.h"
+#include <atomic>
+
+class FNavPath;
+
+// Idle path buffers of one FNavPathPool. Held weakly by every path it hands out, so a path released after
+// its pool is gone simply frees itself.
+struct FNavPathFreeList
+{
+    FCriticalSection Mutex;
+    TArray<FNavPath*> Paths;
+
+    ~FNavPathFreeList();
+};
+
+// The points of a finished path, shared by reference between the query that found it, the path cache, coalesced
+// queries and native callers. Dropping the last reference returns the buffer, capacity intact, to the pool it came
+// from, so steady-state queries reuse buffers instead of allocating them.
+class FNavPath
+{
+public:
+    FORCEINLINE const TArray<FVector>& GetPoints() const { return Points; }
+
+    uint32 AddRef() const { return RefCount.fetch_add(1, std::memory_order_relaxed) + 1; }
+    uint32 Release() const;
+    uint32 GetRefCount() const { return RefCount.load(std::memory_order_relaxed); }
+
+private:
+    friend class FNavPathPool;
+    // Only the volume's workers write the points, before the path is delivered; everyone else reads them through GetPoints.
+    friend class ANavigationVolume3D;
+
+    TArray<FVector> Points;
+    mutable std::atomic<uint32> RefCount = 0;
+    TWeakPtr<FNavPathFreeList, ESPMode::ThreadSafe> FreeList;
+};
+
+using FNavPathRef = TRefCountPtr<FNavPath>;
+
+// Free list of path buffers. Acquire is safe from any thread, like FNavSearchContextPool.
+class FNavPathPool
+{
+public:
+    FNavPathPool();
+
+    // An empty path; its buffer keeps the capacity of whatever path used it last.
+    FNavPathRef Acquire();
+
+    // Frees the idle buffers. Paths still referenced return here when released.
+    void Empty();
+
+private:
+    TSharedRef<FNavPathFreeList, ESPMode::ThreadSafe> FreeList;
+};
@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NavSearchContext.h"
+#include "Misc/ScopeLock.h"
+
+void FNavSearchContext::BeginSearch(int32 NumNodes)
+{
+    if (NodeStates.Num() != NumNodes)
+    {
+        NodeStates.Reset();
+        NodeStates.SetNum(NumNodes);
+        CurrentGeneration = 0;
+    }
+    OpenHeap.Reset();
+    ClosestToGoalIndex = INDEX_NONE;
+    ClosestToGoalHeuristic = std::numeric_limits<float>::max();
+    NumExpanded = 0;
+    PeakOpen = 0;
+
+    // Even stamps mark touched nodes, the odd stamp right after marks closed ones.
+    CurrentGeneration += 2;
+    if (CurrentGeneration == 0)
+    {
+        // Generation counter wrapped; stale stamps could now alias the new generation.
+        for (FNavSearchNodeState& State : NodeStates)
+        {
+            State.Generation = 0;
+        }
+        CurrentGeneration = 2;
+    }
+}
+
+TUniquePtr<FNavSearchContext> FNavSearchContextPool::Acquire(int32 NumNodes)
+{
+    TUniquePtr<FNavSearchContext> Context;
+    {
+        FScopeLock Lock(&Mutex);
+        if (FreeContexts.Num() > 0)
+        {
+            Context = FreeContexts.Pop(EAllowShrinking::No);
+        }
+    }
+
+    if (!Context.IsValid())
+    {
+        Context = MakeUnique<FNavSearchContext>();
+    }
+    Context->BeginSearch(NumNodes);
+    return Context;
+}
+
+void FNavSearchContextPool::Release(TUniquePtr<FNavSearchContext> Context)
+{
+    if (!Context.IsValid())
+    {
+        return;
+    }
+
+    FScopeLock Lock(&Mutex);
+    FreeContexts.Add(MoveTemp(Context));
+}
+
+void FNavSearchContextPool::Empty()
+{
+    FScopeLock Lock(&Mutex);
+    FreeContexts.Empty();
+}
@@ -0,0 +1,233 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include <limits>
+
+// Scratch state for one node during one search. Only valid while Generation is one of the owning
+// FNavSearchContext's two stamps for the current search, so contexts never need clearing.
+struct FNavSearchNodeState
+{
+    float GScore = std::numeric_limits<float>::max();
+    int32 CameFrom = INDEX_NONE;
+    // Position in the open heap, or INDEX_NONE while the node is not open.
+    int32 HeapIndex = INDEX_NONE;
+    uint32 Generation = 0;
+};
+
+// Entry of the A* open heap. The score is copied in so sifting never has to read back into the node states.
+struct FNavOpenSetEntry
+{
+    float FScore;
+    int32 NodeIndex;
+
+    // Lowest FScore first; equal scores pop in node index order so searches are deterministic.
+    FORCEINLINE bool operator<(const FNavOpenSetEntry& Other) const
+    {
+        return FScore < Other.FScore || (FScore == Other.FScore && NodeIndex < Other.NodeIndex);
+    }
+};
+
+// Per-query A* search state, indexed by node index. Each query owns one of these for its
+// whole lifetime, so any number of searches can run in parallel over the shared, read-only grid.
+//
+// A search uses two generation stamps: CurrentGeneration for touched nodes and CurrentGeneration + 1 for
+// closed ones, so closing a node is a single store and needs no separate set. The open list is an indexed
+// 4-ary min-heap with decrease-key; both it and the node states keep their memory between searches.
+// Navigation3D.Benchmark.Search reports search latency and the peak scratch bytes held here.
+struct NAVIGATION3D_API FNavSearchContext
+{
+    TArray<FNavSearchNodeState> NodeStates;
+    TArray<FNavOpenSetEntry> OpenHeap;
+    uint32 CurrentGeneration = 0;
+
+    // Touched node with the lowest heuristic so far; where a partial path ends when a search runs out of budget.
+    int32 ClosestToGoalIndex = INDEX_NONE;
+    float ClosestToGoalHeuristic = std::numeric_limits<float>::max();
+
+    // Telemetry for the current search; both survive suspension across time slices.
+    int32 NumExpanded = 0;
+    int32 PeakOpen = 0;
+
+    // Starts a new search over NumNodes nodes. Invalidates all previous scores in O(1)
+    // except when the array has to grow or the generation counter wraps.
+    void BeginSearch(int32 NumNodes);
+
+    FORCEINLINE bool IsTouched(int32 NodeIndex) const
+    {
+        return (NodeStates[NodeIndex].Generation | 1u) == (CurrentGeneration | 1u);
+    }
+
+    FORCEINLINE bool IsClosed(int32 NodeIndex) const
+    {
+        return NodeStates[NodeIndex].Generation == CurrentGeneration + 1;
+    }
+
+    // The node must have been touched in this search.
+    FORCEINLINE void MarkClosed(int32 NodeIndex)
+    {
+        NodeStates[NodeIndex].Generation = CurrentGeneration + 1;
+        ++NumExpanded;
+    }
+
+    // Returns the node's state, resetting it first if it is stale from a previous search.
+    FORCEINLINE FNavSearchNodeState& Touch(int32 NodeIndex)
+    {
+        FNavSearchNodeState& State = NodeStates[NodeIndex];
+        if (!IsTouched(NodeIndex))
+        {
+            State.GScore = std::numeric_limits<float>::max();
+            State.CameFrom = INDEX_NONE;
+            State.HeapIndex = INDEX_NONE;
+            State.Generation = CurrentGeneration;
+        }
+        return State;
+    }
+
+    FORCEINLINE bool IsOpenEmpty() const { return OpenHeap.Num() == 0; }
+    FORCEINLINE int32 NumOpen() const { return OpenHeap.Num(); }
+
+    // Lowest FScore in the open heap. The heap must not be empty.
+    FORCEINLINE float PeekOpenScore() const { return OpenHeap[0].FScore; }
+
+    // Inserts a touched node into the open heap, or moves it up if it is already open with a higher score.
+    FORCEINLINE void PushOrDecreaseOpen(int32 NodeIndex, float FScore)
+    {
+        int32 Position = NodeStates[NodeIndex].HeapIndex;
+        if (Position == INDEX_NONE)
+        {
+            Position = OpenHeap.Add({FScore, NodeIndex});
+            PeakOpen = FMath::Max(PeakOpen, OpenHeap.Num());
+        }
+        else
+        {
+            OpenHeap[Position].FScore = FScore;
+        }
+        SiftUp(Position);
+    }
+
+    // Removes and returns the open node with the lowest FScore. The heap must not be empty.
+    FORCEINLINE int32 PopOpen()
+    {
+        const int32 NodeIndex = OpenHeap[0].NodeIndex;
+        NodeStates[NodeIndex].HeapIndex = INDEX_NONE;
+        const FNavOpenSetEntry Last = OpenHeap.Pop(EAllowShrinking::No);
+        if (OpenHeap.Num() > 0)
+        {
+            OpenHeap[0] = Last;
+            SiftDown(0);
+        }
+        return NodeIndex;
+    }
+
+    FORCEINLINE float GetGScore(int32 NodeIndex) const
+    {
+        return IsTouched(NodeIndex) ? NodeStates[NodeIndex].GScore : std::numeric_limits<float>::max();
+    }
+
+    FORCEINLINE int32 GetCameFrom(int32 NodeIndex) const
+    {
+        return IsTouched(NodeIndex) ? NodeStates[NodeIndex].CameFrom : INDEX_NONE;
+    }
+
+private:
+    static constexpr int32 HeapArity = 4;
+
+    FORCEINLINE void PlaceInHeap(int32 Position, const FNavOpenSetEntry& Entry)
+    {
+        OpenHeap[Position] = Entry;
+        NodeStates[Entry.NodeIndex].HeapIndex = Position;
+    }
+
+    FORCEINLINE void SiftUp(int32 Position)
+    {
+        const FNavOpenSetEntry Entry = OpenHeap[Position];
+        while (Position > 0)
+        {
+            const int32 Parent = (Position - 1) / HeapArity;
+            if (!(Entry < OpenHeap[Parent]))
+            {
+                break;
+            }
+            PlaceInHeap(Position, OpenHeap[Parent]);
+            Position = Parent;
+        }
+        PlaceInHeap(Position, Entry);
+    }
+
+    FORCEINLINE void SiftDown(int32 Position)
+    {
+        const FNavOpenSetEntry Entry = OpenHeap[Position];
+        const int32 Num = OpenHeap.Num();
+        for (;;)
+        {
+            const int32 FirstChild = Position * HeapArity + 1;
+            if (FirstChild >= Num)
+            {
+                break;
+            }
+            int32 BestChild = FirstChild;
+            const int32 EndChild = FMath::Min(FirstChild + HeapArity, Num);
+            for (int32 Child = FirstChild + 1; Child < EndChild; ++Child)
+            {
+                if (OpenHeap[Child] < OpenHeap[BestChild])
+                {
+                    BestChild = Child;
+                }
+            }
+            if (!(OpenHeap[BestChild] < Entry))
+            {
+                break;
+            }
+            PlaceInHeap(Position, OpenHeap[BestChild]);
+            Position = BestChild;
+        }
+        PlaceInHeap(Position, Entry);
+    }
+};
+
+// Thread-safe free list of search contexts. Contexts keep their allocations between
+// queries, so steady-state pathfinding does not allocate per-node scratch memory.
+class NAVIGATION3D_API FNavSearchContextPool
+{
+public:
+    TUniquePtr<FNavSearchContext> Acquire(int32 NumNodes);
+    void Release(TUniquePtr<FNavSearchContext> Context);
+    void Empty();
+
+private:
+    FCriticalSection Mutex;
+    TArray<TUniquePtr<FNavSearchContext>> FreeContexts;
+};
+
+// Borrows a context from the pool for the current scope.
+class FScopedNavSearchContext
+{
+public:
+    FScopedNavSearchContext(FNavSearchContextPool& InPool, int32 NumNodes)
+        : Pool(InPool)
+        , Context(InPool.Acquire(NumNodes))
+    {
+    }
+
+    // Takes over Existing if set (a search suspended in an earlier slice), otherwise acquires a fresh context.
+    FScopedNavSearchContext(FNavSearchContextPool& InPool, int32 NumNodes, TUniquePtr<FNavSearchContext> Existing)
+        : Pool(InPool)
+        , Context(Existing.IsValid() ? MoveTemp(Existing) : InPool.Acquire(NumNodes))
+    {
+    }
+
+    ~FScopedNavSearchContext()
+    {
+        Pool.Release(MoveTemp(Context));
+    }
+
+    FNavSearchContext& Get() const { return *Context; }
+
+    // Keeps the context out of the pool so its search can be continued later. Get must not be used afterwards.
+    TUniquePtr<FNavSearchContext> Detach() { return MoveTemp(Context); }
+
+private:
+    FNavSearchContextPool& Pool;
+    TUniquePtr<FNavSearchContext> Context;
+};
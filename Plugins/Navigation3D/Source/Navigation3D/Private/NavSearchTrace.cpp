@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NavSearchTrace.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+FArchive& operator<<(FArchive& Ar, FNavSearchTrace& Trace)
+{
+    Ar << Trace.StartLocation << Trace.DestinationLocation << Trace.StartCell << Trace.GoalCell;
+    Ar << Trace.ResultCode << Trace.bTruncated << Trace.WorldTimeSeconds;
+    Trace.ExpandedCells.BulkSerialize(Ar);
+    Trace.PathPoints.BulkSerialize(Ar);
+    return Ar;
+}
+
+void FNavSearchTraceRecorder::SetCapacity(int32 InCapacity)
+{
+    InCapacity = FMath::Max(0, InCapacity);
+    if (InCapacity != Capacity)
+    {
+        Empty();
+        Capacity = InCapacity;
+        Traces.Reserve(Capacity);
+    }
+}
+
+void FNavSearchTraceRecorder::Add(FNavSearchTrace&& Trace)
+{
+    if (Capacity == 0)
+    {
+        return;
+    }
+    if (Traces.Num() < Capacity)
+    {
+        Traces.Add(MoveTemp(Trace));
+        return;
+    }
+    Traces[NextSlot] = MoveTemp(Trace);
+    NextSlot = (NextSlot + 1) % Capacity;
+}
+
+void FNavSearchTraceRecorder::Empty()
+{
+    Traces.Empty();
+    NextSlot = 0;
+}
+
+void FNavSearchTraceRecorder::CopyTraces(TArray<FNavSearchTrace>& OutTraces) const
+{
+    // The ring starts at NextSlot once it has wrapped.
+    const int32 NumTraces = Traces.Num();
+    OutTraces.Reset(NumTraces);
+    for (int32 Offset = 0; Offset < NumTraces; ++Offset)
+    {
+        OutTraces.Add(Traces[(NextSlot + Offset) % NumTraces]);
+    }
+}
+
+bool FNavSearchTraceRecorder::SaveToFile(const FString& FilePath, const FNavSearchTraceHeader& Header) const
+{
+    TArray<FNavSearchTrace> OrderedTraces;
+    CopyTraces(OrderedTraces);
+    return SaveTracesToFile(FilePath, Header, OrderedTraces);
+}
+
+bool FNavSearchTraceRecorder::SaveTracesToFile(const FString& FilePath, const FNavSearchTraceHeader& Header, TArray<FNavSearchTrace>& InTraces)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("FNavSearchTraceRecorder::SaveTracesToFile"));
+
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+    uint32 Magic = FileMagic;
+    int32 Version = FileVersion;
+    FString VolumeName = Header.VolumeName;
+    FIntVector Divisions = Header.Divisions;
+    float DivisionSize = Header.DivisionSize;
+    uint8 Backend = Header.Backend;
+    int32 NumTraces = InTraces.Num();
+    Writer << Magic << Version << VolumeName << Divisions << DivisionSize << Backend << NumTraces;
+    for (FNavSearchTrace& Trace : InTraces)
+    {
+        Writer << Trace;
+    }
+    return FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+}
+
+bool FNavSearchTraceRecorder::LoadFromFile(const FString& FilePath, FNavSearchTraceHeader& OutHeader, TArray<FNavSearchTrace>& OutTraces)
+{
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *FilePath))
+    {
+        return false;
+    }
+
+    FMemoryReader Reader(Bytes);
+    uint32 Magic = 0;
+    int32 Version = 0;
+    Reader << Magic << Version;
+    if (Magic != FileMagic || Version != FileVersion)
+    {
+        return false;
+    }
+
+    int32 NumTraces = 0;
+    Reader << OutHeader.VolumeName << OutHeader.Divisions << OutHeader.DivisionSize << OutHeader.Backend << NumTraces;
+    if (Reader.IsError() || NumTraces < 0)
+    {
+        return false;
+    }
+
+    OutTraces.Reset();
+    for (int32 TraceIndex = 0; TraceIndex < NumTraces && !Reader.IsError(); ++TraceIndex)
+    {
+        Reader << OutTraces.AddDefaulted_GetRef();
+    }
+    return !Reader.IsError();
+}
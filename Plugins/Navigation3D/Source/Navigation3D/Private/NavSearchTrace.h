@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// One recorded path query: what was asked, which cells the search closed in which order and what came back.
+// Nodes are stored as grid cell indices (octree leaves by the cell at their centre), 4 bytes per expansion,
+// so a trace can be replayed against any volume with the same divisions.
+struct FNavSearchTrace
+{
+    FVector StartLocation = FVector::ZeroVector;
+    FVector DestinationLocation = FVector::ZeroVector;
+    // Cells the search actually ran between, after blocked endpoints were resolved. INDEX_NONE if it never got that far.
+    int32 StartCell = INDEX_NONE;
+    int32 GoalCell = INDEX_NONE;
+    // ENavigationVolumeResult of the delivered result.
+    uint8 ResultCode = 0;
+    // Expansions past the recorder's per-query limit were dropped.
+    bool bTruncated = false;
+    double WorldTimeSeconds = 0.0;
+    TArray<uint32> ExpandedCells;
+    TArray<FVector> PathPoints;
+
+    friend FArchive& operator<<(FArchive& Ar, FNavSearchTrace& Trace);
+};
+
+// Describes the volume a trace file came from.
+struct FNavSearchTraceHeader
+{
+    FString VolumeName;
+    FIntVector Divisions = FIntVector::ZeroValue;
+    float DivisionSize = 0.0f;
+    // ENavigationVolumeBackend.
+    uint8 Backend = 0;
+};
+
+// Ring buffer of the most recent traces. Game thread only: workers fill a trace per query and the volume
+// hands it over when the result is delivered, so recording never takes a lock.
+class FNavSearchTraceRecorder
+{
+public:
+    // Drops recorded traces when the capacity changes.
+    void SetCapacity(int32 InCapacity);
+    FORCEINLINE int32 GetCapacity() const { return Capacity; }
+    FORCEINLINE int32 Num() const { return Traces.Num(); }
+
+    // Overwrites the oldest trace once the buffer is full.
+    void Add(FNavSearchTrace&& Trace);
+    void Empty();
+
+    // Copies every recorded trace, oldest first.
+    void CopyTraces(TArray<FNavSearchTrace>& OutTraces) const;
+
+    // Writes every recorded trace, oldest first.
+    bool SaveToFile(const FString& FilePath, const FNavSearchTraceHeader& Header) const;
+    // Writes traces copied out with CopyTraces in the same format. Touches no recorder state, so it can run on any thread.
+    static bool SaveTracesToFile(const FString& FilePath, const FNavSearchTraceHeader& Header, TArray<FNavSearchTrace>& InTraces);
+    static bool LoadFromFile(const FString& FilePath, FNavSearchTraceHeader& OutHeader, TArray<FNavSearchTrace>& OutTraces);
+
+private:
+    static constexpr uint32 FileMagic = 0x5444334E; // "N3DT"
+    static constexpr int32 FileVersion = 1;
+
+    TArray<FNavSearchTrace> Traces;
+    int32 Capacity = 0;
+    // Slot the next trace goes to once the buffer is full; also where the oldest trace sits.
+    int32 NextSlot = 0;
+};
+
+// A* visitor that records the close order into a trace, then forwards to Inner. Stops recording at MaxExpansions.
+template<typename InnerVisitorType>
+struct TNavSearchTraceVisitor
+{
+    InnerVisitorType& Inner;
+    FNavSearchTrace& Trace;
+    int32 MaxExpansions;
+    TFunctionRef<uint32(int32)> NodeToCell;
+
+    TNavSearchTraceVisitor(InnerVisitorType& InInner, FNavSearchTrace& InTrace, int32 InMaxExpansions, TFunctionRef<uint32(int32)> InNodeToCell)
+        : Inner(InInner), Trace(InTrace), MaxExpansions(InMaxExpansions), NodeToCell(InNodeToCell)
+    {
+    }
+
+    FORCEINLINE void OnPopped(int32 NodeIndex) { Inner.OnPopped(NodeIndex); }
+    FORCEINLINE void OnClosed(int32 NodeIndex)
+    {
+        if (Trace.ExpandedCells.Num() < MaxExpansions)
+        {
+            Trace.ExpandedCells.Add(NodeToCell(NodeIndex));
+        }
+        else
+        {
+            Trace.bTruncated = true;
+        }
+        Inner.OnClosed(NodeIndex);
+    }
+    FORCEINLINE void OnNeighborConsidered(int32 FromIndex, int32 ToIndex) { Inner.OnNeighborConsidered(FromIndex, ToIndex); }
+    FORCEINLINE void OnNeighborImproved(int32 FromIndex, int32 ToIndex) { Inner.OnNeighborImproved(FromIndex, ToIndex); }
+};
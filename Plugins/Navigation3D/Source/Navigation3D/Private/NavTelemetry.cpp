@@ -0,0 +1,163 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NavTelemetry.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DECLARE_STATS_GROUP(TEXT("Navigation3D"), STATGROUP_Navigation3D, STATCAT_Advanced);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Queries Completed"), STAT_Nav3D_QueriesCompleted, STATGROUP_Navigation3D);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Nodes Expanded"), STAT_Nav3D_NodesExpanded, STATGROUP_Navigation3D);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Queue Depth"), STAT_Nav3D_QueueDepth, STATGROUP_Navigation3D);
+DECLARE_DWORD_COUNTER_STAT(TEXT("In Flight"), STAT_Nav3D_InFlight, STATGROUP_Navigation3D);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Queries Per Second"), STAT_Nav3D_QueriesPerSecond, STATGROUP_Navigation3D);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Latency p50 (ms)"), STAT_Nav3D_LatencyP50, STATGROUP_Navigation3D);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Latency p95 (ms)"), STAT_Nav3D_LatencyP95, STATGROUP_Navigation3D);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Latency p99 (ms)"), STAT_Nav3D_LatencyP99, STATGROUP_Navigation3D);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Path Cache Hit Rate"), STAT_Nav3D_CacheHitRate, STATGROUP_Navigation3D);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Open List Peak"), STAT_Nav3D_OpenListPeak, STATGROUP_Navigation3D);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Results: Success"), STAT_Nav3D_ResultSuccess, STATGROUP_Navigation3D);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Results: Partial Path"), STAT_Nav3D_ResultPartialPath, STATGROUP_Navigation3D);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Results: No Path"), STAT_Nav3D_ResultNoPath, STATGROUP_Navigation3D);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Results: Cancelled"), STAT_Nav3D_ResultCancelled, STATGROUP_Navigation3D);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Results: Failed"), STAT_Nav3D_ResultFailed, STATGROUP_Navigation3D);
+DECLARE_MEMORY_STAT(TEXT("Navigation Data"), STAT_Nav3D_NavigationDataMemory, STATGROUP_Navigation3D);
+
+CSV_DEFINE_CATEGORY(Navigation3D, true);
+
+FNavQueryTelemetry& FNavQueryTelemetry::Get()
+{
+    static FNavQueryTelemetry Telemetry;
+    return Telemetry;
+}
+
+void FNavQueryTelemetry::RecordQuery(ENavQueryOutcome Outcome, double LatencySeconds, int32 NumExpanded, int32 PeakOpenNodes)
+{
+    switch (Outcome)
+    {
+    case ENavQueryOutcome::Success:     INC_DWORD_STAT(STAT_Nav3D_ResultSuccess); break;
+    case ENavQueryOutcome::PartialPath: INC_DWORD_STAT(STAT_Nav3D_ResultPartialPath); break;
+    case ENavQueryOutcome::NoPath:      INC_DWORD_STAT(STAT_Nav3D_ResultNoPath); break;
+    case ENavQueryOutcome::Cancelled:   INC_DWORD_STAT(STAT_Nav3D_ResultCancelled); break;
+    default:                            INC_DWORD_STAT(STAT_Nav3D_ResultFailed); break;
+    }
+    INC_DWORD_STAT(STAT_Nav3D_QueriesCompleted);
+    INC_DWORD_STAT_BY(STAT_Nav3D_NodesExpanded, NumExpanded);
+    CSV_CUSTOM_STAT(Navigation3D, QueriesCompleted, 1, ECsvCustomStatOp::Accumulate);
+    CSV_CUSTOM_STAT(Navigation3D, NodesExpanded, NumExpanded, ECsvCustomStatOp::Accumulate);
+
+    // Cancelled queries never reached a caller, so they say nothing about delivery latency.
+    if (Outcome != ENavQueryOutcome::Cancelled)
+    {
+        ++LatencyBuckets[GetLatencyBucket(LatencySeconds)];
+        ++WindowNumQueries;
+    }
+    WindowPeakOpenNodes = FMath::Max(WindowPeakOpenNodes, PeakOpenNodes);
+}
+
+void FNavQueryTelemetry::RecordCacheLookup(bool bHit)
+{
+    WindowCacheHits += bHit ? 1 : 0;
+    ++WindowCacheLookups;
+}
+
+void FNavQueryTelemetry::RecordQueueState(int32 NumPending, int32 NumInFlight)
+{
+    INC_DWORD_STAT_BY(STAT_Nav3D_QueueDepth, NumPending);
+    INC_DWORD_STAT_BY(STAT_Nav3D_InFlight, NumInFlight);
+    CSV_CUSTOM_STAT(Navigation3D, QueueDepth, NumPending, ECsvCustomStatOp::Accumulate);
+    CSV_CUSTOM_STAT(Navigation3D, InFlight, NumInFlight, ECsvCustomStatOp::Accumulate);
+}
+
+void FNavQueryTelemetry::AddNavigationDataBytes(int64 DeltaBytes)
+{
+    if (DeltaBytes > 0)
+    {
+        INC_MEMORY_STAT_BY(STAT_Nav3D_NavigationDataMemory, DeltaBytes);
+    }
+    else if (DeltaBytes < 0)
+    {
+        DEC_MEMORY_STAT_BY(STAT_Nav3D_NavigationDataMemory, -DeltaBytes);
+    }
+}
+
+void FNavQueryTelemetry::Tick()
+{
+    if (LastTickFrame == GFrameCounter)
+    {
+        return;
+    }
+    LastTickFrame = GFrameCounter;
+
+    const double Now = FPlatformTime::Seconds();
+    if (WindowStartTime == 0.0)
+    {
+        WindowStartTime = Now;
+    }
+    else if (Now - WindowStartTime >= 1.0)
+    {
+        PublishWindow(Now);
+    }
+
+    CSV_CUSTOM_STAT(Navigation3D, QueriesPerSecond, QueriesPerSecond, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(Navigation3D, LatencyP50Ms, LatencyP50Ms, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(Navigation3D, LatencyP95Ms, LatencyP95Ms, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(Navigation3D, LatencyP99Ms, LatencyP99Ms, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(Navigation3D, CacheHitRate, CacheHitRate, ECsvCustomStatOp::Set);
+}
+
+int32 FNavQueryTelemetry::GetLatencyBucket(double LatencySeconds)
+{
+    const double Microseconds = LatencySeconds * 1.0e6;
+    if (Microseconds <= 1.0)
+    {
+        return 0;
+    }
+    return FMath::Clamp(FMath::FloorToInt32(FMath::Log2(Microseconds) * BucketsPerOctave), 0, NumLatencyBuckets - 1);
+}
+
+float FNavQueryTelemetry::GetWindowLatencyPercentileMs(float Percentile) const
+{
+    if (WindowNumQueries == 0)
+    {
+        return 0.0f;
+    }
+
+    // Reports the geometric middle of the bucket holding the requested rank.
+    const uint32 Rank = FMath::Max(1u, static_cast<uint32>(FMath::CeilToDouble(Percentile * WindowNumQueries)));
+    uint32 Cumulative = 0;
+    for (int32 Bucket = 0; Bucket < NumLatencyBuckets; ++Bucket)
+    {
+        Cumulative += LatencyBuckets[Bucket];
+        if (Cumulative >= Rank)
+        {
+            return static_cast<float>(FMath::Pow(2.0, (Bucket + 0.5) / BucketsPerOctave) / 1000.0);
+        }
+    }
+    return static_cast<float>(FMath::Pow(2.0, static_cast<double>(NumLatencyBuckets) / BucketsPerOctave) / 1000.0);
+}
+
+void FNavQueryTelemetry::PublishWindow(double Now)
+{
+    QueriesPerSecond = static_cast<float>(WindowNumQueries / (Now - WindowStartTime));
+    LatencyP50Ms = GetWindowLatencyPercentileMs(0.50f);
+    LatencyP95Ms = GetWindowLatencyPercentileMs(0.95f);
+    LatencyP99Ms = GetWindowLatencyPercentileMs(0.99f);
+    CacheHitRate = WindowCacheLookups > 0 ? static_cast<float>(WindowCacheHits) / WindowCacheLookups : 0.0f;
+
+    SET_FLOAT_STAT(STAT_Nav3D_QueriesPerSecond, QueriesPerSecond);
+    SET_FLOAT_STAT(STAT_Nav3D_LatencyP50, LatencyP50Ms);
+    SET_FLOAT_STAT(STAT_Nav3D_LatencyP95, LatencyP95Ms);
+    SET_FLOAT_STAT(STAT_Nav3D_LatencyP99, LatencyP99Ms);
+    SET_FLOAT_STAT(STAT_Nav3D_CacheHitRate, CacheHitRate);
+    SET_DWORD_STAT(STAT_Nav3D_OpenListPeak, WindowPeakOpenNodes);
+    CSV_CUSTOM_STAT(Navigation3D, OpenListPeak, WindowPeakOpenNodes, ECsvCustomStatOp::Set);
+
+    FMemory::Memzero(LatencyBuckets, sizeof(LatencyBuckets));
+    WindowNumQueries = 0;
+    WindowCacheHits = 0;
+    WindowCacheLookups = 0;
+    WindowPeakOpenNodes = 0;
+    WindowStartTime = Now;
+}
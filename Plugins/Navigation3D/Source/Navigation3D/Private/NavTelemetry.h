@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// How a path query ended, as counted by FNavQueryTelemetry.
+enum class ENavQueryOutcome : uint8
+{
+    Success,    // Includes paths to self.
+    PartialPath,
+    NoPath,
+    Cancelled,
+    Failed,     // Invalid or blocked endpoints, volume not ready.
+    Num
+};
+
+// Process-wide path query telemetry behind `stat Navigation3D` and the Navigation3D CSV profiler category.
+// Every volume reports into the same instance. Per-frame rows (queries, expansions, queue depth) are plain
+// counters; latency percentiles, throughput, open-list peak and cache hit rate are computed over one-second
+// windows from a fixed log-scale histogram, so recording stays a few adds and is cheap enough to leave on.
+// Game thread only.
+class FNavQueryTelemetry
+{
+public:
+    static FNavQueryTelemetry& Get();
+
+    // LatencySeconds runs from the request to its callback.
+    void RecordQuery(ENavQueryOutcome Outcome, double LatencySeconds, int32 NumExpanded, int32 PeakOpenNodes);
+    void RecordCacheLookup(bool bHit);
+    // Called by each volume once per tick.
+    void RecordQueueState(int32 NumPending, int32 NumInFlight);
+    // Bytes of grid, hierarchy, landmark and octree data, as a change to this volume's previous report.
+    void AddNavigationDataBytes(int64 DeltaBytes);
+
+    // Publishes the window values once a second is up. Safe to call from several volumes in the same frame.
+    void Tick();
+
+private:
+    // Quarter-octave buckets of microseconds: bucket B starts at 2^(B / 4) us. The last one covers everything over ~1 s.
+    static constexpr int32 BucketsPerOctave = 4;
+    static constexpr int32 NumLatencyBuckets = 20 * BucketsPerOctave;
+
+    static int32 GetLatencyBucket(double LatencySeconds);
+    float GetWindowLatencyPercentileMs(float Percentile) const;
+
+    void PublishWindow(double Now);
+
+    uint32 LatencyBuckets[NumLatencyBuckets] = {};
+    uint32 WindowNumQueries = 0;
+    uint32 WindowCacheHits = 0;
+    uint32 WindowCacheLookups = 0;
+    int32 WindowPeakOpenNodes = 0;
+    double WindowStartTime = 0.0;
+    uint64 LastTickFrame = 0;
+
+    // Results of the last finished window, repeated into every CSV frame until the next one.
+    float QueriesPerSecond = 0.0f;
+    float LatencyP50Ms = 0.0f;
+    float LatencyP95Ms = 0.0f;
+    float LatencyP99Ms = 0.0f;
+    float CacheHitRate = 0.0f;
+};
@@ -1,26 +1,169 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "NavigationVolume3D.h"
+#include "NavigationVolume3DBakeData.h"
 #include "NavNode.h"
 #include "ProceduralMeshComponent.h"
 #include "Materials/MaterialInstanceDynamic.h"
-#include "Kismet/KismetSystemLibrary.h"
 #include "Algo/Reverse.h"
 #include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
 #include "GameFramework/Actor.h"
+#include "GameFramework/Pawn.h"
 
-#include <queue>
-#include <vector>
-#include <unordered_map>
-#include <unordered_set>
 #include <limits>
+#include <type_traits>
 #include "DrawDebugHelpers.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
 #include "Kismet/GameplayStatics.h"
+#include "NavAStar.h"
+#include "NavJumpPoint.h"
+#include "NavLineOfSight.h"
+#include "NavTelemetry.h"
+#include "NavSearchTrace.h"
+
+
+namespace
+{
+    // Collects the A* exploration for the debug overlay; search nodes are mapped to world space by the caller.
+    struct FNavDebugDrawVisitor
+    {
+        TArray<FDebugSphereData>& Spheres;
+        TArray<FDebugLineData>& Lines;
+        float SphereRadius;
+        TFunction<FVector(int32)> NodeToLocation;
+
+        FNavDebugDrawVisitor(TArray<FDebugSphereData>& InSpheres, TArray<FDebugLineData>& InLines, float InSphereRadius, TFunction<FVector(int32)> InNodeToLocation)
+            : Spheres(InSpheres), Lines(InLines), SphereRadius(InSphereRadius), NodeToLocation(MoveTemp(InNodeToLocation))
+        {
+        }
+
+        void OnPopped(int32 NodeIndex)
+        {
+            Spheres.Add({NodeToLocation(NodeIndex), SphereRadius * 1.2f, FColor::Yellow, 12});
+        }
+        void OnClosed(int32 NodeIndex)
+        {
+            Spheres.Add({NodeToLocation(NodeIndex), SphereRadius, FColor::Red, 12});
+        }
+        void OnNeighborConsidered(int32 FromIndex, int32 ToIndex)
+        {
+            Lines.Add({NodeToLocation(FromIndex), NodeToLocation(ToIndex), FColor(128, 128, 128, 100), 0.5f});
+        }
+        void OnNeighborImproved(int32 FromIndex, int32 ToIndex)
+        {
+            Spheres.Add({NodeToLocation(ToIndex), SphereRadius, FColor::Green, 12});
+            Lines.Add({NodeToLocation(FromIndex), NodeToLocation(ToIndex), FColor::White, 1.0f});
+        }
+    };
+
+    ENavQueryOutcome ToNavQueryOutcome(ENavigationVolumeResult ResultCode)
+    {
+        switch (ResultCode) {
+        case ENavigationVolumeResult::ENVR_Success:
+        case ENavigationVolumeResult::ENVR_PathToSelf:
+            return ENavQueryOutcome::Success;
+        case ENavigationVolumeResult::ENVR_PartialPath:
+            return ENavQueryOutcome::PartialPath;
+        case ENavigationVolumeResult::ENVR_NoPathExists:
+            return ENavQueryOutcome::NoPath;
+        case ENavigationVolumeResult::ENVR_Cancelled:
+            return ENavQueryOutcome::Cancelled;
+        default:
+            return ENavQueryOutcome::Failed;
+        }
+    }
+
+    void RecordPathQueryTelemetry(double EnqueueTime, ENavigationVolumeResult ResultCode, int32 NumExpanded = 0, int32 PeakOpenNodes = 0)
+    {
+        FNavQueryTelemetry::Get().RecordQuery(ToNavQueryOutcome(ResultCode), FPlatformTime::Seconds() - EnqueueTime, NumExpanded, PeakOpenNodes);
+    }
+
+    // Counts expansions for BenchmarkSearchAlgorithms.
+    struct FNavCountingVisitor : FNavAStarNullVisitor
+    {
+        int32 NumExpanded = 0;
+        FORCEINLINE void OnClosed(int32) { ++NumExpanded; }
+    };
+
+    // Runs A* over Graph, with the heuristic raised to the landmark bound when there are landmark tables.
+    template<typename GraphType, typename VisitorType>
+    ENavAStarStatus RunGridAStar(const GraphType& Graph, const FNavLandmarkHeuristic& Landmarks, FNavSearchContext& Search,
+        const FNavAStarParams& Params, VisitorType& Visitor)
+    {
+        if (Landmarks.IsEmpty()) {
+            return RunNavAStar(Graph, Search, Params, Visitor);
+        }
+        const TNavLandmarkGraph<GraphType> LandmarkGraph(Graph, Landmarks);
+        return RunNavAStar(LandmarkGraph, Search, Params, Visitor);
+    }
+
+    // Clearance-aware searches (MinClearance > 1 or OpenSpaceWeight > 0) run plain A* over FNavGridClearanceGraph;
+    // jump point pruning assumes uniform step costs and every free cell being usable. Landmark bounds come from the
+    // plain grid, whose distances are never longer than either of those graphs', so they apply to all three.
+    template<typename VisitorType>
+    ENavAStarStatus RunDenseGridSearch(const FNavGrid& Grid, const FNavJumpPointRules& JumpPointRules, bool bUseJumpPoints,
+        uint8 MinClearance, float OpenSpaceWeight, const FNavLandmarkHeuristic& Landmarks, FNavSearchContext& Search,
+        const FNavAStarParams& Params, VisitorType& Visitor)
+    {
+        if (MinClearance > 1 || OpenSpaceWeight > 0.0f) {
+            const FNavGridClearanceGraph ClearanceGraph(Grid, Params.GoalIndex, MinClearance, OpenSpaceWeight);
+            return RunGridAStar(ClearanceGraph, Landmarks, Search, Params, Visitor);
+        }
+        if (bUseJumpPoints) {
+            const FNavJumpPointGraph JumpPointGraph(Grid, JumpPointRules, Search, Params.GoalIndex);
+            return RunGridAStar(JumpPointGraph, Landmarks, Search, Params, Visitor);
+        }
+        const FNavGridGraph GridGraph(Grid, Grid.ToCoordinates(Params.GoalIndex));
+        return RunGridAStar(GridGraph, Landmarks, Search, Params, Visitor);
+    }
+
+    // RunDenseGridSearch without jump points, limited to the cells of Grid whose level-Level parent is in Corridor.
+    template<typename VisitorType>
+    ENavAStarStatus RunDenseGridCorridorSearch(const FNavGrid& Grid, const FNavGrid& LevelGrid, int32 Level, const TBitArray<>& Corridor,
+        uint8 MinClearance, float OpenSpaceWeight, const FNavLandmarkHeuristic& Landmarks, FNavSearchContext& Search,
+        const FNavAStarParams& Params, VisitorType& Visitor)
+    {
+        if (MinClearance > 1 || OpenSpaceWeight > 0.0f) {
+            const FNavGridClearanceGraph ClearanceGraph(Grid, Params.GoalIndex, MinClearance, OpenSpaceWeight);
+            const TNavCorridorGraph<FNavGridClearanceGraph> CorridorGraph(ClearanceGraph, Grid, LevelGrid, Level, Corridor);
+            return RunGridAStar(CorridorGraph, Landmarks, Search, Params, Visitor);
+        }
+        const FNavGridGraph GridGraph(Grid, Grid.ToCoordinates(Params.GoalIndex));
+        const TNavCorridorGraph<FNavGridGraph> CorridorGraph(GridGraph, Grid, LevelGrid, Level, Corridor);
+        return RunGridAStar(CorridorGraph, Landmarks, Search, Params, Visitor);
+    }
+
+    // ForwardLandmarks bound the distance to the goal, BackwardLandmarks the distance to the start.
+    template<typename VisitorType>
+    ENavAStarStatus RunDenseGridBidirectionalSearch(const FNavGrid& Grid, const FNavLandmarkHeuristic& ForwardLandmarks,
+        const FNavLandmarkHeuristic& BackwardLandmarks, FNavSearchContext& Forward, FNavSearchContext& Backward,
+        const FNavAStarParams& Params, VisitorType& Visitor, int32& OutMeetingIndex)
+    {
+        const FNavGridGraph ForwardGraph(Grid, Grid.ToCoordinates(Params.GoalIndex));
+        const FNavGridGraph BackwardGraph(Grid, Grid.ToCoordinates(Params.StartIndex));
+        if (ForwardLandmarks.IsEmpty() || BackwardLandmarks.IsEmpty()) {
+            return RunNavBidirectionalAStar(ForwardGraph, BackwardGraph, Forward, Backward, Params, Visitor, OutMeetingIndex);
+        }
+        const TNavLandmarkGraph<FNavGridGraph> ForwardLandmarkGraph(ForwardGraph, ForwardLandmarks);
+        const TNavLandmarkGraph<FNavGridGraph> BackwardLandmarkGraph(BackwardGraph, BackwardLandmarks);
+        return RunNavBidirectionalAStar(ForwardLandmarkGraph, BackwardLandmarkGraph, Forward, Backward, Params, Visitor, OutMeetingIndex);
+    }
+}
 
 
 ANavigationVolume3D::ANavigationVolume3D()
 {
-    PrimaryActorTick.bCanEverTick = false;
+    // Ticks only to schedule path queries; does nothing while the query queues are empty.
+    PrimaryActorTick.bCanEverTick = true;
+    PrimaryActorTick.bStartWithTickEnabled = true;
+    PrimaryActorTick.bTickEvenWhenPaused = true;
 
     DefaultSceneComponent = CreateDefaultSubobject<USceneComponent>("DefaultSceneComponent");
     SetRootComponent(DefaultSceneComponent);
@@ -39,6 +182,88 @@ ANavigationVolume3D::ANavigationVolume3D()
     ObstacleObjectTypes.Add(UEngineTypes::ConvertToObjectType(ECC_WorldDynamic));
 }
 
+void ANavigationVolume3D::CollectRandomLocationCandidates(const FVector& Origin, float WorldRadius, int32 MaxCandidates, TArray<FVector>& OutCandidates) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::CollectRandomLocationCandidates"));
+
+    OutCandidates.Reset();
+    if (!IsNavigationDataReady() || WorldRadius < 0.0f || DivisionSize < KINDA_SMALL_NUMBER || MaxCandidates <= 0) {
+        return;
+    }
+
+    const FIntVector OriginGridCoords = ConvertLocationToCoordinates(Origin);
+    if (WorldRadius < KINDA_SMALL_NUMBER) {
+        if (IsCellTraversable(OriginGridCoords)) {
+            OutCandidates.Add(ConvertCoordinatesToLocation(OriginGridCoords));
+        }
+        return;
+    }
+
+    // Origin can sit anywhere in its cell, so cells one past the radius can still have their centre in range.
+    const int32 SearchRadiusInCells = FMath::CeilToInt(WorldRadius / DivisionSize) + 1;
+    FIntVector MinCell = OriginGridCoords - FIntVector(SearchRadiusInCells);
+    FIntVector MaxCell = OriginGridCoords + FIntVector(SearchRadiusInCells);
+    ClampCoordinates(MinCell);
+    ClampCoordinates(MaxCell);
+    const float WorldRadiusSquared = FMath::Square(WorldRadius);
+
+    TArray<int32, TInlineAllocator<64>> PickedCells;
+    auto IsInRange = [&](const FIntVector& Cell) {
+        return Cell.X >= MinCell.X && Cell.X <= MaxCell.X && Cell.Y >= MinCell.Y && Cell.Y <= MaxCell.Y && Cell.Z >= MinCell.Z && Cell.Z <= MaxCell.Z
+            && FVector::DistSquared(Origin, ConvertCoordinatesToLocation(Cell)) <= WorldRadiusSquared;
+    };
+    auto TryAddCandidate = [&](const FIntVector& Cell, int32 CellKey) {
+        if (!PickedCells.Contains(CellKey) && IsInRange(Cell)) {
+            PickedCells.Add(CellKey);
+            OutCandidates.Add(ConvertCoordinatesToLocation(Cell));
+        }
+    };
+
+    // Rejection sampling only stays cheap while most draws land in range; after this many tries per wanted
+    // candidate the radius is mostly blocked or far smaller than a brick and the caller gets what was found.
+    constexpr int32 MaxDrawsPerCandidate = 16;
+    const int32 MaxDraws = MaxCandidates * MaxDrawsPerCandidate;
+
+    if (!TraversableBricks.IsEmpty()) {
+        FNavBrickSampleSet SampleSet;
+        TraversableBricks.GatherBricks(MinCell, MaxCell, SampleSet);
+
+        // Few enough free cells to list: keep those in range and draw from them directly, which is exact even
+        // when the radius covers a small corner of the bricks.
+        if (SampleSet.NumCells() <= FNavBrickIndex::BrickSize * FNavBrickIndex::BrickSize * FNavBrickIndex::BrickSize) {
+            TArray<int32, TInlineAllocator<512>> CellsInRange;
+            TraversableBricks.ForEachCell(SampleSet, [&](int32 CellIndex) {
+                if (IsInRange(Grid.ToCoordinates(CellIndex))) {
+                    CellsInRange.Add(CellIndex);
+                }
+            });
+            const int32 NumToPick = FMath::Min(MaxCandidates, CellsInRange.Num());
+            for (int32 Pick = 0; Pick < NumToPick; ++Pick) {
+                CellsInRange.Swap(Pick, RandomLocationStream.RandRange(Pick, CellsInRange.Num() - 1));
+                OutCandidates.Add(ConvertCoordinatesToLocation(Grid.ToCoordinates(CellsInRange[Pick])));
+            }
+            return;
+        }
+
+        for (int32 Draw = 0; Draw < MaxDraws && OutCandidates.Num() < MaxCandidates; ++Draw) {
+            const int32 CellIndex = TraversableBricks.SampleCell(SampleSet, RandomLocationStream);
+            TryAddCandidate(Grid.ToCoordinates(CellIndex), CellIndex);
+        }
+        return;
+    }
+
+    // Sparse octree: no per-cell index, so draw cells from the box and keep the free ones.
+    for (int32 Draw = 0; Draw < MaxDraws && OutCandidates.Num() < MaxCandidates; ++Draw) {
+        const FIntVector Cell(
+            RandomLocationStream.RandRange(MinCell.X, MaxCell.X),
+            RandomLocationStream.RandRange(MinCell.Y, MaxCell.Y),
+            RandomLocationStream.RandRange(MinCell.Z, MaxCell.Z));
+        if (IsCellTraversable(Cell)) {
+            TryAddCandidate(Cell, (Cell.Z * DivisionsY + Cell.Y) * DivisionsX + Cell.X);
+        }
+    }
+}
+
 bool ANavigationVolume3D::FindRandomValidLocationInRadius(
     const FVector& Origin,
     float WorldRadius,
@@ -49,68 +274,81 @@ bool ANavigationVolume3D::FindRandomValidLocationInRadius(
 {
     TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::FindRandomValidLocationInRadius"));
 
-    if (!bNodesInitializedAndFinalized || Nodes.IsEmpty() || WorldRadius < 0.0f || DivisionSize < KINDA_SMALL_NUMBER)
-    {
-        if (WorldRadius < KINDA_SMALL_NUMBER && bNodesInitializedAndFinalized && !Nodes.IsEmpty() && DivisionSize > KINDA_SMALL_NUMBER)
-        {
-            const FIntVector OriginCoords = ConvertLocationToCoordinates(Origin);
-            const NavNode* OriginNode = GetConstNode(OriginCoords);
-            if (OriginNode && OriginNode->bIsTraversable)
-            {
-                OutValidLocation = ConvertCoordinatesToLocation(OriginNode->Coordinates);
-                FHitResult HitResult;
-                FCollisionQueryParams CollisionParams;
-                if (ActorToIgnoreForLOS && IsValid(ActorToIgnoreForLOS)) { CollisionParams.AddIgnoredActor(ActorToIgnoreForLOS); }
-                
-                UWorld* World = GetWorld();
-                bool bHasLineOfSight = true;
-                if (World) {
-                    bHasLineOfSight = !World->LineTraceSingleByObjectType(
-                        HitResult, Origin, OutValidLocation, FCollisionObjectQueryParams(ObstacleObjectTypes), CollisionParams);
-                }
-                if (bHasLineOfSight) return true;
-            }
+    TArray<FVector> Candidates;
+    CollectRandomLocationCandidates(Origin, WorldRadius, MaxCandidatesToCollect, Candidates);
+
+    UWorld* World = GetWorld();
+    FCollisionQueryParams LOS_CollisionParams;
+    if (ActorToIgnoreForLOS && IsValid(ActorToIgnoreForLOS)) { LOS_CollisionParams.AddIgnoredActor(ActorToIgnoreForLOS); }
+    const FCollisionObjectQueryParams LOS_ObjectQueryParams(ObstacleObjectTypes);
+
+    for (const FVector& Candidate : Candidates) {
+        bool bHasLineOfSight = true;
+        if (World) {
+            FHitResult HitResult;
+            bHasLineOfSight = !World->LineTraceSingleByObjectType(HitResult, Origin, Candidate, LOS_ObjectQueryParams, LOS_CollisionParams);
+        }
+        if (bHasLineOfSight) {
+            OutValidLocation = Candidate;
+            return true;
         }
-        return false;
     }
+    return false;
+}
 
-    const FIntVector OriginGridCoords = ConvertLocationToCoordinates(Origin);
-    const int32 BaseSearchRadiusInCells = FMath::CeilToInt(WorldRadius / DivisionSize);
-    const int32 SearchExpansionCells = 1; 
-    const int32 ExpandedSearchRadiusInCells = BaseSearchRadiusInCells + SearchExpansionCells;
-    const float WorldRadiusSquared = FMath::Square(WorldRadius);
+void ANavigationVolume3D::FindRandomValidLocationInRadiusAsync(
+    const FVector& Origin,
+    float WorldRadius,
+    FOnRandomLocationFound OnFoundCallback,
+    const AActor* ActorToIgnoreForLOS,
+    int32 MaxCandidatesToCollect)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::FindRandomValidLocationInRadiusAsync"));
+    check(IsInGameThread());
+
+    // Shared by the trace callbacks; the answer goes out once the last of them has come back.
+    struct FRandomLocationTraceBatch
+    {
+        TArray<FVector> Candidates;
+        TArray<bool> bInSight;
+        int32 NumPending = 0;
+        FOnRandomLocationFound Callback;
+    };
+    const TSharedRef<FRandomLocationTraceBatch> Batch = MakeShared<FRandomLocationTraceBatch>();
+    Batch->Callback = OnFoundCallback;
+    CollectRandomLocationCandidates(Origin, WorldRadius, MaxCandidatesToCollect, Batch->Candidates);
 
     UWorld* World = GetWorld();
-    FCollisionQueryParams LOS_CollisionParams;
+    if (!World) {
+        // No world to trace in or to defer to, so the caller hears back right away.
+        Batch->Callback.ExecuteIfBound(false, FVector::ZeroVector);
+        return;
+    }
+    if (Batch->Candidates.IsEmpty()) {
+        World->GetTimerManager().SetTimerForNextTick([Batch]() {
+            Batch->Callback.ExecuteIfBound(false, FVector::ZeroVector);
+        });
+        return;
+    }
+
+    FCollisionQueryParams LOS_CollisionParams(SCENE_QUERY_STAT(Navigation3DRandomLocation));
     if (ActorToIgnoreForLOS && IsValid(ActorToIgnoreForLOS)) { LOS_CollisionParams.AddIgnoredActor(ActorToIgnoreForLOS); }
-    FCollisionObjectQueryParams LOS_ObjectQueryParams(ObstacleObjectTypes);
-
-    for (int32 dz = ExpandedSearchRadiusInCells; dz >= -ExpandedSearchRadiusInCells; --dz) {
-        for (int32 dy = -ExpandedSearchRadiusInCells; dy <= ExpandedSearchRadiusInCells; ++dy) {
-            for (int32 dx = -ExpandedSearchRadiusInCells; dx <= ExpandedSearchRadiusInCells; ++dx) {
-                const FIntVector CurrentGridCoords = OriginGridCoords + FIntVector(dx, dy, dz);
-                if (!AreCoordinatesValid(CurrentGridCoords)) continue;
-
-                const NavNode* CandidateNode = GetConstNode(CurrentGridCoords);
-                if (CandidateNode && CandidateNode->bIsTraversable) {
-                    const FVector NodeWorldCenter = ConvertCoordinatesToLocation(CandidateNode->Coordinates);
-                    if (FVector::DistSquared(Origin, NodeWorldCenter) <= WorldRadiusSquared) {
-                        bool bHasLineOfSight = true;
-                        if (World) {
-                            FHitResult HitResult;
-                            bHasLineOfSight = !World->LineTraceSingleByObjectType(
-                                HitResult, Origin, NodeWorldCenter, LOS_ObjectQueryParams, LOS_CollisionParams);
-                        }
-                        if (bHasLineOfSight) {
-                            OutValidLocation = NodeWorldCenter;
-                            return true;
-                        }
-                    }
-                }
+    const FCollisionObjectQueryParams LOS_ObjectQueryParams(ObstacleObjectTypes);
+
+    Batch->bInSight.Init(false, Batch->Candidates.Num());
+    Batch->NumPending = Batch->Candidates.Num();
+    for (int32 CandidateIndex = 0; CandidateIndex < Batch->Candidates.Num(); ++CandidateIndex) {
+        FTraceDelegate OnTraceDone = FTraceDelegate::CreateLambda([Batch, CandidateIndex](const FTraceHandle&, FTraceDatum& Datum) {
+            Batch->bInSight[CandidateIndex] = !Datum.OutHits.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+            if (--Batch->NumPending > 0) {
+                return;
             }
-        }
+            // Sample order, not trace completion order, decides, so the answer stays a uniform draw.
+            const int32 FoundIndex = Batch->bInSight.Find(true);
+            Batch->Callback.ExecuteIfBound(FoundIndex != INDEX_NONE, FoundIndex != INDEX_NONE ? Batch->Candidates[FoundIndex] : FVector::ZeroVector);
+        });
+        World->AsyncLineTraceByObjectType(EAsyncTraceType::Single, Origin, Batch->Candidates[CandidateIndex], LOS_ObjectQueryParams, LOS_CollisionParams, &OnTraceDone);
     }
-    return false;
 }
 
 
@@ -120,321 +358,1523 @@ void ANavigationVolume3D::FindPathAsync(
     const FVector& DestinationLocation,
     FOnPathfindingComplete OnCompleteCallback)
 {
-    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::FindPathAsync_Launch"));
-    
-    TWeakObjectPtr<ANavigationVolume3D> WeakThis(this);
-    TWeakObjectPtr<const AActor> WeakRequestingActor(RequestingActor);
-    FString ActorName = RequestingActor ? RequestingActor->GetName() : TEXT("UnknownActor");
-    
-    uint32_t NewSearchID = AtomicPathfindingSearchIDCounter.fetch_add(1, std::memory_order_relaxed) + 1;
-    if (NewSearchID == 0) {
-        NewSearchID = AtomicPathfindingSearchIDCounter.fetch_add(1, std::memory_order_relaxed) + 1;
-    }
+    FindPathAsyncWithOptions(RequestingActor, StartLocation, DestinationLocation, FNavPathQueryOptions(), OnCompleteCallback);
+}
 
+void ANavigationVolume3D::FindPathAsyncWithOptions(
+    const AActor* RequestingActor,
+    const FVector& StartLocation,
+    const FVector& DestinationLocation,
+    const FNavPathQueryOptions& Options,
+    FOnPathfindingComplete OnCompleteCallback)
+{
+    EnqueuePathQuery(RequestingActor, StartLocation, DestinationLocation, Options, OnCompleteCallback, FOnNavPathComplete());
+}
 
-    Async(EAsyncExecution::Thread, [WeakThis, WeakRequestingActor, StartLocation, DestinationLocation, NewSearchID, OnCompleteCallback, ActorName]() {
-        ANavigationVolume3D* StrongThis = WeakThis.Get();
-        if (!StrongThis)
-        {
-            AsyncTask(ENamedThreads::GameThread, [OnCompleteCallback]() {
-                if (OnCompleteCallback.IsBound())
-                {
-                    OnCompleteCallback.ExecuteIfBound(ENavigationVolumeResult::ENVR_VolumeNotReady, TArray<FVector>());
-                }
-            });
+void ANavigationVolume3D::FindPathAsyncNative(
+    const AActor* RequestingActor,
+    const FVector& StartLocation,
+    const FVector& DestinationLocation,
+    const FNavPathQueryOptions& Options,
+    FOnNavPathComplete OnCompleteCallback)
+{
+    EnqueuePathQuery(RequestingActor, StartLocation, DestinationLocation, Options, FOnPathfindingComplete(), MoveTemp(OnCompleteCallback));
+}
+
+void ANavigationVolume3D::EnqueuePathQuery(const AActor* RequestingActor, const FVector& StartLocation, const FVector& DestinationLocation,
+    const FNavPathQueryOptions& Options, FOnPathfindingComplete OnCompleteCallback, FOnNavPathComplete OnNativeCompleteCallback)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::FindPathAsync_Enqueue"));
+    check(IsInGameThread());
+
+    // Only the newest request per actor is worth answering; older ones describe a position it has left.
+    CancelActivePathQuery(RequestingActor);
+
+    FPathQueryRequest Request;
+    Request.RequestId = ++LastPathQueryRequestId;
+    if (Request.RequestId == 0) {
+        Request.RequestId = ++LastPathQueryRequestId;
+    }
+    Request.RequestingActor = RequestingActor;
+    Request.ActorNameForLog = RequestingActor ? RequestingActor->GetName() : TEXT("UnknownActor");
+    Request.StartLocation = StartLocation;
+    Request.DestinationLocation = DestinationLocation;
+    Request.Options = Options;
+    Request.OnCompleteCallback = OnCompleteCallback;
+    Request.OnNativeCompleteCallback = MoveTemp(OnNativeCompleteCallback);
+    Request.Priority = ComputePathQueryPriority(RequestingActor, StartLocation);
+    Request.CacheKey = MakePathQueryKey(StartLocation, DestinationLocation, Options);
+    Request.EnqueueTime = FPlatformTime::Seconds();
+
+    if (RequestingActor) {
+        ActivePathQueryByActor.Add(RequestingActor, Request.RequestId);
+    }
+
+    if (PathCacheCapacity > 0) {
+        const FCachedPathResult* CachedResult = PathCache.FindAndTouch(Request.CacheKey);
+        FNavQueryTelemetry::Get().RecordCacheLookup(CachedResult != nullptr);
+        if (CachedResult) {
+            ++PathCacheHits;
+            // Answered through the completion queue like any other query, so the callback never runs inside this call.
+            FPathQueryCompletion Completion;
+            Completion.RequestId = Request.RequestId;
+            Completion.ResultBundle.ResultCode = CachedResult->ResultCode;
+            Completion.ResultBundle.Path = CachedResult->Path;
+            CompletedPathQueries->Enqueue(MoveTemp(Completion));
+            InFlightPathQueries.Add(Request.RequestId, MoveTemp(Request));
             return;
         }
-        
-        FPathfindingInternalResultBundle ResultBundle = StrongThis->ExecutePathfindingOnThread(
-            WeakThis, WeakRequestingActor, StartLocation, DestinationLocation, NewSearchID
-        );
-        
-        AsyncTask(ENamedThreads::GameThread, [WeakThis, ResultBundle, OnCompleteCallback]() {
-            ANavigationVolume3D* GameThreadStrongThis = WeakThis.Get();
-            if (!GameThreadStrongThis)
-            {
-                if (OnCompleteCallback.IsBound())
-                {
-                    OnCompleteCallback.ExecuteIfBound(ENavigationVolumeResult::ENVR_VolumeNotReady, ResultBundle.PathPoints);
-                }
-                return;
+    }
+
+    // A budgeted query may answer with a partial path, so it neither shares another query's search nor lends its own.
+    const bool bBudgeted = Options.HasSearchBudget();
+    if (bBudgeted && Options.BudgetExhaustedAction != ENavPathBudgetAction::ReturnPartialPath) {
+        Request.SuspendedSearch = MakeShared<FSuspendedPathSearch, ESPMode::ThreadSafe>();
+    }
+
+    const uint32* LeaderId = bBudgeted ? nullptr : PathQueryLeaderByKey.Find(Request.CacheKey);
+    if (LeaderId) {
+        FPathQueryRequest* Leader = PendingPathQueries.Find(*LeaderId);
+        if (Leader) {
+            // A closer follower pulls the shared search forward; the leader's older heap entry is skipped on dispatch.
+            if (Request.Priority < Leader->Priority) {
+                Leader->Priority = Request.Priority;
+                PendingPathQueryHeap.HeapPush(FPathQueryQueueEntry{Leader->Priority, Leader->RequestId});
             }
+        } else {
+            Leader = InFlightPathQueries.Find(*LeaderId);
+        }
+        if (Leader) {
+            ++PathQueriesCoalesced;
+            Leader->CoalescedRequestIds.Add(Request.RequestId);
+            CoalescedPathQueries.Add(Request.RequestId, MoveTemp(Request));
+            return;
+        }
+    }
+
+    ++PathCacheMisses;
+    if (!bBudgeted) {
+        PathQueryLeaderByKey.Add(Request.CacheKey, Request.RequestId);
+    }
+    PendingPathQueryHeap.HeapPush(FPathQueryQueueEntry{Request.Priority, Request.RequestId});
+    PendingPathQueries.Add(Request.RequestId, MoveTemp(Request));
+}
+
+void ANavigationVolume3D::FindPathsBatch(
+    const AActor* RequestingActor,
+    const TArray<FNavPathBatchQuery>& Queries,
+    const FNavPathQueryOptions& Options,
+    FOnPathBatchComplete OnCompleteCallback)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::FindPathsBatch_Enqueue"));
+    check(IsInGameThread());
+
+    CancelActivePathQuery(RequestingActor);
+
+    FPathQueryRequest Request;
+    Request.RequestId = ++LastPathQueryRequestId;
+    if (Request.RequestId == 0) {
+        Request.RequestId = ++LastPathQueryRequestId;
+    }
+    Request.RequestingActor = RequestingActor;
+    Request.ActorNameForLog = RequestingActor ? RequestingActor->GetName() : TEXT("UnknownActor");
+    Request.Options = Options;
+    Request.bIsBatch = true;
+    Request.BatchQueries = Queries;
+    Request.OnBatchCompleteCallback = OnCompleteCallback;
+    Request.CacheKey.MinClearance = GetRequiredClearance(Options);
+    Request.CacheKey.NavDataVersion = NavDataVersion;
+    Request.EnqueueTime = FPlatformTime::Seconds();
+
+    if (RequestingActor) {
+        ActivePathQueryByActor.Add(RequestingActor, Request.RequestId);
+    }
+
+    // Nothing to search; still answered from the next tick so the callback never runs inside this call.
+    if (Queries.IsEmpty()) {
+        FPathQueryCompletion Completion;
+        Completion.RequestId = Request.RequestId;
+        Completion.ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_Success;
+        CompletedPathQueries->Enqueue(MoveTemp(Completion));
+        InFlightPathQueries.Add(Request.RequestId, MoveTemp(Request));
+        return;
+    }
+
+    Request.Priority = TNumericLimits<float>::Max();
+    for (const FNavPathBatchQuery& Query : Queries) {
+        Request.Priority = FMath::Min(Request.Priority, ComputePathQueryPriority(RequestingActor, Query.StartLocation));
+    }
+
+    PendingPathQueryHeap.HeapPush(FPathQueryQueueEntry{Request.Priority, Request.RequestId});
+    PendingPathQueries.Add(Request.RequestId, MoveTemp(Request));
+}
+
+bool ANavigationVolume3D::Raycast(const FVector& Start, const FVector& End, FNavGridRaycastResult& OutResult) const
+{
+    return SweepSphere(Start, End, 0.0f, OutResult);
+}
 
-            if (OnCompleteCallback.IsBound())
-            {
-                OnCompleteCallback.ExecuteIfBound(ResultBundle.ResultCode, ResultBundle.PathPoints);
-            }
-            
-            if (ResultBundle.bShouldDrawThisPathAndExploration_TaskLocal)
-            {
-                UWorld* World = GameThreadStrongThis->GetWorld();
-                if (World)
-                {
-                    GameThreadStrongThis->FlushCollectedDebugDraws(
-                        World, 
-                        GameThreadStrongThis->DebugDrawLifetime * (ResultBundle.bIsLongPath_TaskLocal ? 2.0f : 1.0f), 
-                        ResultBundle.DebugSpheresToDraw_TaskLocal, 
-                        ResultBundle.DebugLinesToDraw_TaskLocal,
-                        ResultBundle.bIsLongPath_TaskLocal
-                    );
+bool ANavigationVolume3D::SweepSphere(const FVector& Start, const FVector& End, float Radius, FNavGridRaycastResult& OutResult) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::SweepSphere"));
+
+    OutResult = FNavGridRaycastResult();
+    if (!IsNavigationDataReady() || DivisionSize < KINDA_SMALL_NUMBER) {
+        OutResult.bBlocked = true;
+        OutResult.Location = Start;
+        OutResult.Time = 0.0f;
+        return true;
+    }
+
+    const uint8 MinClearance = GetClearanceForRadius(Radius);
+    // The octree keeps no clearance, so a sphere there checks the whole cube of cells the clearance would cover.
+    const int32 OctreeReach = NavigationBackend == ENavigationVolumeBackend::SparseOctree ? MinClearance - 1 : 0;
+    auto IsCellFree = [this, MinClearance, OctreeReach](const FIntVector& Cell) {
+        if (OctreeReach == 0) {
+            return IsCellFreeForAgent(Cell, MinClearance);
+        }
+        for (int32 DZ = -OctreeReach; DZ <= OctreeReach; ++DZ) {
+            for (int32 DY = -OctreeReach; DY <= OctreeReach; ++DY) {
+                for (int32 DX = -OctreeReach; DX <= OctreeReach; ++DX) {
+                    const FIntVector Neighbor = Cell + FIntVector(DX, DY, DZ);
+                    // Like the grid's clearance, the outside of the volume is not an obstacle for the sphere's edge.
+                    if (AreCoordinatesValid(Neighbor) && !IsCellTraversable(Neighbor)) {
+                        return false;
+                    }
                 }
             }
-            
-            if (ResultBundle.bIsLongPath_TaskLocal && GameThreadStrongThis->bDrawPathfindingDebug && GameThreadStrongThis->bPauseOnLongPath)
-            {
-                 UWorld* World = GameThreadStrongThis->GetWorld();
-                 if (World) {
-                    UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D (%s): Game PAUSED due to long path (%d steps). Actor: %s"), 
-                        *GameThreadStrongThis->GetName(), ResultBundle.PathPoints.Num(), *ResultBundle.ActorNameForLog);
-                    UGameplayStatics::SetGamePaused(World, true);
-                 }
-            }
-        });
-    });
+        }
+        return AreCoordinatesValid(Cell);
+    };
+
+    const FTransform& VolumeTransform = GetActorTransform();
+    const FVector From = VolumeTransform.InverseTransformPosition(Start) / DivisionSize;
+    const FVector To = VolumeTransform.InverseTransformPosition(End) / DivisionSize;
+    double HitTime = 1.0;
+    OutResult.bBlocked = FindNavLineOfSightBlock(From, To, IsCellFree, HitTime);
+    OutResult.Time = static_cast<float>(HitTime);
+    OutResult.Location = OutResult.bBlocked ? FMath::Lerp(Start, End, HitTime) : End;
+    return OutResult.bBlocked;
 }
 
-ANavigationVolume3D::FPathfindingInternalResultBundle ANavigationVolume3D::ExecutePathfindingOnThread(
-    TWeakObjectPtr<ANavigationVolume3D> WeakThisForConstAccess,
-    TWeakObjectPtr<const AActor> WeakRequestingActor,
-    const FVector& StartLocation,
-    const FVector& DestinationLocation,
-    uint32_t PathSearchID)
+void ANavigationVolume3D::RaycastBatch(const TArray<FNavGridRaycastQuery>& Queries, TArray<FNavGridRaycastResult>& OutResults) const
 {
-    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_Total"));
-    
-    const AActor* RequestingActorPtr = WeakRequestingActor.Get();
-    FString ActorNameForLogging = RequestingActorPtr ? RequestingActorPtr->GetName() : TEXT("UnknownOrInvalidActor");
-    FPathfindingInternalResultBundle ResultBundle(ActorNameForLogging);
-    
-    if (!bNodesInitializedAndFinalized || Nodes.IsEmpty()) {
-        UE_LOG(LogTemp, Error, TEXT("ANavigationVolume3D::ExecutePathfindingOnThread - Nodes not initialized or empty. Actor: %s"), *ActorNameForLogging);
-        ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_VolumeNotReady;
-        return ResultBundle;
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::RaycastBatch"));
+
+    // Below this, handing work to other threads costs more than the casts.
+    constexpr int32 MinParallelQueries = 64;
+    OutResults.SetNum(Queries.Num());
+    ParallelFor(Queries.Num(), [this, &Queries, &OutResults](int32 QueryIndex) {
+        const FNavGridRaycastQuery& Query = Queries[QueryIndex];
+        SweepSphere(Query.Start, Query.End, Query.Radius, OutResults[QueryIndex]);
+    }, Queries.Num() < MinParallelQueries ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+}
+
+void ANavigationVolume3D::GetPathCacheStats(int32& OutHits, int32& OutMisses, int32& OutCoalesced) const
+{
+    OutHits = PathCacheHits;
+    OutMisses = PathCacheMisses;
+    OutCoalesced = PathQueriesCoalesced;
+}
+
+void ANavigationVolume3D::GetLandmarkStats(int32& OutNumLandmarks, int64& OutTableBytes) const
+{
+    OutNumLandmarks = Landmarks.Num();
+    OutTableBytes = static_cast<int64>(Landmarks.GetAllocatedSize());
+}
+
+ANavigationVolume3D::FPathQueryKey ANavigationVolume3D::MakePathQueryKey(const FVector& StartLocation, const FVector& DestinationLocation, const FNavPathQueryOptions& Options) const
+{
+    // Both backends start from the clamped cell under each endpoint and return cell-based points, so two
+    // queries with the same cells and effective options produce the same path.
+    auto ToCellIndex = [this](const FVector& Location) {
+        const FIntVector Coordinates = ConvertLocationToCoordinates(Location);
+        return (Coordinates.Z * DivisionsY + Coordinates.Y) * DivisionsX + Coordinates.X;
+    };
+
+    FPathQueryKey Key;
+    Key.StartCell = ToCellIndex(StartLocation);
+    Key.GoalCell = ToCellIndex(DestinationLocation);
+    Key.SearchAlgorithm = Options.SearchAlgorithm == ENavPathSearchAlgorithm::VolumeDefault ? DefaultSearchAlgorithm : Options.SearchAlgorithm;
+    Key.Smoothing = Options.Smoothing == ENavPathSmoothing::VolumeDefault ? DefaultPathSmoothing : Options.Smoothing;
+    Key.MinClearance = GetRequiredClearance(Options);
+    Key.ResolutionLayer = static_cast<uint8>(SelectResolutionLayer(Options));
+    Key.NavDataVersion = NavDataVersion;
+    return Key;
+}
+
+void ANavigationVolume3D::ReleasePathQueryLeader(const FPathQueryRequest& Request)
+{
+    const uint32* LeaderId = PathQueryLeaderByKey.Find(Request.CacheKey);
+    if (LeaderId && *LeaderId == Request.RequestId) {
+        PathQueryLeaderByKey.Remove(Request.CacheKey);
     }
+}
 
-    const uint32_t MySearchID = PathSearchID;
-    
-    if (MySearchID == 0) {
-        UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D::ExecutePathfindingOnThread - SearchID is 0. This is unexpected. Resetting all node SearchIDs. Actor: %s"), *ActorNameForLogging);
-        for (NavNode& Node : Nodes) {
-            Node.SearchID_Pathfinding = 0;
+void ANavigationVolume3D::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
 
-            Node.FScore_Pathfinding = std::numeric_limits<float>::max();
-            Node.GScore_Pathfinding = std::numeric_limits<float>::max();
-            Node.CameFrom_Pathfinding = nullptr;
-        }
+    if (PendingTraversabilityBake.IsValid() && PendingTraversabilityBake.IsReady()) {
+        PendingTraversabilityBake.Reset();
+        FinishNavigationBuild();
     }
 
+    if (!PendingDirtyRegions.IsEmpty() || PendingTraversabilityUpdate.IsValid()) {
+        UpdateDirtyRegions();
+    }
 
-    NavNode* StartNodePtr = nullptr;
-    NavNode* EndNodePtr   = nullptr;
+    if (!FlowFieldTargets.IsEmpty() || !OrphanedFlowFieldBuilds.IsEmpty()) {
+        UpdateFlowFields();
+    }
 
-    {
-        TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_NodeConversionAndValidation"));
-        StartNodePtr = GetNode(ConvertLocationToCoordinates(StartLocation));
-        EndNodePtr   = GetNode(ConvertLocationToCoordinates(DestinationLocation));
+    FNavQueryTelemetry::Get().RecordQueueState(PendingPathQueries.Num(), InFlightPathQueries.Num());
+    FNavQueryTelemetry::Get().Tick();
 
-        if (!StartNodePtr) { 
-            UE_LOG(LogTemp, Warning, TEXT("ExecutePathfindingOnThread: StartNodePtr is null. Actor: %s, StartLoc: %s"), *ActorNameForLogging, *StartLocation.ToString());
-            ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_StartNodeInvalid; return ResultBundle;
+    if (PendingPathQueries.IsEmpty()) {
+        PendingPathQueryHeap.Reset(); // Only superseded entries can be left.
+    }
+    if (PendingPathQueries.IsEmpty() && InFlightPathQueries.IsEmpty()) {
+        return;
+    }
+
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::Tick_PathQueries"));
+    const double BudgetEndTime = FPlatformTime::Seconds() + PathQueryFrameBudgetMs / 1000.0;
+    ProcessCompletedPathQueries(BudgetEndTime);
+    DispatchPendingPathQueries(BudgetEndTime);
+}
+
+void ANavigationVolume3D::MarkRegionDirty(const FBox& WorldBox)
+{
+    check(IsInGameThread());
+    if (!IsNavigationDataReady() || !WorldBox.IsValid) {
+        return;
+    }
+    if (NavigationBackend != ENavigationVolumeBackend::DenseGrid) {
+        UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D (%s): Dirty regions need the dense grid backend. Ignoring %s."), *GetName(), *WorldBox.ToString());
+        return;
+    }
+
+    const FBox LocalBox = WorldBox.InverseTransformBy(GetActorTransform());
+    const FBox GridBox(FVector::ZeroVector, FVector(DivisionsX, DivisionsY, DivisionsZ) * DivisionSize);
+    if (!LocalBox.Intersect(GridBox)) {
+        return;
+    }
+
+    FNavGridRegion Region;
+    Region.Min = FIntVector(FMath::FloorToInt(LocalBox.Min.X / DivisionSize), FMath::FloorToInt(LocalBox.Min.Y / DivisionSize), FMath::FloorToInt(LocalBox.Min.Z / DivisionSize));
+    Region.Max = FIntVector(FMath::FloorToInt(LocalBox.Max.X / DivisionSize), FMath::FloorToInt(LocalBox.Max.Y / DivisionSize), FMath::FloorToInt(LocalBox.Max.Z / DivisionSize));
+    ClampCoordinates(Region.Min);
+    ClampCoordinates(Region.Max);
+    PendingDirtyRegions.Add(Region);
+}
+
+void ANavigationVolume3D::UpdateDirtyRegions()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::UpdateDirtyRegions"));
+
+    if (PendingTraversabilityUpdate.IsValid()) {
+        if (!PendingTraversabilityUpdate.IsReady()) {
+            return;
         }
-        if (!EndNodePtr) {
-            UE_LOG(LogTemp, Warning, TEXT("ExecutePathfindingOnThread: EndNodePtr is null. Actor: %s, DestLoc: %s"), *ActorNameForLogging, *DestinationLocation.ToString());
-            ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_EndNodeInvalid; return ResultBundle;
+        // Searches and flow field builds read the grid without locks, so changes wait until none is running.
+        if (!PendingTraversabilityUpdate.Get().ChangedCells.IsEmpty()) {
+            if (!AreNavigationReadersIdle()) {
+                return;
+            }
+            ApplyTraversabilityUpdate(PendingTraversabilityUpdate.Get());
         }
+        PendingTraversabilityUpdate.Reset();
+    }
 
-        auto ResolveBlockedNode = [&](NavNode*& NodeToResolve, const FVector& OriginalWorldLocation, bool bIsStartNode) -> ENavigationVolumeResult {
-            if (NodeToResolve->SearchID_Pathfinding != MySearchID) {
-                NodeToResolve->SearchID_Pathfinding = MySearchID;
-                NodeToResolve->GScore_Pathfinding = std::numeric_limits<float>::max();
-                NodeToResolve->FScore_Pathfinding = std::numeric_limits<float>::max();
-                NodeToResolve->CameFrom_Pathfinding = nullptr;
-            }
+    if (PendingDirtyRegions.IsEmpty() || !IsNavigationDataReady()) {
+        return;
+    }
 
-            if (!NodeToResolve->bIsTraversable) {
-                TRACE_CPUPROFILER_EVENT_SCOPE_TEXT(bIsStartNode ? TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_ResolveBlockedStart") : TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_ResolveBlockedEnd"));
-                float SearchRadius = 300.f; FVector FoundLocation;
-                if (this->FindRandomValidLocationInRadius(OriginalWorldLocation, SearchRadius, FoundLocation, RequestingActorPtr)) {
-                    NodeToResolve = GetNode(ConvertLocationToCoordinates(FoundLocation));
-                    if (!NodeToResolve) { 
-                        UE_LOG(LogTemp, Warning, TEXT("ExecutePathfindingOnThread: ResolveBlockedNode found location but GetNode returned null. Actor: %s"), *ActorNameForLogging);
-                        return bIsStartNode ? ENavigationVolumeResult::ENVR_StartNodeBlocked : ENavigationVolumeResult::ENVR_EndNodeBlocked;
+    // EndPlay waits for the evaluation before the grid goes away. The grid is only read here; changes are
+    // applied on the game thread.
+    PendingTraversabilityUpdate = Async(EAsyncExecution::ThreadPool, [this, Regions = MoveTemp(PendingDirtyRegions)]() {
+        TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::UpdateDirtyRegions_Evaluate"));
+        FNavTraversabilityUpdate Update;
+        Update.Regions = Regions;
+
+        TSet<int32> EvaluatedCells;
+        for (const FNavGridRegion& Region : Regions) {
+            for (int32 Z = Region.Min.Z; Z <= Region.Max.Z; ++Z) {
+                for (int32 Y = Region.Min.Y; Y <= Region.Max.Y; ++Y) {
+                    for (int32 X = Region.Min.X; X <= Region.Max.X; ++X) {
+                        const FIntVector Coordinates(X, Y, Z);
+                        const int32 CellIndex = Grid.ToIndex(Coordinates);
+                        bool bAlreadyEvaluated = false;
+                        EvaluatedCells.Add(CellIndex, &bAlreadyEvaluated);
+                        if (!bAlreadyEvaluated && Grid.IsTraversable(CellIndex) == IsCellBlockedByObstacles(Coordinates)) {
+                            Update.ChangedCells.Add(CellIndex);
+                        }
                     }
-                    NodeToResolve->SearchID_Pathfinding = MySearchID;
-                    NodeToResolve->GScore_Pathfinding = std::numeric_limits<float>::max();
-                    NodeToResolve->FScore_Pathfinding = std::numeric_limits<float>::max();
-                    NodeToResolve->CameFrom_Pathfinding = nullptr;
-
-                    if (!NodeToResolve->bIsTraversable) return bIsStartNode ? ENavigationVolumeResult::ENVR_StartNodeBlocked : ENavigationVolumeResult::ENVR_EndNodeBlocked;
-                } else { return bIsStartNode ? ENavigationVolumeResult::ENVR_StartNodeBlocked : ENavigationVolumeResult::ENVR_EndNodeBlocked; }
+                }
             }
-            return ENavigationVolumeResult::ENVR_Success;
-        };
-
-        ENavigationVolumeResult StartResolveResult = ResolveBlockedNode(StartNodePtr, StartLocation, true);
-        if(StartResolveResult != ENavigationVolumeResult::ENVR_Success) { ResultBundle.ResultCode = StartResolveResult; return ResultBundle; }
-        
-        ENavigationVolumeResult EndResolveResult = ResolveBlockedNode(EndNodePtr, DestinationLocation, false);
-        if(EndResolveResult != ENavigationVolumeResult::ENVR_Success) { ResultBundle.ResultCode = EndResolveResult; return ResultBundle; }
-        
-        if (bDrawPathfindingDebug) {
-            AddDebugSphere_TaskLocal(ResultBundle.DebugSpheresToDraw_TaskLocal, ConvertCoordinatesToLocation(StartNodePtr->Coordinates), DebugNodeSphereRadius * 1.5f, FColor::Cyan, 12);
-            AddDebugSphere_TaskLocal(ResultBundle.DebugSpheresToDraw_TaskLocal, ConvertCoordinatesToLocation(EndNodePtr->Coordinates), DebugNodeSphereRadius * 1.5f, FColor::Magenta, 12);
         }
-        
-        if (StartNodePtr == EndNodePtr) { 
-            TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_PathToSelf"));
-            ResultBundle.PathPoints.Add(ConvertCoordinatesToLocation(StartNodePtr->Coordinates));
-            UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D::ExecutePathfindingOnThread - Path to self found. Actor: %s. Path steps: %d"), *ActorNameForLogging, ResultBundle.PathPoints.Num());
-            
-            ResultBundle.bIsLongPath_TaskLocal = ResultBundle.PathPoints.Num() > LongPathThreshold;
-            ResultBundle.bShouldDrawThisPathAndExploration_TaskLocal = bDrawPathfindingDebug && (ResultBundle.bIsLongPath_TaskLocal || !bOnlyDrawDebugForLongPaths);
-            
-            ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_PathToSelf;
-            return ResultBundle;
+        return Update;
+    });
+    PendingDirtyRegions.Reset();
+}
+
+bool ANavigationVolume3D::IsTraversabilityUpdateWaiting() const
+{
+    return PendingTraversabilityUpdate.IsValid() && PendingTraversabilityUpdate.IsReady();
+}
+
+bool ANavigationVolume3D::AreNavigationReadersIdle() const
+{
+    for (const TPair<uint32, FPathQueryRequest>& InFlight : InFlightPathQueries) {
+        if (InFlight.Value.WorkerFuture.IsValid() && !InFlight.Value.WorkerFuture.IsReady()) {
+            return false;
+        }
+    }
+    for (const TPair<TWeakObjectPtr<const AActor>, FFlowFieldTarget>& Target : FlowFieldTargets) {
+        if (Target.Value.PendingBuild.IsValid() && !Target.Value.PendingBuild.IsReady()) {
+            return false;
+        }
+    }
+    for (const TFuture<FNavFlowFieldPtr>& Build : OrphanedFlowFieldBuilds) {
+        if (!Build.IsReady()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ANavigationVolume3D::ApplyTraversabilityUpdate(const FNavTraversabilityUpdate& Update)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ApplyTraversabilityUpdate"));
+
+    for (const int32 CellIndex : Update.ChangedCells) {
+        Grid.SetTraversable(CellIndex, !Grid.IsTraversable(CellIndex));
+    }
+    for (const FNavGridRegion& Region : Update.Regions) {
+        Grid.RebuildNeighborMasks(Region);
+        Grid.RebuildClearance(Region);
+    }
+    // Blocked-cell ranks shift with any flip, so the nearest-traversable table is rebuilt as a whole.
+    if (Update.ChangedCells.Num() > 0) {
+        Grid.RebuildNearestTraversable();
+        TraversableBricks.Build(Grid);
+        GridLayers.UpdateRegions(Grid, Update.Regions);
+    }
+    // Landmark distances only ever underestimate once cells close; a freed cell can shorten paths below them.
+    if (!Landmarks.IsEmpty() && Update.ChangedCells.ContainsByPredicate([this](int32 CellIndex) { return Grid.IsTraversable(CellIndex); })) {
+        Landmarks.Empty();
+        UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): Cells were freed; landmark heuristic disabled until the next navigation build."), *GetName());
+    }
+    if (!ClusterHierarchy.IsEmpty()) {
+        ClusterHierarchy.UpdateRegions(Grid, Update.Regions, SearchContextPool);
+    }
+
+    // Every cached result and every search still running or queued on the old data now has a stale key.
+    ++NavDataVersion;
+    PathCache.Empty(PathCacheCapacity);
+
+    UpdateNavigationDataMemoryStat();
+
+    UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): %d cells changed traversability in %d dirty regions."),
+        *GetName(), Update.ChangedCells.Num(), Update.Regions.Num());
+}
+
+bool ANavigationVolume3D::IsPathStillClear(const TArray<FVector>& PathPoints, uint8 MinClearance) const
+{
+    const FTransform& VolumeTransform = GetActorTransform();
+    auto IsCellFree = [this, MinClearance](const FIntVector& Cell) { return IsCellFreeForAgent(Cell, MinClearance); };
+    for (int32 PointIndex = 1; PointIndex < PathPoints.Num(); ++PointIndex) {
+        const FVector From = VolumeTransform.InverseTransformPosition(PathPoints[PointIndex - 1]) / DivisionSize;
+        const FVector To = VolumeTransform.InverseTransformPosition(PathPoints[PointIndex]) / DivisionSize;
+        if (!HasNavLineOfSight(From, To, IsCellFree)) {
+            return false;
+        }
+    }
+    return PathPoints.Num() != 1 || IsCellFree(ConvertLocationToCoordinates(PathPoints[0]));
+}
+
+void ANavigationVolume3D::RegisterFlowFieldTarget(const AActor* Target)
+{
+    check(IsInGameThread());
+    if (!Target) {
+        return;
+    }
+    if (NavigationBackend != ENavigationVolumeBackend::DenseGrid) {
+        UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D (%s): Flow fields need the dense grid backend. Ignoring target %s."), *GetName(), *Target->GetName());
+        return;
+    }
+    FlowFieldTargets.FindOrAdd(Target);
+}
+
+void ANavigationVolume3D::UnregisterFlowFieldTarget(const AActor* Target)
+{
+    check(IsInGameThread());
+    FFlowFieldTarget* Entry = FlowFieldTargets.Find(Target);
+    if (!Entry) {
+        return;
+    }
+    // An in-flight build is left to finish; its result is simply dropped.
+    if (Entry->PendingBuild.IsValid()) {
+        OrphanedFlowFieldBuilds.Add(MoveTemp(Entry->PendingBuild));
+    }
+    FlowFieldTargets.Remove(Target);
+}
+
+bool ANavigationVolume3D::GetFlowFieldNextLocation(const AActor* Target, const FVector& Location, FVector& OutNextLocation) const
+{
+    const FFlowFieldTarget* Entry = FlowFieldTargets.Find(Target);
+    if (!Entry || !Entry->Field.IsValid() || !IsNavigationDataReady()) {
+        return false;
+    }
+
+    const FIntVector Coordinates = ConvertLocationToCoordinates(Location);
+    const int32 CellIndex = Grid.ToIndex(Coordinates);
+    if (!Entry->Field->IsReachable(CellIndex)) {
+        return false;
+    }
+
+    const int32 Direction = Entry->Field->GetNextDirection(CellIndex);
+    OutNextLocation = ConvertCoordinatesToLocation(Direction == INDEX_NONE ? Coordinates : Coordinates + FNavGrid::GetDirection(Direction));
+    return true;
+}
+
+void ANavigationVolume3D::UpdateFlowFields()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::UpdateFlowFields"));
+    if (!IsNavigationDataReady()) {
+        return;
+    }
+
+    OrphanedFlowFieldBuilds.RemoveAll([](const TFuture<FNavFlowFieldPtr>& Build) { return Build.IsReady(); });
+
+    for (auto It = FlowFieldTargets.CreateIterator(); It; ++It) {
+        FFlowFieldTarget& Entry = It.Value();
+
+        if (Entry.PendingBuild.IsValid()) {
+            if (!Entry.PendingBuild.IsReady()) {
+                continue;
+            }
+            if (FNavFlowFieldPtr Finished = Entry.PendingBuild.Get()) {
+                Entry.Field = MoveTemp(Finished);
+            }
+            Entry.PendingBuild.Reset();
+        }
+
+        const AActor* Target = It.Key().Get();
+        if (!Target) {
+            It.RemoveCurrent();
+            continue;
+        }
+        if (IsTraversabilityUpdateWaiting()) {
+            continue;
+        }
+
+        // One build per target at a time: a target that keeps moving is rebuilt as often as builds complete.
+        const int32 GoalIndex = ResolveFlowFieldGoalIndex(Target);
+        if (GoalIndex == INDEX_NONE || (Entry.Field.IsValid() && Entry.Field->GetGoalIndex() == GoalIndex && Entry.BuildNavDataVersion == NavDataVersion)) {
+            continue;
+        }
+
+        const TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> CancelFlag = bCancelFlowFieldBuilds;
+        Entry.BuildNavDataVersion = NavDataVersion;
+        // EndPlay waits for pending builds before the grid goes away (see CancelFlowFieldBuilds).
+        Entry.PendingBuild = Async(EAsyncExecution::ThreadPool, [this, GoalIndex, CancelFlag]() -> FNavFlowFieldPtr {
+            TSharedRef<FNavFlowField, ESPMode::ThreadSafe> NewField = MakeShared<FNavFlowField, ESPMode::ThreadSafe>();
+            FScopedNavSearchContext ScopedSearchContext(SearchContextPool, Grid.Num());
+            if (!NewField->Build(Grid, GoalIndex, ScopedSearchContext.Get(), &CancelFlag.Get())) {
+                return nullptr;
+            }
+            return NewField;
+        });
+    }
+}
+
+int32 ANavigationVolume3D::ResolveFlowFieldGoalIndex(const AActor* Target) const
+{
+    const FVector TargetLocation = Target->GetActorLocation();
+    const FIntVector GoalCoordinates = ConvertLocationToCoordinates(TargetLocation);
+    // Targets standing on or inside geometry use the nearest free cell, like blocked path endpoints.
+    return ResolveBlockedCell(GoalCoordinates, TargetLocation);
+}
+
+void ANavigationVolume3D::CancelFlowFieldBuilds()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::CancelFlowFieldBuilds"));
+
+    bCancelFlowFieldBuilds->store(true, std::memory_order_relaxed);
+    for (TPair<TWeakObjectPtr<const AActor>, FFlowFieldTarget>& Entry : FlowFieldTargets) {
+        if (Entry.Value.PendingBuild.IsValid()) {
+            Entry.Value.PendingBuild.Wait();
+        }
+    }
+    for (TFuture<FNavFlowFieldPtr>& Build : OrphanedFlowFieldBuilds) {
+        Build.Wait();
+    }
+    FlowFieldTargets.Empty();
+    OrphanedFlowFieldBuilds.Empty();
+    bCancelFlowFieldBuilds = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+}
+
+float ANavigationVolume3D::ComputePathQueryPriority(const AActor* RequestingActor, const FVector& StartLocation) const
+{
+    const APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(this, 0);
+    if (!PlayerPawn) {
+        return 0.0f;
+    }
+
+    const FVector RequesterLocation = RequestingActor ? RequestingActor->GetActorLocation() : StartLocation;
+    return FVector::DistSquared(RequesterLocation, PlayerPawn->GetActorLocation());
+}
+
+void ANavigationVolume3D::CancelActivePathQuery(const AActor* RequestingActor)
+{
+    if (!RequestingActor) {
+        return;
+    }
+
+    uint32 ActiveRequestId = 0;
+    if (!ActivePathQueryByActor.RemoveAndCopyValue(RequestingActor, ActiveRequestId)) {
+        return;
+    }
+
+    // A follower just detaches; its leader skips ids it can no longer find.
+    FPathQueryRequest Follower;
+    if (CoalescedPathQueries.RemoveAndCopyValue(ActiveRequestId, Follower)) {
+        RecordPathQueryTelemetry(Follower.EnqueueTime, ENavigationVolumeResult::ENVR_Cancelled);
+        return;
+    }
+
+    auto HasLiveFollowers = [this](const FPathQueryRequest& Leader) {
+        for (const uint32 FollowerId : Leader.CoalescedRequestIds) {
+            if (CoalescedPathQueries.Contains(FollowerId)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // Pending entries are dropped here and their heap entries skipped lazily on dispatch.
+    if (FPathQueryRequest* Pending = PendingPathQueries.Find(ActiveRequestId)) {
+        if (HasLiveFollowers(*Pending)) {
+            Pending->bSuperseded = true;
+        } else {
+            ReleasePathQueryLeader(*Pending);
+            RecordPathQueryTelemetry(Pending->EnqueueTime, ENavigationVolumeResult::ENVR_Cancelled);
+            PendingPathQueries.Remove(ActiveRequestId);
+        }
+        return;
+    }
+    if (FPathQueryRequest* InFlight = InFlightPathQueries.Find(ActiveRequestId)) {
+        if (HasLiveFollowers(*InFlight)) {
+            InFlight->bSuperseded = true;
+        } else {
+            ReleasePathQueryLeader(*InFlight);
+            InFlight->bCancelled->store(true, std::memory_order_relaxed);
+        }
+    }
+}
+
+void ANavigationVolume3D::DispatchPendingPathQueries(double BudgetEndTime)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::DispatchPendingPathQueries"));
+
+    if (IsTraversabilityUpdateWaiting()) {
+        return;
+    }
+
+    int32 NumDispatched = 0;
+    while (PendingPathQueryHeap.Num() > 0 && InFlightPathQueries.Num() < MaxConcurrentPathQueries)
+    {
+        if (NumDispatched > 0 && FPlatformTime::Seconds() > BudgetEndTime) {
+            break;
+        }
+
+        FPathQueryQueueEntry Entry;
+        PendingPathQueryHeap.HeapPop(Entry, TLess<FPathQueryQueueEntry>(), EAllowShrinking::No);
+
+        FPathQueryRequest Request;
+        if (!PendingPathQueries.RemoveAndCopyValue(Entry.RequestId, Request)) {
+            continue; // Superseded while queued.
+        }
+
+        FPathQueryRequest& InFlight = InFlightPathQueries.Add(Request.RequestId, MoveTemp(Request));
+        LaunchPathQuery(InFlight);
+        ++NumDispatched;
+    }
+}
+
+void ANavigationVolume3D::LaunchPathQuery(FPathQueryRequest& Request)
+{
+    const uint32 RequestId = Request.RequestId;
+    const TWeakObjectPtr<const AActor> WeakRequestingActor = Request.RequestingActor;
+    const FString ActorName = Request.ActorNameForLog;
+    const FVector StartLocation = Request.StartLocation;
+    const FVector DestinationLocation = Request.DestinationLocation;
+    const FNavPathQueryOptions Options = Request.Options;
+    const TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> CancelFlag = Request.bCancelled;
+    const TSharedRef<FPathQueryCompletionQueue, ESPMode::ThreadSafe> CompletionQueue = CompletedPathQueries;
+    const TSharedPtr<FSuspendedPathSearch, ESPMode::ThreadSafe> SuspendedSearch = Request.SuspendedSearch;
+    const bool bIsBatch = Request.bIsBatch;
+    const TArray<FNavPathBatchQuery> BatchQueries = Request.BatchQueries;
+
+    // Runs on the engine's fixed-size thread pool. EndPlay waits for every in-flight query before
+    // the node data goes away, so capturing 'this' is safe for the lifetime of the task.
+    Request.WorkerFuture = Async(EAsyncExecution::ThreadPool, [this, RequestId, WeakRequestingActor, ActorName, StartLocation, DestinationLocation, Options, CancelFlag, CompletionQueue, SuspendedSearch, bIsBatch, BatchQueries]() {
+        FPathQueryCompletion Completion;
+        Completion.RequestId = RequestId;
+        if (CancelFlag->load(std::memory_order_relaxed)) {
+            Completion.ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_Cancelled;
+        } else if (bIsBatch) {
+            // Back to back on this worker, so each search picks up the scratch context the previous one pooled.
+            TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::LaunchPathQuery_Batch"));
+            Completion.ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_Success;
+            Completion.BatchResultBundles.Reserve(BatchQueries.Num());
+            for (const FNavPathBatchQuery& Query : BatchQueries) {
+                if (CancelFlag->load(std::memory_order_relaxed)) {
+                    Completion.ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_Cancelled;
+                    break;
+                }
+                Completion.BatchResultBundles.Add(ExecutePathfindingOnThread(WeakRequestingActor, ActorName, Query.StartLocation, Query.DestinationLocation, Options, &CancelFlag.Get()));
+            }
+        } else {
+            Completion.ResultBundle = ExecutePathfindingOnThread(WeakRequestingActor, ActorName, StartLocation, DestinationLocation, Options, &CancelFlag.Get(), SuspendedSearch.Get());
+        }
+        CompletionQueue->Enqueue(MoveTemp(Completion));
+    });
+}
+
+void ANavigationVolume3D::ProcessCompletedPathQueries(double BudgetEndTime)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ProcessCompletedPathQueries"));
+
+    int32 NumDelivered = 0;
+    FPathQueryCompletion Completion;
+    while (!(NumDelivered > 0 && FPlatformTime::Seconds() > BudgetEndTime) && CompletedPathQueries->Dequeue(Completion))
+    {
+        FPathQueryRequest* Request = InFlightPathQueries.Find(Completion.RequestId);
+        if (!Request) {
+            continue;
+        }
+
+        // Answered from navigation data that has changed since: still fine if the path stays clear, otherwise
+        // searched again. A batch runs again as a whole if any of its answers went stale.
+        const ENavigationVolumeResult ResultCode = Completion.ResultBundle.ResultCode;
+        bool bStaleResult = false;
+        if (Request->CacheKey.NavDataVersion != NavDataVersion && !Request->bCancelled->load(std::memory_order_relaxed)) {
+            bStaleResult = Request->bIsBatch
+                ? Completion.BatchResultBundles.ContainsByPredicate([this, Request](const FPathfindingInternalResultBundle& Bundle) { return IsStalePathResult(Bundle, Request->CacheKey.MinClearance); })
+                : IsStalePathResult(Completion.ResultBundle, Request->CacheKey.MinClearance);
+        }
+        if (bStaleResult && Request->bIsBatch) {
+            FPathQueryRequest Retry;
+            InFlightPathQueries.RemoveAndCopyValue(Completion.RequestId, Retry);
+            Retry.WorkerFuture.Reset();
+            Retry.CacheKey.NavDataVersion = NavDataVersion;
+            PendingPathQueryHeap.HeapPush(FPathQueryQueueEntry{Retry.Priority, Retry.RequestId});
+            PendingPathQueries.Add(Retry.RequestId, MoveTemp(Retry));
+            continue;
         }
+        if (bStaleResult) {
+            ReleasePathQueryLeader(*Request);
+            FPathQueryRequest Retry;
+            InFlightPathQueries.RemoveAndCopyValue(Completion.RequestId, Retry);
+            Retry.WorkerFuture.Reset();
+            Retry.CacheKey = MakePathQueryKey(Retry.StartLocation, Retry.DestinationLocation, Retry.Options);
+            // As in EnqueuePathQuery, a budgeted query may answer with a partial path and so never leads a coalesced group.
+            if (!Retry.Options.HasSearchBudget()) {
+                PathQueryLeaderByKey.FindOrAdd(Retry.CacheKey, Retry.RequestId);
+            }
+            PendingPathQueryHeap.HeapPush(FPathQueryQueueEntry{Retry.Priority, Retry.RequestId});
+            PendingPathQueries.Add(Retry.RequestId, MoveTemp(Retry));
+            continue;
+        }
+
+        // A sliced search gave its worker back. The next slice queues at the query's own priority, so anything
+        // more urgent waiting meanwhile dispatches first.
+        if (Completion.ResultBundle.bSearchSuspended && !Request->bCancelled->load(std::memory_order_relaxed)) {
+            if (ResultCode == ENavigationVolumeResult::ENVR_PartialPath && !Request->bSuperseded) {
+                DeliverPathQueryResult(*Request, Completion.ResultBundle);
+                ++NumDelivered;
+            }
+            FPathQueryRequest NextSlice;
+            InFlightPathQueries.RemoveAndCopyValue(Completion.RequestId, NextSlice);
+            NextSlice.WorkerFuture.Reset();
+            PendingPathQueryHeap.HeapPush(FPathQueryQueueEntry{NextSlice.Priority, NextSlice.RequestId});
+            PendingPathQueries.Add(NextSlice.RequestId, MoveTemp(NextSlice));
+            continue;
+        }
+
+        const uint32* ActiveRequestId = ActivePathQueryByActor.Find(Request->RequestingActor);
+        if (ActiveRequestId && *ActiveRequestId == Completion.RequestId) {
+            ActivePathQueryByActor.Remove(Request->RequestingActor);
+        }
+
+        if (Request->bIsBatch) {
+            if (!Request->bCancelled->load(std::memory_order_relaxed)) {
+                DeliverPathBatchResult(*Request, Completion.BatchResultBundles);
+                ++NumDelivered;
+            } else {
+                RecordPathQueryTelemetry(Request->EnqueueTime, ENavigationVolumeResult::ENVR_Cancelled);
+            }
+            InFlightPathQueries.Remove(Completion.RequestId);
+            continue;
+        }
+
+        ReleasePathQueryLeader(*Request);
+
+        if (!Request->bCancelled->load(std::memory_order_relaxed)) {
+            FPathfindingInternalResultBundle& ResultBundle = Completion.ResultBundle;
+            if (!Request->bSuperseded) {
+                DeliverPathQueryResult(*Request, ResultBundle);
+                ++NumDelivered;
+            }
+
+            // Followers only get the callback; the leader already drew the debug output for this search.
+            for (const uint32 FollowerId : Request->CoalescedRequestIds) {
+                FPathQueryRequest Follower;
+                if (!CoalescedPathQueries.RemoveAndCopyValue(FollowerId, Follower)) {
+                    continue;
+                }
+                const uint32* FollowerActiveId = ActivePathQueryByActor.Find(Follower.RequestingActor);
+                if (FollowerActiveId && *FollowerActiveId == FollowerId) {
+                    ActivePathQueryByActor.Remove(Follower.RequestingActor);
+                }
+                InvokePathQueryCallbacks(Follower, ResultBundle);
+                RecordPathQueryTelemetry(Follower.EnqueueTime, ResultBundle.ResultCode);
+                ++NumDelivered;
+            }
+
+            // Only results that depend on nothing but the navigation data are reusable; blocked endpoints are
+            // resolved with physics overlaps around the exact locations. Cache hits have no worker and are already stored.
+            const bool bCacheableResult = ResultBundle.ResultCode == ENavigationVolumeResult::ENVR_Success
+                || ResultBundle.ResultCode == ENavigationVolumeResult::ENVR_PathToSelf
+                || ResultBundle.ResultCode == ENavigationVolumeResult::ENVR_NoPathExists;
+            if (PathCacheCapacity > 0 && bCacheableResult && Request->WorkerFuture.IsValid() && Request->CacheKey.NavDataVersion == NavDataVersion) {
+                PathCache.Add(Request->CacheKey, FCachedPathResult{ResultBundle.ResultCode, ResultBundle.Path});
+            }
+        } else {
+            RecordPathQueryTelemetry(Request->EnqueueTime, ENavigationVolumeResult::ENVR_Cancelled, Completion.ResultBundle.NumExpanded, Completion.ResultBundle.PeakOpenNodes);
+            for (const uint32 FollowerId : Request->CoalescedRequestIds) {
+                CoalescedPathQueries.Remove(FollowerId);
+            }
+        }
+        InFlightPathQueries.Remove(Completion.RequestId);
+    }
+}
+
+void ANavigationVolume3D::InvokePathQueryCallbacks(const FPathQueryRequest& Request, const FPathfindingInternalResultBundle& ResultBundle)
+{
+    Request.OnCompleteCallback.ExecuteIfBound(ResultBundle.ResultCode, ResultBundle.GetPathPoints());
+    Request.OnNativeCompleteCallback.ExecuteIfBound(ResultBundle.ResultCode, ResultBundle.Path);
+}
+
+void ANavigationVolume3D::DeliverPathQueryResult(const FPathQueryRequest& Request, FPathfindingInternalResultBundle& ResultBundle)
+{
+    InvokePathQueryCallbacks(Request, ResultBundle);
+    RecordPathQueryTelemetry(Request.EnqueueTime, ResultBundle.ResultCode, ResultBundle.NumExpanded, ResultBundle.PeakOpenNodes);
+    RecordSearchTrace(ResultBundle);
+
+    // Rate limited so a crowd of agents on long routes does not turn into a stream of dumps.
+    if (ResultBundle.bIsLongPath_TaskLocal && bRecordSearchTraces && bDumpSearchTracesOnLongPath) {
+        const double Now = FPlatformTime::Seconds();
+        if (Now - LastSearchTraceDumpTime >= 10.0) {
+            LastSearchTraceDumpTime = Now;
+            DumpSearchTracesInBackground();
+        }
+    }
+
+    if (ResultBundle.bShouldDrawThisPathAndExploration_TaskLocal && ResultBundle.DebugDraw.IsValid())
+    {
+        UWorld* World = GetWorld();
+        if (World)
+        {
+            FlushCollectedDebugDraws(
+                World,
+                DebugDrawLifetime * (ResultBundle.bIsLongPath_TaskLocal ? 2.0f : 1.0f),
+                ResultBundle.DebugDraw->Spheres,
+                ResultBundle.DebugDraw->Lines,
+                ResultBundle.bIsLongPath_TaskLocal
+            );
+        }
+    }
+
+    if (ResultBundle.bIsLongPath_TaskLocal && bDrawPathfindingDebug && bPauseOnLongPath)
+    {
+         UWorld* World = GetWorld();
+         if (World) {
+            UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D (%s): Game PAUSED due to long path (%d steps). Actor: %s"),
+                *GetName(), ResultBundle.GetPathPoints().Num(), *Request.ActorNameForLog);
+            UGameplayStatics::SetGamePaused(World, true);
+         }
+    }
+}
+
+void ANavigationVolume3D::DeliverPathBatchResult(const FPathQueryRequest& Request, TArray<FPathfindingInternalResultBundle>& ResultBundles)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::DeliverPathBatchResult"));
+
+    UWorld* World = GetWorld();
+    TArray<FNavPathBatchResult> Results;
+    Results.Reserve(ResultBundles.Num());
+    for (FPathfindingInternalResultBundle& ResultBundle : ResultBundles) {
+        if (ResultBundle.bShouldDrawThisPathAndExploration_TaskLocal && ResultBundle.DebugDraw.IsValid() && World) {
+            FlushCollectedDebugDraws(World, DebugDrawLifetime * (ResultBundle.bIsLongPath_TaskLocal ? 2.0f : 1.0f),
+                ResultBundle.DebugDraw->Spheres, ResultBundle.DebugDraw->Lines, ResultBundle.bIsLongPath_TaskLocal);
+        }
+        RecordPathQueryTelemetry(Request.EnqueueTime, ResultBundle.ResultCode, ResultBundle.NumExpanded, ResultBundle.PeakOpenNodes);
+        RecordSearchTrace(ResultBundle);
+        // Copied, so the pooled buffer goes back to the pool with its capacity once the bundle is dropped.
+        FNavPathBatchResult& Result = Results.AddDefaulted_GetRef();
+        Result.Result = ResultBundle.ResultCode;
+        Result.Path = ResultBundle.GetPathPoints();
+    }
+    Request.OnBatchCompleteCallback.ExecuteIfBound(Results);
+}
+
+bool ANavigationVolume3D::IsStalePathResult(const FPathfindingInternalResultBundle& ResultBundle, uint8 MinClearance) const
+{
+    // A door that opened may have connected a NoPathExists query.
+    return ResultBundle.ResultCode == ENavigationVolumeResult::ENVR_NoPathExists
+        || (ResultBundle.ResultCode == ENavigationVolumeResult::ENVR_Success && !IsPathStillClear(ResultBundle.GetPathPoints(), MinClearance));
+}
+
+void ANavigationVolume3D::CancelAllPathQueries()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::CancelAllPathQueries"));
+
+    PendingPathQueries.Empty();
+    PendingPathQueryHeap.Empty();
+    ActivePathQueryByActor.Empty();
+    CoalescedPathQueries.Empty();
+    PathQueryLeaderByKey.Empty();
+
+    for (TPair<uint32, FPathQueryRequest>& InFlight : InFlightPathQueries) {
+        InFlight.Value.bCancelled->store(true, std::memory_order_relaxed);
+    }
+    for (TPair<uint32, FPathQueryRequest>& InFlight : InFlightPathQueries) {
+        if (InFlight.Value.WorkerFuture.IsValid()) {
+            InFlight.Value.WorkerFuture.Wait();
+        }
+    }
+    InFlightPathQueries.Empty();
+    CompletedPathQueries->Empty();
+}
+
+ANavigationVolume3D::FPathfindingInternalResultBundle ANavigationVolume3D::ExecutePathfindingOnThread(
+    TWeakObjectPtr<const AActor> WeakRequestingActor,
+    const FString& ActorNameForLogging,
+    const FVector& StartLocation,
+    const FVector& DestinationLocation,
+    const FNavPathQueryOptions& Options,
+    const std::atomic<bool>* bCancelled,
+    FSuspendedPathSearch* SuspendedSearch)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_Total"));
+
+    FPathfindingInternalResultBundle ResultBundle;
+    if (bRecordSearchTraces) {
+        ResultBundle.Trace = MakeUnique<FNavSearchTrace>();
+        ResultBundle.Trace->StartLocation = StartLocation;
+        ResultBundle.Trace->DestinationLocation = DestinationLocation;
+    }
+    if (!IsNavigationDataReady()) {
+        UE_LOG(LogTemp, Error, TEXT("ANavigationVolume3D::ExecutePathfindingOnThread - Nodes not initialized or empty. Actor: %s"), *ActorNameForLogging);
+        ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_VolumeNotReady;
+        return ResultBundle;
+    }
+
+    if (NavigationBackend == ENavigationVolumeBackend::SparseOctree) {
+        FPathfindingInternalResultBundle OctreeResultBundle = ExecuteOctreePathfindingOnThread(ActorNameForLogging, StartLocation, DestinationLocation, Options, bCancelled, ResultBundle.Trace.Get());
+        OctreeResultBundle.Trace = MoveTemp(ResultBundle.Trace);
+        return OctreeResultBundle;
+    }
+    ResultBundle.Path = PathPool.Acquire();
+
+    NavNode StartNode;
+    NavNode EndNode;
+
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_NodeConversionAndValidation"));
+        StartNode = GetConstNode(ConvertLocationToCoordinates(StartLocation));
+        EndNode   = GetConstNode(ConvertLocationToCoordinates(DestinationLocation));
+
+        if (!StartNode.IsValid()) {
+            UE_LOG(LogTemp, Warning, TEXT("ExecutePathfindingOnThread: StartNode is invalid. Actor: %s, StartLoc: %s"), *ActorNameForLogging, *StartLocation.ToString());
+            ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_StartNodeInvalid; return ResultBundle;
+        }
+        if (!EndNode.IsValid()) {
+            UE_LOG(LogTemp, Warning, TEXT("ExecutePathfindingOnThread: EndNode is invalid. Actor: %s, DestLoc: %s"), *ActorNameForLogging, *DestinationLocation.ToString());
+            ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_EndNodeInvalid; return ResultBundle;
+        }
+
+        auto ResolveBlockedNode = [&](NavNode& NodeToResolve, const FVector& OriginalWorldLocation, bool bIsStartNode) -> ENavigationVolumeResult {
+            if (!NodeToResolve.bIsTraversable) {
+                TRACE_CPUPROFILER_EVENT_SCOPE_TEXT(bIsStartNode ? TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_ResolveBlockedStart") : TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_ResolveBlockedEnd"));
+                const int32 ResolvedIndex = ResolveBlockedCell(NodeToResolve.Coordinates, OriginalWorldLocation);
+                if (ResolvedIndex != INDEX_NONE) {
+                    NodeToResolve = GetConstNode(Grid.ToCoordinates(ResolvedIndex));
+                    if (!NodeToResolve.IsValid()) {
+                        UE_LOG(LogTemp, Warning, TEXT("ExecutePathfindingOnThread: ResolveBlockedNode found location but GetNode returned an invalid node. Actor: %s"), *ActorNameForLogging);
+                        return bIsStartNode ? ENavigationVolumeResult::ENVR_StartNodeBlocked : ENavigationVolumeResult::ENVR_EndNodeBlocked;
+                    }
+
+                    if (!NodeToResolve.bIsTraversable) return bIsStartNode ? ENavigationVolumeResult::ENVR_StartNodeBlocked : ENavigationVolumeResult::ENVR_EndNodeBlocked;
+                } else { return bIsStartNode ? ENavigationVolumeResult::ENVR_StartNodeBlocked : ENavigationVolumeResult::ENVR_EndNodeBlocked; }
+            }
+            return ENavigationVolumeResult::ENVR_Success;
+        };
+
+        ENavigationVolumeResult StartResolveResult = ResolveBlockedNode(StartNode, StartLocation, true);
+        if(StartResolveResult != ENavigationVolumeResult::ENVR_Success) { ResultBundle.ResultCode = StartResolveResult; return ResultBundle; }
+
+        ENavigationVolumeResult EndResolveResult = ResolveBlockedNode(EndNode, DestinationLocation, false);
+        if(EndResolveResult != ENavigationVolumeResult::ENVR_Success) { ResultBundle.ResultCode = EndResolveResult; return ResultBundle; }
+
+        if (bDrawPathfindingDebug) {
+            AddDebugSphere_TaskLocal(ResultBundle.GetDebugDraw().Spheres, ConvertCoordinatesToLocation(StartNode.Coordinates), DebugNodeSphereRadius * 1.5f, FColor::Cyan, 12);
+            AddDebugSphere_TaskLocal(ResultBundle.GetDebugDraw().Spheres, ConvertCoordinatesToLocation(EndNode.Coordinates), DebugNodeSphereRadius * 1.5f, FColor::Magenta, 12);
+        }
+
+        if (ResultBundle.Trace.IsValid()) {
+            ResultBundle.Trace->StartCell = StartNode.Index;
+            ResultBundle.Trace->GoalCell = EndNode.Index;
+        }
+
+        if (StartNode == EndNode) {
+            TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_PathToSelf"));
+            ResultBundle.Path->Points.Add(ConvertCoordinatesToLocation(StartNode.Coordinates));
+            UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D::ExecutePathfindingOnThread - Path to self found. Actor: %s. Path steps: %d"), *ActorNameForLogging, ResultBundle.Path->Points.Num());
+
+            ResultBundle.bIsLongPath_TaskLocal = ResultBundle.Path->Points.Num() > LongPathThreshold;
+            ResultBundle.bShouldDrawThisPathAndExploration_TaskLocal = bDrawPathfindingDebug && (ResultBundle.bIsLongPath_TaskLocal || !bOnlyDrawDebugForLongPaths);
+
+            ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_PathToSelf;
+            return ResultBundle;
+        }
+    }
+
+    // The cluster graph and jump point search both assume every free cell fits the agent at unit step cost.
+    const uint8 MinClearance = GetRequiredClearance(Options);
+    const bool bClearanceAware = MinClearance > 1 || OpenSpaceCostWeight > 0.0f;
+
+    // Jump point search and bidirectional A* are already optimal, so they skip the approximate cluster graph.
+    // Bidirectional search needs the symmetric plain grid and cannot be sliced.
+    const bool bUseJumpPoints = !bClearanceAware && ShouldUseJumpPointSearch(Options);
+    const bool bUseBidirectional = !bClearanceAware && !Options.HasSearchBudget() && ShouldUseBidirectionalSearch(Options);
+    const bool bIsLongHop = FVector::DistSquared(FVector(StartNode.Coordinates), FVector(EndNode.Coordinates)) >= FMath::Square(static_cast<float>(HierarchicalMinDistanceCells));
+
+    // A search suspended by its budget continues where it stopped, unless the grid or its endpoints changed since.
+    TUniquePtr<FNavSearchContext> ResumedContext;
+    if (SuspendedSearch && SuspendedSearch->Context.IsValid()) {
+        if (SuspendedSearch->NavDataVersion == NavDataVersion && SuspendedSearch->StartIndex == StartNode.Index && SuspendedSearch->GoalIndex == EndNode.Index) {
+            ResumedContext = MoveTemp(SuspendedSearch->Context);
+        } else {
+            SearchContextPool.Release(MoveTemp(SuspendedSearch->Context));
+        }
+    }
+    const bool bContinueSearch = ResumedContext.IsValid();
+
+    // Wide agents search the coarsest layer whose cells they fill. Its routes exist at full resolution too, but
+    // openings it closed may still fit the agent, so a layer without a route falls through to the full grid. The
+    // layer search is cheap and has no budget; a suspended search is always a full-resolution one.
+    const int32 ResolutionLayer = SelectResolutionLayer(Options);
+    if (ResolutionLayer > 0 && !bContinueSearch) {
+        TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_ResolutionLayer"));
+        TArray<int32> PathIndices;
+        const ENavAStarStatus LayerStatus = GridLayers.FindPath(Grid, ResolutionLayer, StartNode.Index, EndNode.Index,
+            GetClearanceForRadius(Options.AgentRadius, ResolutionLayer), OpenSpaceCostWeight, SearchContextPool, bCancelled, PathIndices);
+        if (LayerStatus == ENavAStarStatus::Cancelled) {
+            ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_Cancelled;
+            return ResultBundle;
+        }
+        if (LayerStatus == ENavAStarStatus::Found) {
+            // The path still starts and ends on the requested cells; everything between is layer cell centres. The
+            // legs between layer cells keep the layer's clearance, but the first and last leg can reach into a
+            // neighbouring layer cell, so those are checked on the full grid before the path is used. Like the
+            // flat search, the requested cells themselves need not fit the agent.
+            const FNavGrid& LayerGrid = GridLayers.GetLevel(ResolutionLayer);
+            const FVector StartCellCenter = FVector(StartNode.Coordinates) + 0.5;
+            const FVector EndCellCenter = FVector(EndNode.Coordinates) + 0.5;
+            const FVector FirstLayerCenter = FNavGridMipChain::GetCellCenter(LayerGrid.ToCoordinates(PathIndices[0]), ResolutionLayer);
+            const FVector LastLayerCenter = FNavGridMipChain::GetCellCenter(LayerGrid.ToCoordinates(PathIndices.Last()), ResolutionLayer);
+            auto IsJoinCellFree = [this, MinClearance, &StartNode, &EndNode](const FIntVector& Cell) {
+                return Cell == StartNode.Coordinates || Cell == EndNode.Coordinates || IsCellFreeForAgent(Cell, MinClearance);
+            };
+            if (HasNavLineOfSight(StartCellCenter, FirstLayerCenter, IsJoinCellFree) && HasNavLineOfSight(LastLayerCenter, EndCellCenter, IsJoinCellFree)) {
+                ResultBundle.Path->Points.Reserve(PathIndices.Num() + 2);
+                ResultBundle.Path->Points.Add(ConvertCellSpaceToLocation(StartCellCenter));
+                for (const int32 PathIndex : PathIndices) {
+                    ResultBundle.Path->Points.Add(ConvertCellSpaceToLocation(FNavGridMipChain::GetCellCenter(LayerGrid.ToCoordinates(PathIndex), ResolutionLayer)));
+                }
+                ResultBundle.Path->Points.Add(ConvertCellSpaceToLocation(EndCellCenter));
+                FinalizeFoundPath(ResultBundle, Options, ActorNameForLogging);
+                return ResultBundle;
+            }
+            // An unsafe end leg falls through to the full-resolution search below.
+        }
+    }
+
+    // Runs a search with the debug-draw visitor while drawing, wrapped in the trace recorder when this query is traced.
+    auto RunVisitedSearch = [&](auto&& RunSearchWithVisitor) {
+        auto RunTracedSearch = [&](auto& Visitor) {
+            if (!ResultBundle.Trace.IsValid()) {
+                return RunSearchWithVisitor(Visitor);
+            }
+            auto NodeToCell = [](int32 NodeIndex) { return static_cast<uint32>(NodeIndex); };
+            TNavSearchTraceVisitor TraceVisitor(Visitor, *ResultBundle.Trace, MaxTracedExpansionsPerQuery, NodeToCell);
+            return RunSearchWithVisitor(TraceVisitor);
+        };
+        if (bDrawPathfindingDebug) {
+            FNavDebugDrawVisitor Visitor(ResultBundle.GetDebugDraw().Spheres, ResultBundle.GetDebugDraw().Lines, DebugNodeSphereRadius,
+                [this](int32 NodeIndex) { return ConvertCoordinatesToLocation(Grid.ToCoordinates(NodeIndex)); });
+            return RunTracedSearch(Visitor);
+        }
+        FNavAStarNullVisitor Visitor;
+        return RunTracedSearch(Visitor);
+    };
+
+    // The cluster-level search is cheap and has no budget; only the flat search below is sliced.
+    if (bUseHierarchicalPathfinding && bIsLongHop && !bUseJumpPoints && !bUseBidirectional && !bClearanceAware && !bContinueSearch && !ClusterHierarchy.IsEmpty()) {
+        TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_Hierarchical"));
+        TArray<int32> PathIndices;
+        const ENavAStarStatus HierarchicalStatus = RunVisitedSearch([&](auto& Visitor) {
+            using VisitorType = std::decay_t<decltype(Visitor)>;
+            if constexpr (std::is_same_v<VisitorType, FNavAStarNullVisitor>) {
+                return ClusterHierarchy.FindPath(Grid, StartNode.Index, EndNode.Index, SearchContextPool, bCancelled, PathIndices);
+            } else {
+                TNavAStarVisitorAdapter<VisitorType> VisitorAdapter(Visitor);
+                return ClusterHierarchy.FindPath(Grid, StartNode.Index, EndNode.Index, SearchContextPool, bCancelled, PathIndices, &VisitorAdapter);
+            }
+        });
+        if (HierarchicalStatus == ENavAStarStatus::Cancelled) {
+            ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_Cancelled;
+            return ResultBundle;
+        }
+        if (HierarchicalStatus == ENavAStarStatus::Found) {
+            ResultBundle.Path->Points.Reserve(PathIndices.Num());
+            for (const int32 PathIndex : PathIndices) {
+                ResultBundle.Path->Points.Add(ConvertCoordinatesToLocation(Grid.ToCoordinates(PathIndex)));
+            }
+            FinalizeFoundPath(ResultBundle, Options, ActorNameForLogging);
+            return ResultBundle;
+        }
+        if (ClusterHierarchy.HasCompleteConnectivity()) {
+            // Every crossing between clusters is represented by an entrance, so the cluster graph's NoPath is exact.
+            UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D::ExecutePathfindingOnThread - Failed to find path on the cluster graph. Actor: %s, StartNode: %s, EndNode: %s"),
+                *ActorNameForLogging, *StartNode.Coordinates.ToString(), *EndNode.Coordinates.ToString());
+            ResultBundle.bShouldDrawThisPathAndExploration_TaskLocal = bDrawPathfindingDebug && !bOnlyDrawDebugForLongPaths;
+            ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_NoPathExists;
+            return ResultBundle;
+        }
+        // Otherwise NoPath may only mean the cluster graph missed a diagonal-only opening; the flat search below is authoritative.
+    }
+
+    // This query's private scores and parent links; returned to the pool when the search ends.
+    FScopedNavSearchContext ScopedSearchContext(SearchContextPool, Grid.Num(), MoveTemp(ResumedContext));
+    FNavSearchContext& Search = ScopedSearchContext.Get();
+
+    FNavAStarParams SearchParams;
+    SearchParams.StartIndex = StartNode.Index;
+    SearchParams.GoalIndex = EndNode.Index;
+    SearchParams.bCancelled = bCancelled;
+    SearchParams.MaxExpansions = Options.MaxSearchExpansions;
+    SearchParams.DeadlineSeconds = Options.MaxSearchTimeMs > 0.0f ? FPlatformTime::Seconds() + Options.MaxSearchTimeMs / 1000.0 : 0.0;
+    SearchParams.bContinue = bContinueSearch;
+
+    // The backward frontier of a bidirectional search keeps its own scores and parent links.
+    TOptional<FScopedNavSearchContext> ScopedBackwardContext;
+    if (bUseBidirectional) {
+        ScopedBackwardContext.Emplace(SearchContextPool, Grid.Num());
+    }
+    int32 MeetingIndex = INDEX_NONE;
+
+    const FNavLandmarkHeuristic GoalLandmarks = Landmarks.MakeHeuristic(EndNode.Index);
+    const FNavLandmarkHeuristic StartLandmarks = bUseBidirectional ? Landmarks.MakeHeuristic(StartNode.Index) : FNavLandmarkHeuristic();
+
+    // A route on the coarsest layer, grown by one layer cell, bounds the full-resolution search when seeding is on.
+    const int32 SeedLayer = GridLayers.NumCoarseLevels();
+    TBitArray<> SeedCorridor;
+    if (bSeedSearchFromCoarsestLayer && SeedLayer > 0 && ResolutionLayer == 0 && !bUseJumpPoints && !bUseBidirectional && !bContinueSearch && !Options.HasSearchBudget()) {
+        TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_SeedCorridor"));
+        TArray<int32> SeedPath;
+        if (GridLayers.FindPath(Grid, SeedLayer, StartNode.Index, EndNode.Index, 1, 0.0f, SearchContextPool, bCancelled, SeedPath) == ENavAStarStatus::Found) {
+            GridLayers.BuildCorridor(SeedLayer, SeedPath, SeedCorridor);
+        }
+    }
+    int32 NumCorridorExpanded = 0;
+
+    ENavAStarStatus SearchStatus = ENavAStarStatus::NoPath;
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_AStar"));
+        auto RunSearch = [&](auto& Visitor) {
+            if (bUseBidirectional) {
+                return RunDenseGridBidirectionalSearch(Grid, GoalLandmarks, StartLandmarks, Search, ScopedBackwardContext->Get(), SearchParams, Visitor, MeetingIndex);
+            }
+            if (SeedCorridor.Num() > 0) {
+                const ENavAStarStatus CorridorStatus = RunDenseGridCorridorSearch(Grid, GridLayers.GetLevel(SeedLayer), SeedLayer, SeedCorridor,
+                    MinClearance, OpenSpaceCostWeight, GoalLandmarks, Search, SearchParams, Visitor);
+                if (CorridorStatus != ENavAStarStatus::NoPath) {
+                    return CorridorStatus;
+                }
+                // The corridor can miss the only opening, e.g. one the agent's clearance rules out near the coarse route.
+                NumCorridorExpanded = Search.NumExpanded;
+                Search.BeginSearch(Grid.Num());
+            }
+            return RunDenseGridSearch(Grid, JumpPointRules, bUseJumpPoints, MinClearance, OpenSpaceCostWeight, GoalLandmarks, Search, SearchParams, Visitor);
+        };
+        SearchStatus = RunVisitedSearch(RunSearch);
+    }
+    ResultBundle.NumExpanded = Search.NumExpanded + NumCorridorExpanded;
+    ResultBundle.PeakOpenNodes = Search.PeakOpen;
+    if (bUseBidirectional) {
+        ResultBundle.NumExpanded += ScopedBackwardContext->Get().NumExpanded;
+        ResultBundle.PeakOpenNodes += ScopedBackwardContext->Get().PeakOpen;
+    }
+
+    if (SearchStatus == ENavAStarStatus::Cancelled) {
+        ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_Cancelled;
+        return ResultBundle;
+    }
+
+    if (SearchStatus == ENavAStarStatus::OutOfBudget) {
+        const ENavPathBudgetAction BudgetAction = SuspendedSearch ? Options.BudgetExhaustedAction : ENavPathBudgetAction::ReturnPartialPath;
+        if (BudgetAction != ENavPathBudgetAction::ContinueNextSlice) {
+            TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_PartialPathReconstruction"));
+            TArray<int32> PathIndices;
+            ReconstructNavPath(Search, Search.ClosestToGoalIndex, PathIndices);
+            if (bUseJumpPoints) {
+                ExpandJumpPointPath(Grid, PathIndices);
+            }
+            ResultBundle.Path->Points.Reserve(PathIndices.Num());
+            for (const int32 PathIndex : PathIndices) {
+                ResultBundle.Path->Points.Add(ConvertCoordinatesToLocation(Grid.ToCoordinates(PathIndex)));
+            }
+            FinalizeFoundPath(ResultBundle, Options, ActorNameForLogging);
+            ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_PartialPath;
+        }
+        if (BudgetAction != ENavPathBudgetAction::ReturnPartialPath) {
+            SuspendedSearch->StartIndex = StartNode.Index;
+            SuspendedSearch->GoalIndex = EndNode.Index;
+            SuspendedSearch->NavDataVersion = NavDataVersion;
+            SuspendedSearch->Context = ScopedSearchContext.Detach();
+            ResultBundle.bSearchSuspended = true;
+        }
+        return ResultBundle;
+    }
+
+    if (SearchStatus == ENavAStarStatus::Found) {
+        TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_PathReconstruction"));
+        TArray<int32> PathIndices;
+        if (bUseBidirectional) {
+            ReconstructNavBidirectionalPath(Search, ScopedBackwardContext->Get(), MeetingIndex, PathIndices);
+        } else {
+            ReconstructNavPath(Search, EndNode.Index, PathIndices);
+        }
+        if (bUseJumpPoints) {
+            ExpandJumpPointPath(Grid, PathIndices);
+        }
+        ResultBundle.Path->Points.Reserve(PathIndices.Num());
+        for (const int32 PathIndex : PathIndices) {
+            ResultBundle.Path->Points.Add(ConvertCoordinatesToLocation(Grid.ToCoordinates(PathIndex)));
+        }
+        FinalizeFoundPath(ResultBundle, Options, ActorNameForLogging);
+        return ResultBundle;
+    }
+
+    UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D::ExecutePathfindingOnThread - Failed to find path. Actor: %s, StartNode: %s, EndNode: %s, StartLoc: %s, DestLoc: %s"),
+        *ActorNameForLogging,
+        *StartNode.Coordinates.ToString(),
+        *EndNode.Coordinates.ToString(),
+        *StartLocation.ToString(),
+        *DestinationLocation.ToString());
+
+    ResultBundle.bShouldDrawThisPathAndExploration_TaskLocal = bDrawPathfindingDebug && !bOnlyDrawDebugForLongPaths;
+    ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_NoPathExists;
+    return ResultBundle;
+}
+
+ANavigationVolume3D::FPathfindingInternalResultBundle ANavigationVolume3D::ExecuteOctreePathfindingOnThread(
+    const FString& ActorNameForLogging,
+    const FVector& StartLocation,
+    const FVector& DestinationLocation,
+    const FNavPathQueryOptions& Options,
+    const std::atomic<bool>* bCancelled,
+    FNavSearchTrace* Trace)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ExecuteOctreePathfindingOnThread"));
+    FPathfindingInternalResultBundle ResultBundle;
+    ResultBundle.Path = PathPool.Acquire();
+
+    const FIntVector StartCoordinates = ConvertLocationToCoordinates(StartLocation);
+    const FIntVector EndCoordinates = ConvertLocationToCoordinates(DestinationLocation);
+
+    // Blocked endpoints snap to the closest free leaf within the same radius the dense grid uses.
+    const int32 ResolveRadiusInCells = FMath::Max(1, FMath::CeilToInt(BlockedEndpointResolveRadius / DivisionSize));
+    const int32 StartLeaf = FindNearestOctreeLeaf(StartCoordinates, ResolveRadiusInCells);
+    if (StartLeaf == INDEX_NONE) {
+        ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_StartNodeBlocked;
+        return ResultBundle;
+    }
+    const int32 EndLeaf = FindNearestOctreeLeaf(EndCoordinates, ResolveRadiusInCells);
+    if (EndLeaf == INDEX_NONE) {
+        ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_EndNodeBlocked;
+        return ResultBundle;
+    }
+
+    // Path endpoints are the requested cells clamped into their leaves, so large leaves still end where the caller asked.
+    auto ClampIntoLeaf = [this](const FIntVector& Coordinates, int32 LeafIndex) {
+        const FNavOctree::FLeaf& Leaf = Octree.GetLeaf(LeafIndex);
+        const FIntVector LeafMax = Leaf.Min + FIntVector(Leaf.Size - 1);
+        return FIntVector(
+            FMath::Clamp(Coordinates.X, Leaf.Min.X, LeafMax.X),
+            FMath::Clamp(Coordinates.Y, Leaf.Min.Y, LeafMax.Y),
+            FMath::Clamp(Coordinates.Z, Leaf.Min.Z, LeafMax.Z));
+    };
+    const FVector StartPoint = ConvertCoordinatesToLocation(ClampIntoLeaf(StartCoordinates, StartLeaf));
+    const FVector EndPoint = ConvertCoordinatesToLocation(ClampIntoLeaf(EndCoordinates, EndLeaf));
+    if (Trace) {
+        Trace->StartCell = SearchNodeToTraceCell(StartLeaf);
+        Trace->GoalCell = SearchNodeToTraceCell(EndLeaf);
+    }
+
+    if (bDrawPathfindingDebug) {
+        AddDebugSphere_TaskLocal(ResultBundle.GetDebugDraw().Spheres, StartPoint, DebugNodeSphereRadius * 1.5f, FColor::Cyan, 12);
+        AddDebugSphere_TaskLocal(ResultBundle.GetDebugDraw().Spheres, EndPoint, DebugNodeSphereRadius * 1.5f, FColor::Magenta, 12);
+    }
+
+    if (StartLeaf == EndLeaf) {
+        // Leaves are convex and free, so a straight line inside one is always valid.
+        ResultBundle.Path->Points.Add(StartPoint);
+        if (!StartPoint.Equals(EndPoint)) {
+            ResultBundle.Path->Points.Add(EndPoint);
+            FinalizeFoundPath(ResultBundle, Options, ActorNameForLogging);
+            return ResultBundle;
+        }
+        ResultBundle.bShouldDrawThisPathAndExploration_TaskLocal = bDrawPathfindingDebug && !bOnlyDrawDebugForLongPaths;
+        ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_PathToSelf;
+        return ResultBundle;
+    }
+
+    FScopedNavSearchContext ScopedSearchContext(SearchContextPool, Octree.NumLeaves());
+    FNavSearchContext& Search = ScopedSearchContext.Get();
+
+    const FNavOctreeGraph OctreeGraph(Octree, EndLeaf);
+    FNavAStarParams SearchParams;
+    SearchParams.StartIndex = StartLeaf;
+    SearchParams.GoalIndex = EndLeaf;
+    SearchParams.bCancelled = bCancelled;
+
+    ENavAStarStatus SearchStatus = ENavAStarStatus::NoPath;
+    auto RunTracedSearch = [&](auto& Visitor) {
+        if (!Trace) {
+            return RunNavAStar(OctreeGraph, Search, SearchParams, Visitor);
+        }
+        auto NodeToCell = [this](int32 LeafIndex) { return SearchNodeToTraceCell(LeafIndex); };
+        TNavSearchTraceVisitor TraceVisitor(Visitor, *Trace, MaxTracedExpansionsPerQuery, NodeToCell);
+        return RunNavAStar(OctreeGraph, Search, SearchParams, TraceVisitor);
+    };
+    if (bDrawPathfindingDebug) {
+        FNavDebugDrawVisitor Visitor(ResultBundle.GetDebugDraw().Spheres, ResultBundle.GetDebugDraw().Lines, DebugNodeSphereRadius,
+            [this](int32 LeafIndex) { return ConvertCellSpaceToLocation(Octree.GetLeafCenter(LeafIndex)); });
+        SearchStatus = RunTracedSearch(Visitor);
+    } else {
+        FNavAStarNullVisitor Visitor;
+        SearchStatus = RunTracedSearch(Visitor);
+    }
+    ResultBundle.NumExpanded = Search.NumExpanded;
+    ResultBundle.PeakOpenNodes = Search.PeakOpen;
+
+    if (SearchStatus == ENavAStarStatus::Cancelled) {
+        ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_Cancelled;
+        return ResultBundle;
+    }
+    if (SearchStatus == ENavAStarStatus::NoPath) {
+        UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D::ExecuteOctreePathfindingOnThread - Failed to find path. Actor: %s, StartLoc: %s, DestLoc: %s"),
+            *ActorNameForLogging, *StartLocation.ToString(), *DestinationLocation.ToString());
+        ResultBundle.bShouldDrawThisPathAndExploration_TaskLocal = bDrawPathfindingDebug && !bOnlyDrawDebugForLongPaths;
+        ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_NoPathExists;
+        return ResultBundle;
+    }
+
+    // Route through the centre of each shared face: the segments leaf centre -> portal -> next leaf centre
+    // each stay inside one convex free leaf, which a direct centre-to-centre line would not guarantee.
+    TArray<int32> PathLeaves;
+    ReconstructNavPath(Search, EndLeaf, PathLeaves);
+    ResultBundle.Path->Points.Reserve(PathLeaves.Num() * 2);
+    ResultBundle.Path->Points.Add(StartPoint);
+    for (int32 PathIndex = 1; PathIndex < PathLeaves.Num(); ++PathIndex) {
+        ResultBundle.Path->Points.Add(ConvertCellSpaceToLocation(Octree.GetPortalCenter(PathLeaves[PathIndex - 1], PathLeaves[PathIndex])));
+        if (PathIndex + 1 < PathLeaves.Num()) {
+            ResultBundle.Path->Points.Add(ConvertCellSpaceToLocation(Octree.GetLeafCenter(PathLeaves[PathIndex])));
+        }
+    }
+    ResultBundle.Path->Points.Add(EndPoint);
+
+    FinalizeFoundPath(ResultBundle, Options, ActorNameForLogging);
+    return ResultBundle;
+}
+
+bool ANavigationVolume3D::ShouldUseJumpPointSearch(const FNavPathQueryOptions& Options) const
+{
+    const ENavPathSearchAlgorithm Algorithm = Options.SearchAlgorithm == ENavPathSearchAlgorithm::VolumeDefault ? DefaultSearchAlgorithm : Options.SearchAlgorithm;
+    return Algorithm == ENavPathSearchAlgorithm::JumpPoint && JumpPointRules.IsSupported();
+}
+
+bool ANavigationVolume3D::ShouldUseBidirectionalSearch(const FNavPathQueryOptions& Options) const
+{
+    const ENavPathSearchAlgorithm Algorithm = Options.SearchAlgorithm == ENavPathSearchAlgorithm::VolumeDefault ? DefaultSearchAlgorithm : Options.SearchAlgorithm;
+    return Algorithm == ENavPathSearchAlgorithm::Bidirectional;
+}
+
+uint8 ANavigationVolume3D::GetClearanceForRadius(float Radius, int32 Layer) const
+{
+    if (Radius <= 0.0f) {
+        return 1;
+    }
+
+    // A cell with clearance C keeps a cube of half-size (C - 0.5) cells around its centre free. One more cell
+    // than the radius alone needs also covers the diagonal sweep between two neighbouring cells that both fit.
+    const int32 Required = FMath::CeilToInt(Radius / (DivisionSize * (1 << Layer))) + 1;
+    if (Required > FNavGrid::MaxClearance && !bWarnedClearanceClamped.exchange(true, std::memory_order_relaxed)) {
+        UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D (%s): AgentRadius %.1f needs more clearance than the grid tracks; using %d cells. Further oversized radii are clamped silently."),
+            *GetName(), Radius, FNavGrid::MaxClearance);
+    }
+    return static_cast<uint8>(FMath::Min(Required, FNavGrid::MaxClearance));
+}
+
+uint8 ANavigationVolume3D::GetRequiredClearance(const FNavPathQueryOptions& Options) const
+{
+    if (NavigationBackend != ENavigationVolumeBackend::DenseGrid) {
+        return 1;
+    }
+    return GetClearanceForRadius(Options.AgentRadius);
+}
+
+int32 ANavigationVolume3D::SelectResolutionLayer(const FNavPathQueryOptions& Options) const
+{
+    if (NavigationBackend != ENavigationVolumeBackend::DenseGrid || GridLayers.NumCoarseLevels() == 0 || Options.AgentRadius <= 0.0f) {
+        return 0;
+    }
+    // Coarsest layer whose cells are no wider than the agent, so the openings the reduction closes are at most
+    // about twice its width.
+    const int32 Layer = FMath::FloorToInt32(FMath::Log2(2.0f * Options.AgentRadius / DivisionSize));
+    return FMath::Clamp(Layer, 0, GridLayers.NumCoarseLevels());
+}
+
+void ANavigationVolume3D::BenchmarkSearchAlgorithms()
+{
+    if (!IsNavigationDataReady() || NavigationBackend != ENavigationVolumeBackend::DenseGrid) {
+        UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D (%s): BenchmarkSearchAlgorithms needs a built dense grid (run it during Play)."), *GetName());
+        return;
     }
+    if (!JumpPointRules.IsSupported()) {
+        UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D (%s): BenchmarkSearchAlgorithms - jump point search needs MinSharedNeighborAxes = 0; skipping it."), *GetName());
+    }
+    check(IsInGameThread());
 
-    std::priority_queue<NavNode*, std::vector<NavNode*>, NodeCompare> OpenSet;
-    std::unordered_set<NavNode*> ClosedSetForThisSearchInstance;
-
-    auto HeuristicCost = [EndNodePtr](const NavNode* Node) -> float { if (!Node || !EndNodePtr) return std::numeric_limits<float>::max(); return FVector::Distance(FVector(EndNodePtr->Coordinates), FVector(Node->Coordinates)); };
-    auto NeighborDistance = [](const NavNode* Node1, const NavNode* Node2) -> float { 
-        if (!Node1 || !Node2) return std::numeric_limits<float>::max();
-        float dx = static_cast<float>(FMath::Abs(Node1->Coordinates.X - Node2->Coordinates.X));
-        float dy = static_cast<float>(FMath::Abs(Node1->Coordinates.Y - Node2->Coordinates.Y));
-        float dz = static_cast<float>(FMath::Abs(Node1->Coordinates.Z - Node2->Coordinates.Z));
-        return FMath::Sqrt(dx*dx + dy*dy + dz*dz);
+    FRandomStream RandomStream(12345); // Fixed seed so runs are comparable between changes.
+    auto PickTraversableCell = [&]() {
+        for (int32 Attempt = 0; Attempt < 64; ++Attempt) {
+            const int32 CellIndex = RandomStream.RandRange(0, Grid.Num() - 1);
+            if (Grid.IsTraversable(CellIndex)) return CellIndex;
+        }
+        return int32(INDEX_NONE);
     };
 
-    {
-        TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_AStar_Init"));
-    
-        ensureMsgf(StartNodePtr->SearchID_Pathfinding == MySearchID, TEXT("StartNodePtr not initialized for current SearchID before A* Init! Actor: %s"), *ActorNameForLogging);
-        StartNodePtr->GScore_Pathfinding = 0.0f;
-        StartNodePtr->FScore_Pathfinding = HeuristicCost(StartNodePtr);
-        OpenSet.push(StartNodePtr);
-        if (bDrawPathfindingDebug) {
-            AddDebugSphere_TaskLocal(ResultBundle.DebugSpheresToDraw_TaskLocal, ConvertCoordinatesToLocation(StartNodePtr->Coordinates), DebugNodeSphereRadius, FColor::Green);
+    FScopedNavSearchContext ScopedSearchContext(SearchContextPool, Grid.Num());
+    FNavSearchContext& Search = ScopedSearchContext.Get();
+    FScopedNavSearchContext ScopedBackwardContext(SearchContextPool, Grid.Num());
+    FNavSearchContext& BackwardSearch = ScopedBackwardContext.Get();
+
+    // Plain A* is the reference; the others must agree with it on reachability and path cost.
+    enum { BenchAStar, BenchJumpPoint, BenchBidirectional, BenchLandmarks, NumBenchAlgorithms };
+    const FNavLandmarkHeuristic NoLandmarks;
+    double Seconds[NumBenchAlgorithms] = {};
+    int64 Expanded[NumBenchAlgorithms] = {};
+    int32 NumFound = 0;
+    int32 NumCostMismatches[NumBenchAlgorithms] = {};
+    for (int32 QueryIndex = 0; QueryIndex < BenchmarkQueryCount; ++QueryIndex) {
+        FNavAStarParams Params;
+        Params.StartIndex = PickTraversableCell();
+        Params.GoalIndex = PickTraversableCell();
+        if (Params.StartIndex == INDEX_NONE || Params.GoalIndex == INDEX_NONE) continue;
+
+        float PathCosts[NumBenchAlgorithms];
+        ENavAStarStatus Statuses[NumBenchAlgorithms];
+        for (int32 Algorithm = 0; Algorithm < NumBenchAlgorithms; ++Algorithm) {
+            if (Algorithm == BenchJumpPoint && !JumpPointRules.IsSupported()) continue;
+            if (Algorithm == BenchLandmarks && Landmarks.IsEmpty()) continue;
+
+            Search.BeginSearch(Grid.Num());
+            BackwardSearch.BeginSearch(Grid.Num());
+            FNavCountingVisitor Visitor;
+            int32 MeetingIndex = INDEX_NONE;
+            const double StartTime = FPlatformTime::Seconds();
+            const FNavLandmarkHeuristic GoalLandmarks = Algorithm == BenchLandmarks ? Landmarks.MakeHeuristic(Params.GoalIndex) : NoLandmarks;
+            Statuses[Algorithm] = Algorithm == BenchBidirectional
+                ? RunDenseGridBidirectionalSearch(Grid, NoLandmarks, NoLandmarks, Search, BackwardSearch, Params, Visitor, MeetingIndex)
+                : RunDenseGridSearch(Grid, JumpPointRules, Algorithm == BenchJumpPoint, 1, 0.0f, GoalLandmarks, Search, Params, Visitor);
+            Seconds[Algorithm] += FPlatformTime::Seconds() - StartTime;
+            Expanded[Algorithm] += Visitor.NumExpanded;
+            PathCosts[Algorithm] = Algorithm == BenchBidirectional && MeetingIndex != INDEX_NONE
+                ? Search.GetGScore(MeetingIndex) + BackwardSearch.GetGScore(MeetingIndex)
+                : Search.GetGScore(Params.GoalIndex);
+
+            if (Algorithm != BenchAStar && (Statuses[Algorithm] != Statuses[BenchAStar]
+                || (Statuses[BenchAStar] == ENavAStarStatus::Found && !FMath::IsNearlyEqual(PathCosts[BenchAStar], PathCosts[Algorithm], 1.e-3f)))) {
+                ++NumCostMismatches[Algorithm];
+            }
         }
+        if (Statuses[BenchAStar] == ENavAStarStatus::Found) ++NumFound;
     }
 
-    bool bPathSuccessfullyFound = false;
-    {
-        TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_AStar_MainLoop"));
-        while (!OpenSet.empty())
-        {
-            NavNode* Current = OpenSet.top(); OpenSet.pop();
-            
-            if (!Current || Current->SearchID_Pathfinding != MySearchID) {
-                 continue;
-            }
-            
-            if (bDrawPathfindingDebug) {
-                 AddDebugSphere_TaskLocal(ResultBundle.DebugSpheresToDraw_TaskLocal, ConvertCoordinatesToLocation(Current->Coordinates), DebugNodeSphereRadius * 1.2f, FColor::Yellow);
-            }
-            
-            if (ClosedSetForThisSearchInstance.count(Current)) {
-                continue;
-            }
-            ClosedSetForThisSearchInstance.insert(Current);
+    UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): Search benchmark, %d queries (%d with a path). A*: %.2f ms, %lld expansions. JPS: %.2f ms, %lld expansions, %d mismatches. Bidirectional: %.2f ms, %lld expansions, %d mismatches. ALT (%d landmarks): %.2f ms, %lld expansions, %d mismatches."),
+        *GetName(), BenchmarkQueryCount, NumFound, Seconds[BenchAStar] * 1000.0, Expanded[BenchAStar],
+        Seconds[BenchJumpPoint] * 1000.0, Expanded[BenchJumpPoint], NumCostMismatches[BenchJumpPoint],
+        Seconds[BenchBidirectional] * 1000.0, Expanded[BenchBidirectional], NumCostMismatches[BenchBidirectional],
+        Landmarks.Num(), Seconds[BenchLandmarks] * 1000.0, Expanded[BenchLandmarks], NumCostMismatches[BenchLandmarks]);
+}
 
-            if (bDrawPathfindingDebug) {
-                AddDebugSphere_TaskLocal(ResultBundle.DebugSpheresToDraw_TaskLocal, ConvertCoordinatesToLocation(Current->Coordinates), DebugNodeSphereRadius, FColor::Red);
-            }
-            
-            if (Current == EndNodePtr) {
-                bPathSuccessfullyFound = true;
-                break; 
-            }
+void ANavigationVolume3D::SmoothPathPoints(TArray<FVector>& InOutPathPoints, uint8 MinClearance) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::SmoothPathPoints"));
 
-            {
-                TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_NeighborLoop"));
-                if (Current->GScore_Pathfinding == std::numeric_limits<float>::max()) { continue; }
+    const FTransform& VolumeTransform = GetActorTransform();
+    for (FVector& PathPoint : InOutPathPoints) {
+        PathPoint = VolumeTransform.InverseTransformPosition(PathPoint) / DivisionSize;
+    }
+    SmoothNavPath(InOutPathPoints, [this, MinClearance](const FIntVector& Cell) { return IsCellFreeForAgent(Cell, MinClearance); });
+    for (FVector& PathPoint : InOutPathPoints) {
+        PathPoint = ConvertCellSpaceToLocation(PathPoint);
+    }
+}
 
-                for (NavNode* Neighbor : Current->Neighbors) {
-                    if (!Neighbor || !Neighbor->bIsTraversable) continue;
+void ANavigationVolume3D::FinalizeFoundPath(FPathfindingInternalResultBundle& ResultBundle, const FNavPathQueryOptions& Options, const FString& ActorNameForLogging) const
+{
+    const ENavPathSmoothing Smoothing = Options.Smoothing == ENavPathSmoothing::VolumeDefault ? DefaultPathSmoothing : Options.Smoothing;
+    if (Smoothing == ENavPathSmoothing::LineOfSight) {
+        SmoothPathPoints(ResultBundle.Path->Points, GetRequiredClearance(Options));
+    }
 
-                    if (bDrawPathfindingDebug) {
-                        AddDebugLine_TaskLocal(ResultBundle.DebugLinesToDraw_TaskLocal, ConvertCoordinatesToLocation(Current->Coordinates), ConvertCoordinatesToLocation(Neighbor->Coordinates), FColor(128,128,128,100), 0.5f);
-                    }
-                    
-                    if (ClosedSetForThisSearchInstance.count(Neighbor)) {
-                        continue;
-                    }
+    // UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D::FinalizeFoundPath - Path successfully found. Actor: %s. Steps: %d"), *ActorNameForLogging, ResultBundle.Path->Points.Num());
 
-                    float DistCurrentToNeighbor = NeighborDistance(Current, Neighbor);
-                    if (DistCurrentToNeighbor == std::numeric_limits<float>::max()) continue;
-                    
-                    float TentativeGScore = Current->GScore_Pathfinding + DistCurrentToNeighbor;
-                    
-                    if (Neighbor->SearchID_Pathfinding != MySearchID) {
-                        Neighbor->SearchID_Pathfinding = MySearchID;
-                        Neighbor->GScore_Pathfinding = std::numeric_limits<float>::max();
-                        Neighbor->FScore_Pathfinding = std::numeric_limits<float>::max();
-                        Neighbor->CameFrom_Pathfinding = nullptr;
-                    }
+    ResultBundle.bIsLongPath_TaskLocal = ResultBundle.Path->Points.Num() > LongPathThreshold;
+    ResultBundle.bShouldDrawThisPathAndExploration_TaskLocal = bDrawPathfindingDebug && (ResultBundle.bIsLongPath_TaskLocal || !bOnlyDrawDebugForLongPaths);
 
-                    if (TentativeGScore < Neighbor->GScore_Pathfinding) {
-                        TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_UpdateNeighborPath"));
-                        Neighbor->CameFrom_Pathfinding = Current;
-                        Neighbor->GScore_Pathfinding = TentativeGScore;
-                        Neighbor->FScore_Pathfinding = TentativeGScore + HeuristicCost(Neighbor); 
-                        OpenSet.push(Neighbor);
-                        if (bDrawPathfindingDebug) {
-                            AddDebugSphere_TaskLocal(ResultBundle.DebugSpheresToDraw_TaskLocal, ConvertCoordinatesToLocation(Neighbor->Coordinates), DebugNodeSphereRadius, FColor::Green);
-                            AddDebugLine_TaskLocal(ResultBundle.DebugLinesToDraw_TaskLocal, ConvertCoordinatesToLocation(Current->Coordinates), ConvertCoordinatesToLocation(Neighbor->Coordinates), FColor::White);
-                        }
-                    }
-                }
+    if (bDrawPathfindingDebug && ResultBundle.bShouldDrawThisPathAndExploration_TaskLocal) {
+        for (int32 PointIndex = 0; PointIndex < ResultBundle.Path->Points.Num(); ++PointIndex) {
+            AddDebugSphere_TaskLocal(ResultBundle.GetDebugDraw().Spheres, ResultBundle.Path->Points[PointIndex], DebugNodeSphereRadius * 0.9f, FColorList::NeonPink, 10);
+            if (PointIndex > 0) {
+                AddDebugLine_TaskLocal(ResultBundle.GetDebugDraw().Lines, ResultBundle.Path->Points[PointIndex], ResultBundle.Path->Points[PointIndex - 1], FColorList::NeonPink, 3.5f);
             }
         }
     }
 
-    if (bPathSuccessfullyFound) {
-        TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ExecutePathfindingOnThread_PathReconstruction"));
-        TArray<FVector> TempPath;
-        NavNode* PathNode = EndNodePtr;
-        while (PathNode != nullptr && PathNode->SearchID_Pathfinding == MySearchID) {
-            TempPath.Add(ConvertCoordinatesToLocation(PathNode->Coordinates));
-            PathNode = PathNode->CameFrom_Pathfinding;
-        }
-        Algo::Reverse(TempPath);
-        ResultBundle.PathPoints = TempPath;
-        // UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D::ExecutePathfindingOnThread - Path successfully found. Actor: %s. Steps: %d"), *ActorNameForLogging, ResultBundle.PathPoints.Num());
-
-        ResultBundle.bIsLongPath_TaskLocal = ResultBundle.PathPoints.Num() > LongPathThreshold;
-        ResultBundle.bShouldDrawThisPathAndExploration_TaskLocal = bDrawPathfindingDebug && (ResultBundle.bIsLongPath_TaskLocal || !bOnlyDrawDebugForLongPaths);
-
-        if (bDrawPathfindingDebug && ResultBundle.bShouldDrawThisPathAndExploration_TaskLocal) {
-            NavNode* VisPathNode = EndNodePtr;
-            while (VisPathNode != nullptr && VisPathNode->SearchID_Pathfinding == MySearchID) {
-                FVector NodeLoc = ConvertCoordinatesToLocation(VisPathNode->Coordinates);
-                AddDebugSphere_TaskLocal(ResultBundle.DebugSpheresToDraw_TaskLocal, NodeLoc, DebugNodeSphereRadius * 0.9f, FColorList::NeonPink, 10);
-                if (VisPathNode->CameFrom_Pathfinding && VisPathNode->CameFrom_Pathfinding->SearchID_Pathfinding == MySearchID) {
-                    AddDebugLine_TaskLocal(ResultBundle.DebugLinesToDraw_TaskLocal, NodeLoc, ConvertCoordinatesToLocation(VisPathNode->CameFrom_Pathfinding->Coordinates), FColorList::NeonPink, 3.5f);
-                }
-                VisPathNode = VisPathNode->CameFrom_Pathfinding;
-            }
-        }
-        
-        if (ResultBundle.bIsLongPath_TaskLocal && bDrawPathfindingDebug) {
-            UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D::ExecutePathfindingOnThread - LONG PATH DETECTED: Actor: %s, %d steps (Threshold: %d)"), *ActorNameForLogging, ResultBundle.PathPoints.Num(), LongPathThreshold);
-        }
-        ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_Success;
-        return ResultBundle;
+    if (ResultBundle.bIsLongPath_TaskLocal && bDrawPathfindingDebug) {
+        UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D::ExecutePathfindingOnThread - LONG PATH DETECTED: Actor: %s, %d steps (Threshold: %d)"), *ActorNameForLogging, ResultBundle.Path->Points.Num(), LongPathThreshold);
     }
-    
-    UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D::ExecutePathfindingOnThread - Failed to find path. Actor: %s, StartNode: %s, EndNode: %s, StartLoc: %s, DestLoc: %s"),
-        *ActorNameForLogging,
-        (StartNodePtr ? *StartNodePtr->Coordinates.ToString() : TEXT("INVALID_START")),
-        (EndNodePtr ? *EndNodePtr->Coordinates.ToString() : TEXT("INVALID_END")),
-        *StartLocation.ToString(),
-        *DestinationLocation.ToString());
-    
-    ResultBundle.bShouldDrawThisPathAndExploration_TaskLocal = bDrawPathfindingDebug && !bOnlyDrawDebugForLongPaths;
-    ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_NoPathExists;
-    return ResultBundle;
+    ResultBundle.ResultCode = ENavigationVolumeResult::ENVR_Success;
 }
 
 
@@ -469,11 +1909,184 @@ void ANavigationVolume3D::FlushCollectedDebugDraws(UWorld* World, float Lifetime
     }
 }
 
+void ANavigationVolume3D::RecordSearchTrace(FPathfindingInternalResultBundle& ResultBundle)
+{
+    if (!ResultBundle.Trace.IsValid() || !bRecordSearchTraces) {
+        return;
+    }
+    FNavSearchTrace& Trace = *ResultBundle.Trace;
+    Trace.ResultCode = static_cast<uint8>(ResultBundle.ResultCode);
+    Trace.PathPoints = ResultBundle.GetPathPoints();
+    if (const UWorld* World = GetWorld()) {
+        Trace.WorldTimeSeconds = World->GetTimeSeconds();
+    }
+    SearchTraceRecorder.SetCapacity(SearchTraceCapacity);
+    SearchTraceRecorder.Add(MoveTemp(Trace));
+    ResultBundle.Trace.Reset();
+}
+
+FNavSearchTraceHeader ANavigationVolume3D::MakeSearchTraceHeader() const
+{
+    FNavSearchTraceHeader Header;
+    Header.VolumeName = GetName();
+    Header.Divisions = FIntVector(DivisionsX, DivisionsY, DivisionsZ);
+    Header.DivisionSize = DivisionSize;
+    Header.Backend = static_cast<uint8>(NavigationBackend);
+    return Header;
+}
+
+uint32 ANavigationVolume3D::SearchNodeToTraceCell(int32 NodeIndex) const
+{
+    if (NavigationBackend != ENavigationVolumeBackend::SparseOctree) {
+        return static_cast<uint32>(NodeIndex);
+    }
+    const FVector Center = Octree.GetLeafCenter(NodeIndex);
+    const FIntVector Cell(FMath::FloorToInt32(Center.X), FMath::FloorToInt32(Center.Y), FMath::FloorToInt32(Center.Z));
+    return static_cast<uint32>((Cell.Z * DivisionsY + Cell.Y) * DivisionsX + Cell.X);
+}
+
+FString ANavigationVolume3D::MakeSearchTraceDumpPath() const
+{
+    return FPaths::ProfilingDir() / TEXT("Navigation3D") / FString::Printf(TEXT("%s_%s.nav3dtrace"), *GetName(), *FDateTime::Now().ToString());
+}
+
+bool ANavigationVolume3D::DumpSearchTraces(FString& OutFilePath)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::DumpSearchTraces"));
+
+    OutFilePath = MakeSearchTraceDumpPath();
+    if (SearchTraceRecorder.Num() == 0) {
+        UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D (%s): No search traces to dump. Enable bRecordSearchTraces first."), *GetName());
+        return false;
+    }
+    if (!SearchTraceRecorder.SaveToFile(OutFilePath, MakeSearchTraceHeader())) {
+        UE_LOG(LogTemp, Error, TEXT("ANavigationVolume3D (%s): Failed to write search traces to %s."), *GetName(), *OutFilePath);
+        return false;
+    }
+    UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): Wrote %d search traces to %s."), *GetName(), SearchTraceRecorder.Num(), *OutFilePath);
+    return true;
+}
+
+void ANavigationVolume3D::DumpSearchTracesInBackground()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::DumpSearchTracesInBackground"));
+
+    if (SearchTraceRecorder.Num() == 0) {
+        return;
+    }
+    // The recorder keeps changing on the game thread, so the task writes a snapshot of it.
+    TArray<FNavSearchTrace> Traces;
+    SearchTraceRecorder.CopyTraces(Traces);
+    Async(EAsyncExecution::ThreadPool, [FilePath = MakeSearchTraceDumpPath(), Header = MakeSearchTraceHeader(), Traces = MoveTemp(Traces)]() mutable {
+        if (!FNavSearchTraceRecorder::SaveTracesToFile(FilePath, Header, Traces)) {
+            UE_LOG(LogTemp, Error, TEXT("ANavigationVolume3D (%s): Failed to write search traces to %s."), *Header.VolumeName, *FilePath);
+            return;
+        }
+        UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): Wrote %d search traces to %s."), *Header.VolumeName, Traces.Num(), *FilePath);
+    });
+}
+
+static FAutoConsoleCommandWithWorld GDumpSearchTracesCommand(
+    TEXT("nav3d.DumpSearchTraces"),
+    TEXT("Writes the recorded search traces of every Navigation Volume 3D in the world to Saved/Profiling/Navigation3D."),
+    FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World) {
+        for (TActorIterator<ANavigationVolume3D> It(World); It; ++It) {
+            FString FilePath;
+            It->DumpSearchTraces(FilePath);
+        }
+    }));
+
+void ANavigationVolume3D::LoadSearchTraceReplay()
+{
+    FNavSearchTraceHeader Header;
+    if (!FNavSearchTraceRecorder::LoadFromFile(SearchTraceReplayFile.FilePath, Header, SearchTraceReplayTraces)) {
+        UE_LOG(LogTemp, Error, TEXT("ANavigationVolume3D (%s): Could not read search trace file '%s'."), *GetName(), *SearchTraceReplayFile.FilePath);
+        SearchTraceReplayTraces.Empty();
+        return;
+    }
+    // Cells are decoded with this volume's divisions, so anything else would scatter the replay.
+    if (Header.Divisions != FIntVector(DivisionsX, DivisionsY, DivisionsZ)) {
+        UE_LOG(LogTemp, Error, TEXT("ANavigationVolume3D (%s): Trace from %s has divisions %s, this volume has %d x %d x %d."),
+            *GetName(), *Header.VolumeName, *Header.Divisions.ToString(), DivisionsX, DivisionsY, DivisionsZ);
+        SearchTraceReplayTraces.Empty();
+        return;
+    }
+    UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): Loaded %d search traces recorded on %s."), *GetName(), SearchTraceReplayTraces.Num(), *Header.VolumeName);
+    DrawSearchTraceReplay();
+}
+
+void ANavigationVolume3D::StepSearchTraceReplay()
+{
+    SearchTraceReplayStep += SearchTraceReplayStepSize;
+    DrawSearchTraceReplay();
+}
+
+void ANavigationVolume3D::StepBackSearchTraceReplay()
+{
+    SearchTraceReplayStep = FMath::Max(0, SearchTraceReplayStep - SearchTraceReplayStepSize);
+    DrawSearchTraceReplay();
+}
+
+void ANavigationVolume3D::ShowWholeSearchTraceReplay()
+{
+    SearchTraceReplayStep = MAX_int32;
+    DrawSearchTraceReplay();
+}
+
+void ANavigationVolume3D::ClearSearchTraceReplay()
+{
+    SearchTraceReplayTraces.Empty();
+    SearchTraceReplayStep = 0;
+    if (UWorld* World = GetWorld()) {
+        FlushPersistentDebugLines(World);
+    }
+}
+
+void ANavigationVolume3D::DrawSearchTraceReplay()
+{
+    UWorld* World = GetWorld();
+    if (!World) {
+        return;
+    }
+    FlushPersistentDebugLines(World);
+    if (!SearchTraceReplayTraces.IsValidIndex(SearchTraceReplayQuery)) {
+        UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D (%s): No trace %d to replay (%d loaded)."), *GetName(), SearchTraceReplayQuery, SearchTraceReplayTraces.Num());
+        return;
+    }
+
+    const FNavSearchTrace& Trace = SearchTraceReplayTraces[SearchTraceReplayQuery];
+    SearchTraceReplayStep = FMath::Clamp(SearchTraceReplayStep, 0, Trace.ExpandedCells.Num());
+    auto CellToLocation = [this](uint32 Cell) {
+        const int32 CellIndex = static_cast<int32>(Cell);
+        return ConvertCoordinatesToLocation(FIntVector(CellIndex % DivisionsX, (CellIndex / DivisionsX) % DivisionsY, CellIndex / (DivisionsX * DivisionsY)));
+    };
+
+    // Same colours as the live debug draw: cyan start, magenta goal, red closed, yellow current, pink path.
+    DrawDebugSphere(World, Trace.StartLocation, DebugNodeSphereRadius * 1.5f, 12, FColor::Cyan, true);
+    DrawDebugSphere(World, Trace.DestinationLocation, DebugNodeSphereRadius * 1.5f, 12, FColor::Magenta, true);
+    for (int32 Step = 0; Step < SearchTraceReplayStep; ++Step) {
+        DrawDebugPoint(World, CellToLocation(Trace.ExpandedCells[Step]), DebugNodeSphereRadius * 0.5f, FColor::Red, true);
+    }
+    if (SearchTraceReplayStep > 0) {
+        DrawDebugBox(World, CellToLocation(Trace.ExpandedCells[SearchTraceReplayStep - 1]), FVector(DivisionSize * 0.5f), FColor::Yellow, true);
+    }
+    if (SearchTraceReplayStep == Trace.ExpandedCells.Num()) {
+        for (int32 PointIndex = 1; PointIndex < Trace.PathPoints.Num(); ++PointIndex) {
+            DrawDebugLine(World, Trace.PathPoints[PointIndex - 1], Trace.PathPoints[PointIndex], FColorList::NeonPink, true, -1.0f, 0, 3.5f);
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): Trace %d/%d at %.2fs, %s, step %d of %d%s."),
+        *GetName(), SearchTraceReplayQuery + 1, SearchTraceReplayTraces.Num(), Trace.WorldTimeSeconds,
+        *UEnum::GetValueAsString(static_cast<ENavigationVolumeResult>(Trace.ResultCode)),
+        SearchTraceReplayStep, Trace.ExpandedCells.Num(), Trace.bTruncated ? TEXT(" (truncated)") : TEXT(""));
+}
+
 void ANavigationVolume3D::BeginPlay()
 {
     Super::BeginPlay();
 
-    if (bNodesInitializedAndFinalized) {
+    if (bNodesInitializedAndFinalized || PendingTraversabilityBake.IsValid()) {
         UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D (%s): BeginPlay - Nodes already initialized. Skipping."), *GetName());
         return;
     }
@@ -486,105 +2099,369 @@ void ANavigationVolume3D::BeginPlay()
 
     UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): BeginPlay - Initializing %d nodes."), *GetName(), TotalNodes);
 
-    Nodes.Empty(TotalNodes); 
-    Nodes.SetNum(TotalNodes); 
-                              
-    for (int32 z = 0; z < DivisionsZ; ++z) {
-        for (int32 y = 0; y < DivisionsY; ++y) {
-            for (int32 x = 0; x < DivisionsX; ++x) {
-                FIntVector CurrentCoords(x, y, z);
-                NavNode* CurrentNodePtr = GetNode(CurrentCoords); 
-                if (CurrentNodePtr) {
-                    CurrentNodePtr->Coordinates = CurrentCoords;
-                    CurrentNodePtr->bIsTraversable = true; 
-                    CurrentNodePtr->Neighbors.clear(); 
-
-                } else {
-                    UE_LOG(LogTemp, Fatal, TEXT("ANavigationVolume3D (%s): BeginPlay - GetNode returned nullptr for valid grid coordinate %s during Phase 1. This should not happen."), *GetName(), *CurrentCoords.ToString());
-                    ensureMsgf(false, TEXT("GetNode returned null for an expected valid coordinate during node initialization."));
-                    return;
-                }
-            }
+    RandomLocationStream.GenerateNewSeed();
+    BakedBlockCount = 0;
+    BakeBlockTotal = 0;
+    bCancelTraversabilityBake = false;
+
+    if (NavigationBackend == ENavigationVolumeBackend::SparseOctree) {
+        BuildSparseOctree();
+    } else {
+        if (LoadBakedNavigationData()) {
+            FinishNavigationBuild(true);
+            return;
+        }
+
+        Grid.Initialize(DivisionsX, DivisionsY, DivisionsZ, MinSharedNeighborAxes);
+
+        if (bBakeAsync) {
+            // Nothing reads the grid until FinishNavigationBuild marks it ready; EndPlay waits for the bake.
+            UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): BeginPlay - Baking traversability in the background."), *GetName());
+            PendingTraversabilityBake = Async(EAsyncExecution::ThreadPool, [this]() { PrecomputeNodeTraversability(); });
+            return;
         }
+        PrecomputeNodeTraversability();
     }
-    
-    auto addNeighborIfValid = [&](NavNode* CenterNode, const FIntVector& NeighborGridCoords) {
-        if (!CenterNode) return;
-        if (AreCoordinatesValid(NeighborGridCoords)) {
-            int32 SharedAxes = 0;
-            if (CenterNode->Coordinates.X == NeighborGridCoords.X) SharedAxes++;
-            if (CenterNode->Coordinates.Y == NeighborGridCoords.Y) SharedAxes++;
-            if (CenterNode->Coordinates.Z == NeighborGridCoords.Z) SharedAxes++;
-
-            if (SharedAxes >= MinSharedNeighborAxes && SharedAxes < 3) { 
-                NavNode* NeighborNodePtr = GetNode(NeighborGridCoords);
-                if (NeighborNodePtr) {
-                    CenterNode->Neighbors.push_back(NeighborNodePtr);
-                } else {
-                     UE_LOG(LogTemp, Error, TEXT("ANavigationVolume3D (%s): BeginPlay - addNeighborIfValid got NULL for valid-seeming neighbor coords %s for center node %s"),
-                        *GetName(), *NeighborGridCoords.ToString(), *CenterNode->Coordinates.ToString());
-                     ensureMsgf(false, TEXT("addNeighborIfValid got NULL neighbor pointer for presumably valid coordinates."));
-                }
-            }
+    FinishNavigationBuild();
+}
+
+void ANavigationVolume3D::FinishNavigationBuild(bool bLoadedFromBake)
+{
+    if (NavigationBackend == ENavigationVolumeBackend::DenseGrid) {
+        if (!bLoadedFromBake) {
+            Grid.RebuildNeighborMasks();
+            Grid.RebuildClearance();
+            Grid.RebuildNearestTraversable();
+            UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): BeginPlay - Node neighbor masks and clearance built. Grid data: %.2f KB."), *GetName(), Grid.GetAllocatedSize() / 1024.0);
         }
-    };
 
-    for (NavNode& CurrentNode : Nodes) { 
-        for (int dz = -1; dz <= 1; ++dz) {
-            for (int dy = -1; dy <= 1; ++dy) {
-                for (int dx = -1; dx <= 1; ++dx) {
-                    if (dx == 0 && dy == 0 && dz == 0) continue; 
-                    addNeighborIfValid(&CurrentNode, CurrentNode.Coordinates + FIntVector(dx, dy, dz));
-                }
-            }
+        JumpPointRules.Build(Grid.GetAllowedDirectionsMask());
+        if (DefaultSearchAlgorithm == ENavPathSearchAlgorithm::JumpPoint && !JumpPointRules.IsSupported()) {
+            UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D (%s): Jump point search needs MinSharedNeighborAxes = 0. Queries will use A*."), *GetName());
+        }
+
+        if (bUseHierarchicalPathfinding && !bLoadedFromBake) {
+            ClusterHierarchy.Build(Grid, HierarchicalClusterSize, SearchContextPool);
+            UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): BeginPlay - Cluster hierarchy built. %d entrances. Hierarchy data: %.2f KB."),
+                *GetName(), ClusterHierarchy.NumAbstractNodes(), ClusterHierarchy.GetAllocatedSize() / 1024.0);
+        }
+
+        TraversableBricks.Build(Grid);
+
+        // Derived from the finished grid, so baked data does not need to carry them.
+        GridLayers.Build(Grid, NumCoarseResolutionLayers, MinSharedNeighborAxes);
+        if (GridLayers.NumCoarseLevels() > 0) {
+            UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): BeginPlay - %d coarse resolution layers built. Layer data: %.2f KB."),
+                *GetName(), GridLayers.NumCoarseLevels(), GridLayers.GetAllocatedSize() / 1024.0);
+        }
+
+        if (NumHeuristicLandmarks > 0 && !bLoadedFromBake) {
+            Landmarks.Build(Grid, NumHeuristicLandmarks, SearchContextPool);
+        }
+        if (!Landmarks.IsEmpty()) {
+            UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): BeginPlay - %d heuristic landmarks ready. Landmark data: %.2f KB."),
+                *GetName(), Landmarks.Num(), Landmarks.GetAllocatedSize() / 1024.0);
         }
     }
-    UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): BeginPlay - Node neighbor population finished."), *GetName());
 
-    PrecomputeNodeTraversability();
+    SearchContextPool.Empty();
+    PathCache.Empty(PathCacheCapacity);
+    ++NavDataVersion;
+    PathCacheHits = 0;
+    PathCacheMisses = 0;
+    PathQueriesCoalesced = 0;
+    UpdateNavigationDataMemoryStat();
     bNodesInitializedAndFinalized = true;
-    AtomicPathfindingSearchIDCounter.store(0);
     UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): BeginPlay - Initialization complete and finalized."), *GetName());
 }
 
-NavNode* ANavigationVolume3D::GetNode(FIntVector Coordinates) {
-    FIntVector ClampedCoords = Coordinates;
-    ClampCoordinates(ClampedCoords); 
+bool ANavigationVolume3D::LoadBakedNavigationData()
+{
+    if (!BakedData) {
+        return false;
+    }
+
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::LoadBakedNavigationData"));
+    const double StartTime = FPlatformTime::Seconds();
+    if (!BakedData->Load(ComputeBakeSettingsHash(), ComputeObstacleGeometryHash(), Grid, ClusterHierarchy, Landmarks)) {
+        UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D (%s): Baked navigation data %s is stale or unreadable. Falling back to the runtime bake."),
+            *GetName(), *BakedData->GetName());
+        return false;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): Loaded baked navigation data %s in %.2f ms. Grid data: %.2f KB."),
+        *GetName(), *BakedData->GetName(), (FPlatformTime::Seconds() - StartTime) * 1000.0, Grid.GetAllocatedSize() / 1024.0);
+    return true;
+}
+
+void ANavigationVolume3D::BakeNavigationData()
+{
+    if (BakeNavigationDataToAsset()) {
+        BakedData->MarkPackageDirty();
+    }
+}
+
+bool ANavigationVolume3D::BakeNavigationDataToAsset()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::BakeNavigationDataToAsset"));
+
+    if (!BakedData) {
+        UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D (%s): Assign a BakedData asset before baking."), *GetName());
+        return false;
+    }
+    if (NavigationBackend != ENavigationVolumeBackend::DenseGrid) {
+        UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D (%s): Offline bakes need the dense grid backend."), *GetName());
+        return false;
+    }
+    if (bNodesInitializedAndFinalized || PendingTraversabilityBake.IsValid()) {
+        UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D (%s): Bake from the editor world, not a playing one."), *GetName());
+        return false;
+    }
+    if (GetTotalDivisions() <= 0) {
+        return false;
+    }
+
+    // The bake borrows the runtime containers; outside of play nothing else uses them.
+    bCancelTraversabilityBake = false;
+    Grid.Initialize(DivisionsX, DivisionsY, DivisionsZ, MinSharedNeighborAxes);
+    PrecomputeNodeTraversability();
+    Grid.RebuildNeighborMasks();
+    Grid.RebuildClearance();
+    Grid.RebuildNearestTraversable();
+    if (bUseHierarchicalPathfinding) {
+        ClusterHierarchy.Build(Grid, HierarchicalClusterSize, SearchContextPool);
+    }
+    Landmarks.Build(Grid, NumHeuristicLandmarks, SearchContextPool);
+
+    BakedData->Modify();
+    BakedData->Store(ComputeBakeSettingsHash(), ComputeObstacleGeometryHash(), Grid, ClusterHierarchy, Landmarks);
+    UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): Baked %d of %d cells traversable into %s."),
+        *GetName(), Grid.CountTraversable(), Grid.Num(), *BakedData->GetPathName());
+
+    Grid.Empty();
+    ClusterHierarchy.Empty();
+    Landmarks.Empty();
+    SearchContextPool.Empty();
+    return true;
+}
+
+UNavigationVolume3DBakeData* ANavigationVolume3D::GetBakedData() const
+{
+    return BakedData;
+}
+
+uint32 ANavigationVolume3D::ComputeBakeSettingsHash() const
+{
+    const FTransform& VolumeTransform = GetActorTransform();
+    const FVector Placement[3] = { VolumeTransform.GetLocation(), VolumeTransform.GetRotation().Euler(), VolumeTransform.GetScale3D() };
+    const int32 GridSettings[7] = { DivisionsX, DivisionsY, DivisionsZ, MinSharedNeighborAxes, bUseHierarchicalPathfinding ? HierarchicalClusterSize : 0,
+        NumHeuristicLandmarks, static_cast<int32>(UNavigationVolume3DBakeData::FormatVersion) };
+
+    uint32 Hash = FCrc::MemCrc32(Placement, sizeof(Placement));
+    Hash = FCrc::MemCrc32(GridSettings, sizeof(GridSettings), Hash);
+    Hash = FCrc::MemCrc32(&DivisionSize, sizeof(DivisionSize), Hash);
+    Hash = FCrc::MemCrc32(ObstacleObjectTypes.GetData(), ObstacleObjectTypes.Num() * ObstacleObjectTypes.GetTypeSize(), Hash);
+    if (ObstacleActorClassFilter) {
+        Hash = FCrc::StrCrc32(*ObstacleActorClassFilter->GetPathName(), Hash);
+    }
+    return Hash;
+}
+
+uint32 ANavigationVolume3D::ComputeObstacleGeometryHash() const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::ComputeObstacleGeometryHash"));
 
-    if (DivisionsX <= 0 || DivisionsY <= 0 || DivisionsZ <= 0) {
-        return nullptr;
+    const UWorld* World = GetWorld();
+    const FCollisionObjectQueryParams ObjectParams(ObstacleObjectTypes);
+    if (!World || !ObjectParams.IsValid()) {
+        return 0;
     }
-    if (Nodes.IsEmpty()) { 
-        return nullptr;
+
+    // One broadphase query over the whole volume; bounds are rounded to whole units so editor and cooked
+    // builds agree on them.
+    const FVector GridExtent = FVector(DivisionsX, DivisionsY, DivisionsZ);
+    const FVector HalfExtent = GridExtent * (DivisionSize * 0.5f) * GetActorScale3D().GetAbs();
+    TArray<FOverlapResult> Overlaps;
+    World->OverlapMultiByObjectType(Overlaps, ConvertCellSpaceToLocation(GridExtent * 0.5f), GetActorQuat(), ObjectParams,
+        FCollisionShape::MakeBox(HalfExtent), FCollisionQueryParams(SCENE_QUERY_STAT(NavigationVolume3DBakeHash), false));
+
+    TArray<uint32> ComponentHashes;
+    for (const FOverlapResult& Overlap : Overlaps) {
+        const UPrimitiveComponent* Component = Overlap.GetComponent();
+        if (!Component || Component->Mobility == EComponentMobility::Movable) {
+            continue;
+        }
+        const AActor* Owner = Component->GetOwner();
+        if (ObstacleActorClassFilter && !(Owner && Owner->IsA(ObstacleActorClassFilter))) {
+            continue;
+        }
+        const FBox Bounds = Component->Bounds.GetBox();
+        const int32 RoundedBounds[6] = {
+            FMath::RoundToInt(Bounds.Min.X), FMath::RoundToInt(Bounds.Min.Y), FMath::RoundToInt(Bounds.Min.Z),
+            FMath::RoundToInt(Bounds.Max.X), FMath::RoundToInt(Bounds.Max.Y), FMath::RoundToInt(Bounds.Max.Z) };
+        ComponentHashes.Add(FCrc::MemCrc32(RoundedBounds, sizeof(RoundedBounds)));
     }
+    ComponentHashes.Sort();
+    return FCrc::MemCrc32(ComponentHashes.GetData(), ComponentHashes.Num() * sizeof(uint32));
+}
 
-    const int32 Index = (ClampedCoords.Z * (DivisionsX * DivisionsY)) + (ClampedCoords.Y * DivisionsX) + ClampedCoords.X;
+float ANavigationVolume3D::GetNavigationBuildProgress() const
+{
+    if (bNodesInitializedAndFinalized) {
+        return 1.0f;
+    }
+    const int32 Total = BakeBlockTotal.load(std::memory_order_relaxed);
+    return Total > 0 ? static_cast<float>(BakedBlockCount.load(std::memory_order_relaxed)) / Total : 0.0f;
+}
 
-    if (!Nodes.IsValidIndex(Index)) {
-        UE_LOG(LogTemp, Error, TEXT("ANavigationVolume3D::GetNode - Calculated Index %d is OUT OF BOUNDS for Nodes array (Size: %d). Original Coords: %s, Clamped: %s, Divisions: %d,%d,%d"),
-               Index, Nodes.Num(), *Coordinates.ToString(), *ClampedCoords.ToString(), DivisionsX, DivisionsY, DivisionsZ);
-        ensureMsgf(false, TEXT("GetNode: Calculated Index is out of bounds!"));
-        return nullptr;
+NavNode ANavigationVolume3D::GetNode(FIntVector Coordinates) const {
+    if (Grid.IsEmpty()) {
+        return NavNode();
     }
-    return &Nodes[Index];
+
+    const FIntVector GridSize = Grid.GetSize();
+    const FIntVector ClampedCoords(
+        FMath::Clamp(Coordinates.X, 0, GridSize.X - 1),
+        FMath::Clamp(Coordinates.Y, 0, GridSize.Y - 1),
+        FMath::Clamp(Coordinates.Z, 0, GridSize.Z - 1));
+
+    const int32 Index = Grid.ToIndex(ClampedCoords);
+    return NavNode(Index, ClampedCoords, Grid.IsTraversable(Index));
 }
 
-const NavNode* ANavigationVolume3D::GetConstNode(FIntVector Coordinates) const {
-    FIntVector ClampedCoords = Coordinates;
-    ClampCoordinates(ClampedCoords);
+NavNode ANavigationVolume3D::GetConstNode(FIntVector Coordinates) const {
+    return GetNode(Coordinates);
+}
 
-    if (DivisionsX <= 0 || DivisionsY <= 0 || DivisionsZ <= 0) return nullptr;
-    if (Nodes.IsEmpty()) return nullptr;
-    
-    const int32 Index = (ClampedCoords.Z * (DivisionsX * DivisionsY)) + (ClampedCoords.Y * DivisionsX) + ClampedCoords.X;
+bool ANavigationVolume3D::IsNavigationDataReady() const
+{
+    if (!bNodesInitializedAndFinalized) {
+        return false;
+    }
+    return NavigationBackend == ENavigationVolumeBackend::SparseOctree ? !Octree.IsEmpty() : !Grid.IsEmpty();
+}
+
+bool ANavigationVolume3D::IsCellTraversable(const FIntVector& Coordinates) const
+{
+    if (NavigationBackend == ENavigationVolumeBackend::SparseOctree) {
+        return Octree.FindLeaf(Coordinates) != INDEX_NONE;
+    }
+    return Grid.IsInBounds(Coordinates) && Grid.IsTraversable(Grid.ToIndex(Coordinates));
+}
+
+int32 ANavigationVolume3D::ResolveBlockedCell(const FIntVector& Coordinates, const FVector& OriginalLocation) const
+{
+    const int32 ResolvedIndex = Grid.FindNearestTraversable(Grid.ToIndex(Coordinates));
+    if (ResolvedIndex == INDEX_NONE
+        || FVector::DistSquared(OriginalLocation, ConvertCoordinatesToLocation(Grid.ToCoordinates(ResolvedIndex))) > FMath::Square(BlockedEndpointResolveRadius)) {
+        return INDEX_NONE;
+    }
+    return ResolvedIndex;
+}
+
+bool ANavigationVolume3D::IsCellFreeForAgent(const FIntVector& Coordinates, uint8 MinClearance) const
+{
+    if (!AreCoordinatesValid(Coordinates) || !IsCellTraversable(Coordinates)) {
+        return false;
+    }
+    return MinClearance <= 1 || !Grid.HasClearance() || Grid.GetClearance(Grid.ToIndex(Coordinates)) >= MinClearance;
+}
+
+FVector ANavigationVolume3D::ConvertCellSpaceToLocation(const FVector& CellSpacePosition) const
+{
+    return GetActorTransform().TransformPosition(CellSpacePosition * DivisionSize);
+}
+
+int32 ANavigationVolume3D::FindNearestOctreeLeaf(const FIntVector& Coordinates, int32 SearchRadiusInCells) const
+{
+    const int32 ContainingLeaf = Octree.FindLeaf(Coordinates);
+    if (ContainingLeaf != INDEX_NONE) {
+        return ContainingLeaf;
+    }
+
+    TArray<int32> CandidateLeaves;
+    Octree.GatherLeavesInBox(Coordinates - FIntVector(SearchRadiusInCells), Coordinates + FIntVector(SearchRadiusInCells), CandidateLeaves);
+
+    const FVector CellCenter = FVector(Coordinates) + FVector(0.5f);
+    int32 BestLeaf = INDEX_NONE;
+    float BestDistanceSquared = std::numeric_limits<float>::max();
+    for (const int32 LeafIndex : CandidateLeaves) {
+        // Distance to the closest point of the leaf, not its centre, so big leaves next to the cell win.
+        const FNavOctree::FLeaf& Leaf = Octree.GetLeaf(LeafIndex);
+        const FBox LeafBox(FVector(Leaf.Min), FVector(Leaf.Min + FIntVector(Leaf.Size)));
+        const float DistanceSquared = LeafBox.ComputeSquaredDistanceToPoint(CellCenter);
+        if (DistanceSquared < BestDistanceSquared) {
+            BestDistanceSquared = DistanceSquared;
+            BestLeaf = LeafIndex;
+        }
+    }
+    return BestLeaf;
+}
+
+bool ANavigationVolume3D::IsCellBlockedByObstacles(const FIntVector& Coordinates) const
+{
+    if (ObstacleObjectTypes.Num() == 0 && ObstacleActorClassFilter == nullptr) {
+        return false;
+    }
+    return IsWorldBoxBlocked(ConvertCoordinatesToLocation(Coordinates), FVector(DivisionSize * 0.45f));
+}
+
+bool ANavigationVolume3D::IsWorldBoxBlocked(const FVector& WorldCenter, const FVector& HalfExtent) const
+{
+    // Same query BoxOverlapActors runs, minus its per-call actor array. Scene queries are safe from worker threads.
+    const UWorld* World = GetWorld();
+    const FCollisionObjectQueryParams ObjectParams(ObstacleObjectTypes);
+    if (!World || !ObjectParams.IsValid()) {
+        return false;
+    }
+
+    const FCollisionShape Box = FCollisionShape::MakeBox(HalfExtent);
+    const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(NavigationVolume3DBake), false);
+    if (!ObstacleActorClassFilter) {
+        return World->OverlapAnyTestByObjectType(WorldCenter, FQuat::Identity, ObjectParams, Box, QueryParams);
+    }
+
+    TArray<FOverlapResult> Overlaps;
+    World->OverlapMultiByObjectType(Overlaps, WorldCenter, FQuat::Identity, ObjectParams, Box, QueryParams);
+    for (const FOverlapResult& Overlap : Overlaps) {
+        const AActor* OverlapActor = Overlap.GetActor();
+        if (OverlapActor && OverlapActor->IsA(ObstacleActorClassFilter)) {
+            return true;
+        }
+    }
+    return false;
+}
 
-    if (!Nodes.IsValidIndex(Index)) {
-         UE_LOG(LogTemp, Error, TEXT("ANavigationVolume3D::GetConstNode - Calculated Index %d is OUT OF BOUNDS for Nodes array (Size: %d). Original Coords: %s, Clamped: %s, Divisions: %d,%d,%d"),
-               Index, Nodes.Num(), *Coordinates.ToString(), *ClampedCoords.ToString(), DivisionsX, DivisionsY, DivisionsZ);
-        ensureMsgf(false, TEXT("GetConstNode: Calculated Index is out of bounds!"));
-        return nullptr;
+void ANavigationVolume3D::UpdateNavigationDataMemoryStat()
+{
+    const int64 NavigationDataBytes = static_cast<int64>(Grid.GetAllocatedSize() + Octree.GetAllocatedSize()
+        + ClusterHierarchy.GetAllocatedSize() + Landmarks.GetAllocatedSize() + TraversableBricks.GetAllocatedSize() + GridLayers.GetAllocatedSize());
+    FNavQueryTelemetry::Get().AddNavigationDataBytes(NavigationDataBytes - ReportedNavigationDataBytes);
+    ReportedNavigationDataBytes = NavigationDataBytes;
+}
+
+void ANavigationVolume3D::BuildSparseOctree()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::BuildSparseOctree"));
+    UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): Building sparse voxel octree..."), *GetName());
+
+    const bool bHasObstacleFilter = ObstacleObjectTypes.Num() > 0 || ObstacleActorClassFilter != nullptr;
+    if (!bHasObstacleFilter) {
+        UE_LOG(LogTemp, Warning, TEXT("ANavigationVolume3D (%s): No ObstacleObjectTypes or ObstacleActorClassFilter specified. All nodes considered traversable by overlap."), *GetName());
     }
-    return &Nodes[Index];
+
+    Octree.Build(FIntVector(DivisionsX, DivisionsY, DivisionsZ), [this, bHasObstacleFilter](const FIntVector& Min, int32 Size) {
+        if (!bHasObstacleFilter) {
+            return false;
+        }
+        // Same 10% inset as the per-cell bake, so geometry that only touches a block's faces does not split it.
+        const FVector CellSpaceCenter = FVector(Min) + FVector(Size * 0.5f);
+        const FVector HalfExtent(Size * DivisionSize * 0.5f - DivisionSize * 0.05f);
+        return IsWorldBoxBlocked(ConvertCellSpaceToLocation(CellSpaceCenter), HalfExtent);
+    });
+
+    UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): Sparse octree built. %d free leaves for %d cells. Octree data: %.2f KB."),
+        *GetName(), Octree.NumLeaves(), GetTotalDivisions(), Octree.GetAllocatedSize() / 1024.0);
 }
 
 void ANavigationVolume3D::OnConstruction(const FTransform& Transform)
@@ -677,8 +2554,8 @@ bool ANavigationVolume3D::AreCoordinatesValid(const FIntVector& Coordinates) con
 
 void ANavigationVolume3D::PrecomputeNodeTraversability()
 {
+     TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("ANavigationVolume3D::PrecomputeNodeTraversability"));
      UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): Precomputing node traversability..."), *GetName());
-     int32 NonTraversableCount = 0;
 
      if(ObstacleObjectTypes.Num() == 0 && ObstacleActorClassFilter == nullptr)
      {
@@ -686,31 +2563,68 @@ void ANavigationVolume3D::PrecomputeNodeTraversability()
          return;
      }
 
-     const FVector HalfBoxExtent(DivisionSize * 0.45f);
-     TArray<AActor*> ActorsToIgnore; 
-     TArray<AActor*> OutActors;
+     // One overlap per 4x4x4 block first; only blocks that hit something are tested cell by cell. The block box
+     // keeps the per-cell 5% inset on its outer faces, so it contains every cell box inside it and a clear block
+     // means clear cells. Each block reports its blocked cells as one 64-bit mask, so workers never share grid words.
+     constexpr int32 BlockSize = 4;
+     const FIntVector GridSize = Grid.GetSize();
+     const FIntVector NumBlocks(
+         FMath::DivideAndRoundUp(GridSize.X, BlockSize),
+         FMath::DivideAndRoundUp(GridSize.Y, BlockSize),
+         FMath::DivideAndRoundUp(GridSize.Z, BlockSize));
+     const int32 TotalBlocks = NumBlocks.X * NumBlocks.Y * NumBlocks.Z;
+     BakeBlockTotal = TotalBlocks;
+
+     TArray<uint64> BlockedCellMasks;
+     BlockedCellMasks.SetNumZeroed(TotalBlocks);
+     std::atomic<int32> NumCoarseHits = 0;
+
+     ParallelFor(TotalBlocks, [&](int32 BlockIndex)
+     {
+         if (bCancelTraversabilityBake.load(std::memory_order_relaxed)) {
+             return;
+         }
+
+         const FIntVector Block(BlockIndex % NumBlocks.X, (BlockIndex / NumBlocks.X) % NumBlocks.Y, BlockIndex / (NumBlocks.X * NumBlocks.Y));
+         const FIntVector BlockMin = Block * BlockSize;
+         const FIntVector BlockCells(
+             FMath::Min(BlockSize, GridSize.X - BlockMin.X),
+             FMath::Min(BlockSize, GridSize.Y - BlockMin.Y),
+             FMath::Min(BlockSize, GridSize.Z - BlockMin.Z));
+
+         const FVector CellSpaceCenter = FVector(BlockMin) + FVector(BlockCells) * 0.5f;
+         const FVector HalfExtent = FVector(BlockCells) * (DivisionSize * 0.5f) - FVector(DivisionSize * 0.05f);
+         if (IsWorldBoxBlocked(ConvertCellSpaceToLocation(CellSpaceCenter), HalfExtent)) {
+             NumCoarseHits.fetch_add(1, std::memory_order_relaxed);
+             uint64 BlockedMask = 0;
+             for (int32 Z = 0; Z < BlockCells.Z; ++Z) {
+                 for (int32 Y = 0; Y < BlockCells.Y; ++Y) {
+                     for (int32 X = 0; X < BlockCells.X; ++X) {
+                         if (IsCellBlockedByObstacles(BlockMin + FIntVector(X, Y, Z))) {
+                             BlockedMask |= 1ull << ((Z * BlockSize + Y) * BlockSize + X);
+                         }
+                     }
+                 }
+             }
+             BlockedCellMasks[BlockIndex] = BlockedMask;
+         }
+         BakedBlockCount.fetch_add(1, std::memory_order_relaxed);
+     });
 
-     for (NavNode& NodeToCheck : Nodes)
+     int32 NonTraversableCount = 0;
+     for (int32 BlockIndex = 0; BlockIndex < TotalBlocks; ++BlockIndex)
      {
-         const FVector WorldLocation = ConvertCoordinatesToLocation(NodeToCheck.Coordinates);
-         OutActors.Empty(); 
-
-         bool bOverlapped = UKismetSystemLibrary::BoxOverlapActors(
-             this, 
-             WorldLocation,
-             HalfBoxExtent,
-             ObstacleObjectTypes,
-             ObstacleActorClassFilter,
-             ActorsToIgnore,
-             OutActors
-         );
-
-         NodeToCheck.bIsTraversable = !bOverlapped;
-         if (!NodeToCheck.bIsTraversable) {
-             NonTraversableCount++;
+         uint64 BlockedMask = BlockedCellMasks[BlockIndex];
+         const FIntVector BlockMin = FIntVector(BlockIndex % NumBlocks.X, (BlockIndex / NumBlocks.X) % NumBlocks.Y, BlockIndex / (NumBlocks.X * NumBlocks.Y)) * BlockSize;
+         while (BlockedMask != 0) {
+             const int32 Bit = FMath::CountTrailingZeros64(BlockedMask);
+             BlockedMask &= BlockedMask - 1;
+             Grid.SetTraversable(Grid.ToIndex(BlockMin + FIntVector(Bit % BlockSize, (Bit / BlockSize) % BlockSize, Bit / (BlockSize * BlockSize))), false);
+             ++NonTraversableCount;
          }
      }
-     UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): Traversability precomputation complete. Found %d non-traversable nodes."), *GetName(), NonTraversableCount);
+     UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): Traversability precomputation complete. Found %d non-traversable nodes. %d of %d blocks needed per-cell tests."),
+         *GetName(), NonTraversableCount, NumCoarseHits.load(), TotalBlocks);
 }
 
 void ANavigationVolume3D::CreateLine(const FVector& Start, const FVector& End, const FVector& Normal, TArray<FVector>& Vertices, TArray<int32>& Triangles)
@@ -794,20 +2708,35 @@ FVector ANavigationVolume3D::ConvertCoordinatesToLocation(const FIntVector& Coor
 
 void ANavigationVolume3D::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-    UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): EndPlay called. Node count before empty: %d. Initialized: %s"), 
-        *GetName(), Nodes.Num(), bNodesInitializedAndFinalized ? TEXT("true") : TEXT("false"));
-    
-    if (bNodesInitializedAndFinalized)
-    {
-        for (NavNode& Node : Nodes)
-        {
-            Node.Neighbors.clear();
-        }
+    CancelAllPathQueries();
+    CancelFlowFieldBuilds();
+    if (PendingTraversabilityBake.IsValid()) {
+        bCancelTraversabilityBake = true;
+        PendingTraversabilityBake.Wait();
+        PendingTraversabilityBake.Reset();
     }
+    if (PendingTraversabilityUpdate.IsValid()) {
+        PendingTraversabilityUpdate.Wait();
+        PendingTraversabilityUpdate.Reset();
+    }
+    PendingDirtyRegions.Empty();
 
-    Nodes.Empty();
-
-    UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): Nodes array emptied. Node count after empty: %d"), *GetName(), Nodes.Num());
+    UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): EndPlay called. Node count before empty: %d. Initialized: %s"), 
+        *GetName(), Grid.Num(), bNodesInitializedAndFinalized ? TEXT("true") : TEXT("false"));
+
+    Grid.Empty();
+    Octree.Empty();
+    ClusterHierarchy.Empty();
+    Landmarks.Empty();
+    TraversableBricks.Empty();
+    GridLayers.Empty();
+    SearchContextPool.Empty();
+    PathCache.Empty();
+    PathPool.Empty();
+    SearchTraceRecorder.Empty();
+    UpdateNavigationDataMemoryStat();
+
+    UE_LOG(LogTemp, Log, TEXT("ANavigationVolume3D (%s): Nodes array emptied. Node count after empty: %d"), *GetName(), Grid.Num());
     
     bNodesInitializedAndFinalized = false;
     Super::EndPlay(EndPlayReason);
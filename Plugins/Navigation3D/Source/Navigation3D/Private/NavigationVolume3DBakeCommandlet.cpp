@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NavigationVolume3DBakeCommandlet.h"
+#include "NavigationVolume3D.h"
+#include "NavigationVolume3DBakeData.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+int32 UNavigationVolume3DBakeCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+    FString MapName;
+    if (!FParse::Value(*Params, TEXT("Map="), MapName))
+    {
+        UE_LOG(LogTemp, Error, TEXT("NavigationVolume3DBake: Missing -Map=<package path>."));
+        return 1;
+    }
+
+    UPackage* MapPackage = LoadPackage(nullptr, *MapName, LOAD_None);
+    UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+    if (!World)
+    {
+        UE_LOG(LogTemp, Error, TEXT("NavigationVolume3DBake: Could not load map %s."), *MapName);
+        return 1;
+    }
+
+    // The bake runs overlap queries, so the world needs a physics scene with its components registered.
+    World->WorldType = EWorldType::Editor;
+    World->AddToRoot();
+    if (!World->bIsWorldInitialized)
+    {
+        World->InitWorld(UWorld::InitializationValues()
+            .CreatePhysicsScene(true)
+            .ShouldSimulatePhysics(false)
+            .EnableTraceCollision(true)
+            .CreateNavigation(false)
+            .CreateAISystem(false)
+            .AllowAudioPlayback(false));
+    }
+    World->UpdateWorldComponents(true, false);
+
+    TArray<UPackage*> PackagesToSave;
+    for (TActorIterator<ANavigationVolume3D> It(World); It; ++It)
+    {
+        if (It->BakeNavigationDataToAsset())
+        {
+            PackagesToSave.AddUnique(It->GetBakedData()->GetPackage());
+        }
+    }
+
+    int32 NumFailed = 0;
+    for (UPackage* Package : PackagesToSave)
+    {
+        const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+        FSavePackageArgs SaveArgs;
+        SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+        if (!UPackage::SavePackage(Package, nullptr, *Filename, SaveArgs))
+        {
+            UE_LOG(LogTemp, Error, TEXT("NavigationVolume3DBake: Failed to save %s."), *Filename);
+            ++NumFailed;
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("NavigationVolume3DBake: Saved %d bake assets for %s."), PackagesToSave.Num() - NumFailed, *MapName);
+    World->RemoveFromRoot();
+    World->DestroyWorld(false);
+    return NumFailed > 0 ? 1 : 0;
+#else
+    UE_LOG(LogTemp, Error, TEXT("NavigationVolume3DBake: Only available in editor builds."));
+    return 1;
+#endif
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "NavigationVolume3DBakeCommandlet.generated.h"
+
+// Bakes every ANavigationVolume3D in a map into its BakedData asset and saves those assets.
+// Usage: UnrealEditor-Cmd <Project> -run=NavigationVolume3DBake -Map=/Game/Maps/MyMap
+UCLASS()
+class UNavigationVolume3DBakeCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NavigationVolume3DBakeData.h"
+#include "NavGrid.h"
+#include "NavHierarchy.h"
+#include "NavLandmarks.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+void UNavigationVolume3DBakeData::Serialize(FArchive& Ar)
+{
+    Super::Serialize(Ar);
+    Payload.Serialize(Ar, this);
+}
+
+void UNavigationVolume3DBakeData::Store(uint32 SettingsHash, uint32 GeometryHash, FNavGrid& Grid, FNavClusterHierarchy& Hierarchy, FNavLandmarks& Landmarks)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("UNavigationVolume3DBakeData::Store"));
+
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+    uint32 HeaderMagic = Magic;
+    uint32 HeaderVersion = FormatVersion;
+    Writer << HeaderMagic << HeaderVersion << SettingsHash << GeometryHash;
+    Grid.Serialize(Writer);
+    bool bHasHierarchy = !Hierarchy.IsEmpty();
+    Writer << bHasHierarchy;
+    if (bHasHierarchy)
+    {
+        Hierarchy.Serialize(Writer);
+    }
+    bool bHasLandmarks = !Landmarks.IsEmpty();
+    Writer << bHasLandmarks;
+    if (bHasLandmarks)
+    {
+        Landmarks.Serialize(Writer);
+    }
+
+    Payload.Lock(LOCK_READ_WRITE);
+    FMemory::Memcpy(Payload.Realloc(Bytes.Num()), Bytes.GetData(), Bytes.Num());
+    Payload.Unlock();
+
+    BakedGridSize = Grid.GetSize();
+    BakedTraversableCells = Grid.CountTraversable();
+    PayloadSizeBytes = Bytes.Num();
+    BakeTime = FDateTime::UtcNow();
+}
+
+bool UNavigationVolume3DBakeData::Load(uint32 SettingsHash, uint32 GeometryHash, FNavGrid& OutGrid, FNavClusterHierarchy& OutHierarchy, FNavLandmarks& OutLandmarks)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(TEXT("UNavigationVolume3DBakeData::Load"));
+
+    if (!HasPayload())
+    {
+        return false;
+    }
+
+    const uint8* Data = static_cast<const uint8*>(Payload.LockReadOnly());
+    FMemoryReaderView Reader(TArrayView<const uint8>(Data, static_cast<int32>(Payload.GetBulkDataSize())));
+
+    uint32 HeaderMagic = 0;
+    uint32 HeaderVersion = 0;
+    uint32 BakedSettingsHash = 0;
+    uint32 BakedGeometryHash = 0;
+    Reader << HeaderMagic << HeaderVersion << BakedSettingsHash << BakedGeometryHash;
+
+    bool bLoaded = false;
+    if (!Reader.IsError() && HeaderMagic == Magic && HeaderVersion == FormatVersion && BakedSettingsHash == SettingsHash && BakedGeometryHash == GeometryHash)
+    {
+        OutGrid.Serialize(Reader);
+        bool bHasHierarchy = false;
+        Reader << bHasHierarchy;
+        OutHierarchy.Empty();
+        if (bHasHierarchy)
+        {
+            OutHierarchy.Serialize(Reader);
+        }
+        bool bHasLandmarks = false;
+        Reader << bHasLandmarks;
+        OutLandmarks.Empty();
+        if (bHasLandmarks)
+        {
+            OutLandmarks.Serialize(Reader);
+        }
+        bLoaded = !Reader.IsError() && (OutLandmarks.IsEmpty() || OutLandmarks.NumTableCells() == OutGrid.Num());
+    }
+    Payload.Unlock();
+
+    if (!bLoaded)
+    {
+        OutGrid.Empty();
+        OutHierarchy.Empty();
+        OutLandmarks.Empty();
+    }
+    return bLoaded;
+}
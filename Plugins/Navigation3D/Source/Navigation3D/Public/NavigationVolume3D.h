@@ -3,12 +3,27 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "NavNode.h"
+#include "NavGrid.h"
+#include "NavOctree.h"
+#include "NavHierarchy.h"
+#include "NavLandmarks.h"
+#include "NavBrickIndex.h"
+#include "NavGridLayers.h"
+#include "NavJumpPoint.h"
+#include "NavFlowField.h"
+#include "NavSearchContext.h"
+#include "NavPathPool.h"
+#include "NavSearchTrace.h"
+#include "Containers/Queue.h"
+#include "Containers/LruCache.h"
+#include "Async/Future.h"
 #include <atomic>
 #include "NavigationVolume3D.generated.h"
 
 
 class UProceduralMeshComponent;
 class UMaterialInterface;
+class UNavigationVolume3DBakeData;
 
 UENUM(BlueprintType)
 enum class ENavigationVolumeResult : uint8
@@ -22,7 +37,87 @@ enum class ENavigationVolumeResult : uint8
     ENVR_PathToSelf              UMETA(DisplayName = "Path to self"),
     ENVR_VolumeNotReady          UMETA(DisplayName = "Navigation Volume Not Ready"),
     ENVR_RequestingActorInvalid  UMETA(DisplayName = "Requesting Actor Invalid"),
-    ENVR_UnknownError            UMETA(DisplayName = "Unknown Error")
+    ENVR_UnknownError            UMETA(DisplayName = "Unknown Error"),
+    // Values are stored and replicated as raw bytes, so new results go last.
+    ENVR_Cancelled               UMETA(DisplayName = "Query Cancelled"),
+    ENVR_PartialPath             UMETA(DisplayName = "Partial Path (Search Budget Exhausted)")
+};
+
+UENUM(BlueprintType)
+enum class ENavigationVolumeBackend : uint8
+{
+    // One voxel per cell. Cheapest queries, memory grows with the full volume.
+    DenseGrid     UMETA(DisplayName = "Dense Grid"),
+    // Empty space collapses into large octree leaves; only cells near obstacles are kept at full resolution.
+    SparseOctree  UMETA(DisplayName = "Sparse Voxel Octree")
+};
+
+UENUM(BlueprintType)
+enum class ENavPathSearchAlgorithm : uint8
+{
+    // Use the volume's DefaultSearchAlgorithm.
+    VolumeDefault  UMETA(DisplayName = "Volume Default"),
+    AStar          UMETA(DisplayName = "A*"),
+    // Same optimal paths as A*, skipping symmetric expansions along straight runs. How much that saves depends on
+    // the layout; compare with Navigation3D.Benchmark.Search. Dense grid with MinSharedNeighborAxes = 0 only; falls
+    // back to A* otherwise.
+    JumpPoint      UMETA(DisplayName = "Jump Point Search"),
+    // Same optimal paths as A*, searching from both ends so long open routes explore two small balls instead of
+    // one large one. Dense grid only; clearance-aware and budgeted queries fall back to A*.
+    Bidirectional  UMETA(DisplayName = "Bidirectional A*")
+};
+
+UENUM(BlueprintType)
+enum class ENavPathSmoothing : uint8
+{
+    // Use the volume's DefaultPathSmoothing.
+    VolumeDefault  UMETA(DisplayName = "Volume Default"),
+    // Every cell (or octree portal) the search visited.
+    None           UMETA(DisplayName = "None"),
+    // Drops waypoints that a voxel line-of-sight test shows are not needed.
+    LineOfSight    UMETA(DisplayName = "Line Of Sight")
+};
+
+UENUM(BlueprintType)
+enum class ENavPathBudgetAction : uint8
+{
+    // Stop and return the path toward the explored cell closest to the goal, as ENVR_PartialPath.
+    ReturnPartialPath       UMETA(DisplayName = "Return Partial Path"),
+    // Hand the worker back and continue the same search in a later slice. Only the final result is delivered.
+    ContinueNextSlice       UMETA(DisplayName = "Continue Next Slice"),
+    // Deliver each slice's partial path, then continue. The callback runs once per slice and once at the end.
+    PartialPathAndContinue  UMETA(DisplayName = "Partial Path And Continue")
+};
+
+// Per-query settings for FindPathAsyncWithOptions.
+USTRUCT(BlueprintType)
+struct FNavPathQueryOptions
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding")
+    ENavPathSearchAlgorithm SearchAlgorithm = ENavPathSearchAlgorithm::VolumeDefault;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding")
+    ENavPathSmoothing Smoothing = ENavPathSmoothing::VolumeDefault;
+
+    // Radius of the agent in world units. Dense grid only: the path keeps at least this much space to obstacles,
+    // except at its own start and goal cells. 0 treats the agent as a point.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding", meta = (ClampMin = 0.0, UIMin = 0.0))
+    float AgentRadius = 0.0f;
+
+    // Dense grid only: cell expansions the search may spend per slice. 0 for no limit.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding|Budget", meta = (ClampMin = 0, UIMin = 0))
+    int32 MaxSearchExpansions = 0;
+
+    // Dense grid only: worker time the search may spend per slice, in milliseconds. 0 for no limit.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding|Budget", meta = (ClampMin = 0.0, UIMin = 0.0))
+    float MaxSearchTimeMs = 0.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding|Budget")
+    ENavPathBudgetAction BudgetExhaustedAction = ENavPathBudgetAction::ReturnPartialPath;
+
+    bool HasSearchBudget() const { return MaxSearchExpansions > 0 || MaxSearchTimeMs > 0.0f; }
 };
 
 USTRUCT()
@@ -45,6 +140,74 @@ struct FDebugSphereData {
 
 DECLARE_DYNAMIC_DELEGATE_TwoParams(FOnPathfindingComplete, ENavigationVolumeResult, Result, const TArray<FVector>&, Path);
 
+// Native completion for FindPathAsyncNative. Path shares the result's pooled buffer instead of copying it; it is
+// null when the query produced no points. Keep the reference for as long as the points are needed.
+DECLARE_DELEGATE_TwoParams(FOnNavPathComplete, ENavigationVolumeResult /*Result*/, const FNavPathRef& /*Path*/);
+
+// One start/goal pair of a FindPathsBatch call.
+USTRUCT(BlueprintType)
+struct FNavPathBatchQuery
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding")
+    FVector StartLocation = FVector::ZeroVector;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding")
+    FVector DestinationLocation = FVector::ZeroVector;
+};
+
+USTRUCT(BlueprintType)
+struct FNavPathBatchResult
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "Pathfinding")
+    ENavigationVolumeResult Result = ENavigationVolumeResult::ENVR_UnknownError;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Pathfinding")
+    TArray<FVector> Path;
+};
+
+// Results are in the order of the batch's queries.
+DECLARE_DYNAMIC_DELEGATE_OneParam(FOnPathBatchComplete, const TArray<FNavPathBatchResult>&, Results);
+
+// Completion of FindRandomValidLocationInRadiusAsync. Location is only meaningful when bFound is set.
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FOnRandomLocationFound, bool, bFound, const FVector&, Location);
+
+// One segment of a RaycastBatch call. Radius > 0 sweeps a sphere instead of a ray.
+USTRUCT(BlueprintType)
+struct FNavGridRaycastQuery
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding")
+    FVector Start = FVector::ZeroVector;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding")
+    FVector End = FVector::ZeroVector;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding")
+    float Radius = 0.0f;
+};
+
+USTRUCT(BlueprintType)
+struct FNavGridRaycastResult
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "Pathfinding")
+    bool bBlocked = false;
+
+    // Where the segment enters the first blocked cell, or End when it is clear.
+    UPROPERTY(BlueprintReadOnly, Category = "Pathfinding")
+    FVector Location = FVector::ZeroVector;
+
+    // Fraction of the segment travelled before Location, 0..1.
+    UPROPERTY(BlueprintReadOnly, Category = "Pathfinding")
+    float Time = 1.0f;
+};
+
 UCLASS()
 class NAVIGATION3D_API ANavigationVolume3D : public AActor
 {
@@ -78,6 +241,27 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Connectivity", meta = (AllowPrivateAccess = "true", ClampMin = 0, ClampMax = 2, UIMin = 0, UIMax = 2))
     int32 MinSharedNeighborAxes = 1;
 
+    // Navigation data layout built in BeginPlay. The octree ignores MinSharedNeighborAxes; its leaves connect through shared faces.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pathfinding", meta = (AllowPrivateAccess = "true"))
+    ENavigationVolumeBackend NavigationBackend = ENavigationVolumeBackend::DenseGrid;
+
+    // Search used by queries that do not pick one themselves.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding", meta = (AllowPrivateAccess = "true"))
+    ENavPathSearchAlgorithm DefaultSearchAlgorithm = ENavPathSearchAlgorithm::AStar;
+
+    // Post-process applied to paths of queries that do not pick one themselves.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding", meta = (AllowPrivateAccess = "true"))
+    ENavPathSmoothing DefaultPathSmoothing = ENavPathSmoothing::None;
+
+    // Dense grid only: extra cost for steps close to obstacles, so paths prefer open space. A step into a cell
+    // N cells from the nearest obstacle costs (1 + OpenSpaceCostWeight / N) times its length. 0 disables it.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding", meta = (AllowPrivateAccess = "true", ClampMin = 0.0, UIMin = 0.0))
+    float OpenSpaceCostWeight = 0.0f;
+
+    // Path endpoints and flow field targets inside blocked cells move to the nearest free cell within this distance.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding", meta = (AllowPrivateAccess = "true", ClampMin = 0.0, UIMin = 0.0))
+    float BlockedEndpointResolveRadius = 300.0f;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Display", meta = (AllowPrivateAccess = "true", ClampMin = 0, UIMin = 0.0))
     float LineThickness = 2.0f;
 
@@ -93,6 +277,67 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding")
     TSubclassOf<AActor> ObstacleActorClassFilter;
 
+    // Dense grid only: bake traversability on worker threads instead of blocking BeginPlay. Queries return
+    // VolumeNotReady until the bake is done; GetNavigationBuildProgress reports how far it got.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pathfinding|Bake", meta = (AllowPrivateAccess = "true"))
+    bool bBakeAsync = false;
+
+    // Dense grid only: offline bake loaded in BeginPlay instead of running the overlap bake. Ignored, with a
+    // fallback to the runtime bake, when the volume's settings or static obstacle geometry no longer match it.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pathfinding|Bake", meta = (AllowPrivateAccess = "true"))
+    TObjectPtr<UNavigationVolume3DBakeData> BakedData;
+
+    // Bakes the grid in the editor world and writes it to BakedData. Save the asset afterwards.
+    UFUNCTION(CallInEditor, Category = "Pathfinding|Bake")
+    void BakeNavigationData();
+
+    // Upper bound on path queries running on the worker pool at once. Further requests wait in the priority queue.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding|Scheduling", meta = (AllowPrivateAccess = "true", ClampMin = 1, UIMin = 1))
+    int32 MaxConcurrentPathQueries = 4;
+
+    // Game-thread time per frame spent dispatching queued queries and delivering completed ones.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding|Scheduling", meta = (AllowPrivateAccess = "true", ClampMin = 0.0, UIMin = 0.0))
+    float PathQueryFrameBudgetMs = 1.0f;
+
+    // Finished results kept for repeated queries between the same start and goal cells. 0 disables the cache.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pathfinding|Scheduling", meta = (AllowPrivateAccess = "true", ClampMin = 0, UIMin = 0))
+    int32 PathCacheCapacity = 128;
+
+    // Dense grid only: search a cluster-level graph first and refine inside the clusters it passes through. Off by
+    // default because its paths are near-optimal rather than shortest: they pass through one entrance cell per
+    // cluster opening. The 10x cut in expansions per long query it was meant to bring has not been shown: compare
+    // the Hierarchy and AStar rows of the Long query sets in Navigation3D.Benchmark.Search before turning it on.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pathfinding|Hierarchical", meta = (AllowPrivateAccess = "true"))
+    bool bUseHierarchicalPathfinding = false;
+
+    // Edge length of a cluster in cells.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pathfinding|Hierarchical", meta = (AllowPrivateAccess = "true", EditCondition = "bUseHierarchicalPathfinding", ClampMin = 4, UIMin = 4))
+    int32 HierarchicalClusterSize = 16;
+
+    // Queries whose endpoints are closer than this (in cells) use flat A*, which is cheaper for short hops.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding|Hierarchical", meta = (AllowPrivateAccess = "true", EditCondition = "bUseHierarchicalPathfinding", ClampMin = 0, UIMin = 0))
+    int32 HierarchicalMinDistanceCells = 32;
+
+    // Dense grid only: landmark cells whose exact distance tables tighten the A* heuristic (ALT). Each landmark
+    // costs 4 bytes per cell and one flood of the grid at build time; 0 disables them. Tables are dropped when a
+    // dynamic update frees cells, since they could then overestimate, and return with the next full build.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pathfinding|Landmarks", meta = (AllowPrivateAccess = "true", ClampMin = 0, ClampMax = 16, UIMin = 0, UIMax = 16))
+    int32 NumHeuristicLandmarks = 0;
+
+    // Dense grid only: coarser grids at 2x, 4x and 8x the cell size, derived from this volume's own traversability
+    // (a coarse cell is blocked if any cell it covers is), so one bake serves agents of every size. A query whose
+    // AgentRadius is at least half a layer's cell size searches the coarsest such layer, an eighth the cells of the one
+    // below it, and falls back to the full grid if that layer has no route. All layers together cost about a seventh
+    // of the grid's memory.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pathfinding|Layers", meta = (AllowPrivateAccess = "true", ClampMin = 0, ClampMax = 3, UIMin = 0, UIMax = 3))
+    int32 NumCoarseResolutionLayers = 0;
+
+    // Full-resolution A* queries first search the coarsest layer, then expand only the cells near its route, and
+    // search everywhere only if that fails. Far fewer expansions on long routes, but the path is the shortest
+    // inside the corridor rather than overall. Ignored by jump point, bidirectional and budgeted searches.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding|Layers", meta = (AllowPrivateAccess = "true", EditCondition = "NumCoarseResolutionLayers > 0"))
+    bool bSeedSearchFromCoarsestLayer = false;
+
 public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding|Debug")
     bool bDrawPathfindingDebug = false;
@@ -112,7 +357,72 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding|Debug", meta=(EditCondition="bDrawPathfindingDebug"))
     bool bOnlyDrawDebugForLongPaths = false;
 
+    // Number of random start/goal pairs used by BenchmarkSearchAlgorithms.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding|Debug", meta=(ClampMin="1", UIMin="1"))
+    int32 BenchmarkQueryCount = 200;
+
+    // Runs the same random queries with A*, jump point search, bidirectional A* and landmark-guided A* (when landmarks are built) on the game thread and logs time, expansions and any result or cost mismatch against A*.
+    UFUNCTION(CallInEditor, Category = "Pathfinding|Debug")
+    void BenchmarkSearchAlgorithms();
+
+    // Records each searched query (endpoints, close order, result) into a ring buffer for DumpSearchTraces and the
+    // trace replay below. Far cheaper than bDrawPathfindingDebug: 4 bytes per expansion and nothing drawn.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding|Trace")
+    bool bRecordSearchTraces = false;
+
+    // Most recent queries kept; older ones are overwritten.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding|Trace", meta = (EditCondition = "bRecordSearchTraces", ClampMin = 1, UIMin = 1))
+    int32 SearchTraceCapacity = 64;
+
+    // Expansions recorded per query; the rest of a bigger search is dropped and the trace marked truncated.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding|Trace", meta = (EditCondition = "bRecordSearchTraces", ClampMin = 1, UIMin = 1))
+    int32 MaxTracedExpansionsPerQuery = 65536;
+
+    // Dumps the buffer when a path longer than LongPathThreshold is delivered, at most once every ten seconds. The
+    // file is written off the game thread.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding|Trace", meta = (EditCondition = "bRecordSearchTraces"))
+    bool bDumpSearchTracesOnLongPath = false;
+
+    // Writes the recorded traces to Saved/Profiling/Navigation3D. Also available as the console command nav3d.DumpSearchTraces.
+    UFUNCTION(BlueprintCallable, Category = "NavigationVolume3D|Debug")
+    bool DumpSearchTraces(FString& OutFilePath);
+
+    // Trace file to replay against this volume in the editor; its divisions must match.
+    UPROPERTY(EditAnywhere, Category = "Pathfinding|Trace Replay", meta = (FilePathFilter = "nav3dtrace"))
+    FFilePath SearchTraceReplayFile;
+
+    // Query within the file, oldest first.
+    UPROPERTY(EditAnywhere, Category = "Pathfinding|Trace Replay", meta = (ClampMin = 0, UIMin = 0))
+    int32 SearchTraceReplayQuery = 0;
+
+    // Expansions shown so far; set directly to jump, or move with the step buttons.
+    UPROPERTY(EditAnywhere, Category = "Pathfinding|Trace Replay", meta = (ClampMin = 0, UIMin = 0))
+    int32 SearchTraceReplayStep = 0;
+
+    UPROPERTY(EditAnywhere, Category = "Pathfinding|Trace Replay", meta = (ClampMin = 1, UIMin = 1))
+    int32 SearchTraceReplayStepSize = 1;
+
+    // Loads SearchTraceReplayFile and draws SearchTraceReplayQuery up to SearchTraceReplayStep.
+    UFUNCTION(CallInEditor, Category = "Pathfinding|Trace Replay")
+    void LoadSearchTraceReplay();
+
+    UFUNCTION(CallInEditor, Category = "Pathfinding|Trace Replay")
+    void StepSearchTraceReplay();
+
+    UFUNCTION(CallInEditor, Category = "Pathfinding|Trace Replay")
+    void StepBackSearchTraceReplay();
+
+    // Draws every expansion and the delivered path.
+    UFUNCTION(CallInEditor, Category = "Pathfinding|Trace Replay")
+    void ShowWholeSearchTraceReplay();
+
+    UFUNCTION(CallInEditor, Category = "Pathfinding|Trace Replay")
+    void ClearSearchTraceReplay();
+
 public:
+    // Draws up to MaxCandidatesToCollect distinct free cells uniformly from those whose centre lies within WorldRadius
+    // of Origin, then traces from Origin to each in turn and returns the first one in line of sight. Sampling reads
+    // the free cells of the 8x8x8 bricks around Origin, so its cost does not grow with how much of the radius is blocked.
     UFUNCTION(BlueprintCallable, Category = "NavigationVolume3D", meta = (DisplayName = "Find Random Valid Location In Radius"))
     bool FindRandomValidLocationInRadius(
         const FVector& Origin,
@@ -121,9 +431,42 @@ public:
         const AActor* ActorToIgnoreForLOS = nullptr,
         int32 MaxCandidatesToCollect = 30
     ) const;
+
+    // Same sampling, but every candidate's line of sight is traced at once with the async trace API and
+    // OnFoundCallback gets the first sampled candidate in sight. Always answers, on a later frame unless the
+    // volume has no world.
+    UFUNCTION(BlueprintCallable, Category = "NavigationVolume3D", meta = (DisplayName = "Find Random Valid Location In Radius Async"))
+    void FindRandomValidLocationInRadiusAsync(
+        const FVector& Origin,
+        float WorldRadius,
+        FOnRandomLocationFound OnFoundCallback,
+        const AActor* ActorToIgnoreForLOS = nullptr,
+        int32 MaxCandidatesToCollect = 30
+    );
     
+    // Line of sight against the baked cells instead of the physics scene: 3D DDA through every cell the segment
+    // touches, including the neighbours of edges and corners it crosses exactly. Conservative, since any blocked
+    // cell it touches counts as a hit even if the obstacle inside does not reach the line; leaving the volume or
+    // an unready volume counts as blocked too. Returns true on a hit. Reads only navigation data, so it is safe
+    // on the game thread and inside path workers.
+    UFUNCTION(BlueprintCallable, Category = "NavigationVolume3D")
+    bool Raycast(const FVector& Start, const FVector& End, FNavGridRaycastResult& OutResult) const;
+
+    // Raycast for a sphere of Radius: cells along the segment must be at least Radius (rounded up to whole cells)
+    // from every obstacle, the same test a query with that AgentRadius uses.
+    UFUNCTION(BlueprintCallable, Category = "NavigationVolume3D")
+    bool SweepSphere(const FVector& Start, const FVector& End, float Radius, FNavGridRaycastResult& OutResult) const;
+
+    // Raycasts or sweeps every query; OutResults is in the same order. Large batches are spread over the task graph.
+    UFUNCTION(BlueprintCallable, Category = "NavigationVolume3D")
+    void RaycastBatch(const TArray<FNavGridRaycastQuery>& Queries, TArray<FNavGridRaycastResult>& OutResults) const;
+
     virtual void OnConstruction(const FTransform& Transform) override;
-    
+    virtual void Tick(float DeltaSeconds) override;
+
+    // Queues a path query. Queries are ordered by the requester's distance to the player and run on
+    // a bounded worker pool. A new request from the same actor supersedes its previous one, which is
+    // dropped without invoking its callback.
     UFUNCTION(BlueprintCallable, Category = "NavigationVolume3D", meta = (DisplayName = "Find Path Async"))
     void FindPathAsync(
         const AActor* RequestingActor,
@@ -132,6 +475,78 @@ public:
         FOnPathfindingComplete OnCompleteCallback
     );
 
+    // FindPathAsync with per-query settings.
+    UFUNCTION(BlueprintCallable, Category = "NavigationVolume3D", meta = (DisplayName = "Find Path Async With Options"))
+    void FindPathAsyncWithOptions(
+        const AActor* RequestingActor,
+        const FVector& StartLocation,
+        const FVector& DestinationLocation,
+        const FNavPathQueryOptions& Options,
+        FOnPathfindingComplete OnCompleteCallback
+    );
+
+    // FindPathAsyncWithOptions for C++ callers: the callback gets the pooled path itself, so nothing is copied
+    // between the worker that found it and the caller.
+    void FindPathAsyncNative(
+        const AActor* RequestingActor,
+        const FVector& StartLocation,
+        const FVector& DestinationLocation,
+        const FNavPathQueryOptions& Options,
+        FOnNavPathComplete OnCompleteCallback
+    );
+
+    // Answers many independent queries as one scheduled job: one worker runs them back to back on shared search
+    // scratch, and a single callback delivers every result once they are all done. The batch is queued at the
+    // priority of its most urgent query and, like a single query, supersedes RequestingActor's previous request.
+    // Batches bypass the path cache and query coalescing. A search budget in Options applies to each query and
+    // returns partial paths; batches are never sliced.
+    UFUNCTION(BlueprintCallable, Category = "NavigationVolume3D", meta = (DisplayName = "Find Paths Batch"))
+    void FindPathsBatch(
+        const AActor* RequestingActor,
+        const TArray<FNavPathBatchQuery>& Queries,
+        const FNavPathQueryOptions& Options,
+        FOnPathBatchComplete OnCompleteCallback
+    );
+
+    // Starts maintaining a shared flow field toward Target, rebuilt in the background whenever Target enters a new cell.
+    // Meant for many agents chasing the same actor. Dense grid backend only.
+    UFUNCTION(BlueprintCallable, Category = "NavigationVolume3D|Flow Field")
+    void RegisterFlowFieldTarget(const AActor* Target);
+
+    UFUNCTION(BlueprintCallable, Category = "NavigationVolume3D|Flow Field")
+    void UnregisterFlowFieldTarget(const AActor* Target);
+
+    // O(1) lookup of the centre of the next cell on a shortest path from Location toward Target.
+    // Returns false until the first field for Target is ready, or if Target cannot be reached from Location.
+    UFUNCTION(BlueprintCallable, Category = "NavigationVolume3D|Flow Field")
+    bool GetFlowFieldNextLocation(const AActor* Target, const FVector& Location, FVector& OutNextLocation) const;
+
+    // Re-evaluates traversability inside WorldBox (e.g. after a door opened or closed) on a worker thread.
+    // Once applied, cached paths are dropped and finished paths that cross a newly blocked cell are searched again.
+    // Dense grid backend only.
+    UFUNCTION(BlueprintCallable, Category = "NavigationVolume3D|Dynamic")
+    void MarkRegionDirty(const FBox& WorldBox);
+
+    // Runs the full dense-grid bake outside of play and stores it in BakedData. Used by BakeNavigationData and
+    // the NavigationVolume3DBake commandlet. Returns false if there is nothing to bake into.
+    bool BakeNavigationDataToAsset();
+
+    UNavigationVolume3DBakeData* GetBakedData() const;
+
+    // Fraction of the navigation build done, from 0 to 1. Safe to poll from a loading screen thread.
+    UFUNCTION(BlueprintPure, Category = "NavigationVolume3D|Stats")
+    float GetNavigationBuildProgress() const;
+
+    // Counters since BeginPlay: queries answered from the path cache, queries that needed a search, and
+    // queries that attached to an identical search already queued or running. Batches never look at the path
+    // cache, so their queries count towards none of these.
+    UFUNCTION(BlueprintPure, Category = "NavigationVolume3D|Stats")
+    void GetPathCacheStats(int32& OutHits, int32& OutMisses, int32& OutCoalesced) const;
+
+    // Landmarks currently used by the A* heuristic and the memory their distance tables take.
+    UFUNCTION(BlueprintPure, Category = "NavigationVolume3D|Stats")
+    void GetLandmarkStats(int32& OutNumLandmarks, int64& OutTableBytes) const;
+
     UFUNCTION(BlueprintPure, Category = "NavigationVolume3D")
     FIntVector ConvertLocationToCoordinates(const FVector& Location) const;
 
@@ -146,39 +561,322 @@ protected:
     virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
-    TArray<NavNode> Nodes;
+    FNavGrid Grid;
+    FNavOctree Octree;
+    FNavClusterHierarchy ClusterHierarchy;
+    FNavLandmarks Landmarks;
+    // Dense grid: free cells per brick for FindRandomValidLocationInRadius.
+    FNavBrickIndex TraversableBricks;
+    // Dense grid: the coarse resolution layers, level L at 2^L times the cell size.
+    FNavGridMipChain GridLayers;
+    FRandomStream RandomLocationStream;
+    FNavJumpPointRules JumpPointRules;
     bool bNodesInitializedAndFinalized = false;
+
+    // Traversability bake progress, in 4x4x4 cell blocks. Written by the bake workers.
+    std::atomic<int32> BakedBlockCount = 0;
+    std::atomic<int32> BakeBlockTotal = 0;
+    std::atomic<bool> bCancelTraversabilityBake = false;
+    TFuture<void> PendingTraversabilityBake;
+
+    // Set by the first query whose AgentRadius exceeds FNavGrid::MaxClearance, so the clamp is only logged once.
+    mutable std::atomic<bool> bWarnedClearanceClamped = false;
+
+    // Pooled per-query A* scratch state; lets concurrent searches share the read-only grid.
+    FNavSearchContextPool SearchContextPool;
     
-    std::atomic<uint32_t> AtomicPathfindingSearchIDCounter{0};
-    
+    // Finished paths, shared between results, the path cache and callers.
+    FNavPathPool PathPool;
+
+    struct FPathfindingDebugDraw
+    {
+        TArray<FDebugSphereData> Spheres;
+        TArray<FDebugLineData> Lines;
+    };
+
     struct FPathfindingInternalResultBundle
     {
         ENavigationVolumeResult ResultCode = ENavigationVolumeResult::ENVR_UnknownError;
-        TArray<FVector> PathPoints;
-        TArray<FDebugSphereData> DebugSpheresToDraw_TaskLocal;
-        TArray<FDebugLineData> DebugLinesToDraw_TaskLocal;
+        // Set by the worker before it adds points; results that never searched (cancelled, empty) leave it null.
+        FNavPathRef Path;
+        // Only allocated while bDrawPathfindingDebug is set.
+        TUniquePtr<FPathfindingDebugDraw> DebugDraw;
         bool bShouldDrawThisPathAndExploration_TaskLocal = false;
         bool bIsLongPath_TaskLocal = false;
+        // Out of budget with the search state kept in the request's FSuspendedPathSearch for the next slice.
+        bool bSearchSuspended = false;
+        // Search effort for the Navigation3D stats; a resumed search counts every slice so far.
+        int32 NumExpanded = 0;
+        int32 PeakOpenNodes = 0;
+        // Only allocated while bRecordSearchTraces is set; completed and recorded on delivery.
+        TUniquePtr<FNavSearchTrace> Trace;
+
+        const TArray<FVector>& GetPathPoints() const
+        {
+            static const TArray<FVector> NoPoints;
+            return Path.IsValid() ? Path->GetPoints() : NoPoints;
+        }
+
+        FPathfindingDebugDraw& GetDebugDraw()
+        {
+            if (!DebugDraw.IsValid()) {
+                DebugDraw = MakeUnique<FPathfindingDebugDraw>();
+            }
+            return *DebugDraw;
+        }
+    };
+
+    // Identifies queries that must produce the same result: same cells, same effective options, same navigation data.
+    struct FPathQueryKey
+    {
+        int32 StartCell = INDEX_NONE;
+        int32 GoalCell = INDEX_NONE;
+        ENavPathSearchAlgorithm SearchAlgorithm = ENavPathSearchAlgorithm::AStar;
+        ENavPathSmoothing Smoothing = ENavPathSmoothing::None;
+        uint8 MinClearance = 1;
+        uint8 ResolutionLayer = 0;
+        uint32 NavDataVersion = 0;
+
+        bool operator==(const FPathQueryKey& Other) const
+        {
+            return StartCell == Other.StartCell && GoalCell == Other.GoalCell && SearchAlgorithm == Other.SearchAlgorithm
+                && Smoothing == Other.Smoothing && MinClearance == Other.MinClearance && ResolutionLayer == Other.ResolutionLayer
+                && NavDataVersion == Other.NavDataVersion;
+        }
+
+        friend uint32 GetTypeHash(const FPathQueryKey& Key)
+        {
+            uint32 Hash = HashCombine(GetTypeHash(Key.StartCell), GetTypeHash(Key.GoalCell));
+            Hash = HashCombine(Hash, GetTypeHash(static_cast<uint8>(Key.SearchAlgorithm) | (static_cast<uint8>(Key.Smoothing) << 4)
+                | (static_cast<uint32>(Key.MinClearance) << 8) | (static_cast<uint32>(Key.ResolutionLayer) << 16)));
+            return HashCombine(Hash, GetTypeHash(Key.NavDataVersion));
+        }
+    };
+
+    struct FCachedPathResult
+    {
+        ENavigationVolumeResult ResultCode = ENavigationVolumeResult::ENVR_UnknownError;
+        FNavPathRef Path;
+    };
+
+    // A budgeted dense-grid search between slices. Only resumed on the navigation data it started from.
+    struct FSuspendedPathSearch
+    {
+        TUniquePtr<FNavSearchContext> Context;
+        int32 StartIndex = INDEX_NONE;
+        int32 GoalIndex = INDEX_NONE;
+        uint32 NavDataVersion = 0;
+    };
+
+    struct FPathQueryRequest
+    {
+        uint32 RequestId = 0;
+        TWeakObjectPtr<const AActor> RequestingActor;
         FString ActorNameForLog;
+        FVector StartLocation = FVector::ZeroVector;
+        FVector DestinationLocation = FVector::ZeroVector;
+        FNavPathQueryOptions Options;
+        FOnPathfindingComplete OnCompleteCallback;
+        FOnNavPathComplete OnNativeCompleteCallback;
+        float Priority = 0.0f;
+        TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bCancelled = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+        TFuture<void> WorkerFuture;
+        FPathQueryKey CacheKey;
+        // Identical requests waiting on this one's result (see CoalescedPathQueries).
+        TArray<uint32> CoalescedRequestIds;
+        // Superseded by its own actor but kept running because coalesced requests still need the result.
+        bool bSuperseded = false;
+        // Set for queries whose budget continues in later slices; handed to every slice's worker.
+        TSharedPtr<FSuspendedPathSearch, ESPMode::ThreadSafe> SuspendedSearch;
+        // FindPathsBatch: the queries one worker answers in order, and the callback that gets all of their results.
+        // Only CacheKey's NavDataVersion and MinClearance are meaningful for a batch.
+        bool bIsBatch = false;
+        TArray<FNavPathBatchQuery> BatchQueries;
+        FOnPathBatchComplete OnBatchCompleteCallback;
+        // FPlatformTime::Seconds() when the request was made, for the latency stats.
+        double EnqueueTime = 0.0;
+    };
 
-        FPathfindingInternalResultBundle(const FString& InActorName = TEXT("UnknownActor")) : ActorNameForLog(InActorName) {}
+    // Lower priority value dispatches first; equal priorities dispatch in request order.
+    struct FPathQueryQueueEntry
+    {
+        float Priority;
+        uint32 RequestId;
+
+        bool operator<(const FPathQueryQueueEntry& Other) const
+        {
+            return Priority < Other.Priority || (Priority == Other.Priority && RequestId < Other.RequestId);
+        }
+    };
+
+    struct FPathQueryCompletion
+    {
+        uint32 RequestId = 0;
+        FPathfindingInternalResultBundle ResultBundle;
+        // One per batch query, in order. Empty for single queries.
+        TArray<FPathfindingInternalResultBundle> BatchResultBundles;
     };
 
+    using FPathQueryCompletionQueue = TQueue<FPathQueryCompletion, EQueueMode::Mpsc>;
+
+    uint32 LastPathQueryRequestId = 0;
+    TMap<uint32, FPathQueryRequest> PendingPathQueries;
+    TArray<FPathQueryQueueEntry> PendingPathQueryHeap;
+    TMap<uint32, FPathQueryRequest> InFlightPathQueries;
+    TMap<TWeakObjectPtr<const AActor>, uint32> ActivePathQueryByActor;
+    // Requests attached to an identical pending or in-flight leader; answered when the leader completes.
+    TMap<uint32, FPathQueryRequest> CoalescedPathQueries;
+    TMap<FPathQueryKey, uint32> PathQueryLeaderByKey;
+    TLruCache<FPathQueryKey, FCachedPathResult> PathCache;
+    // Bumped whenever navigation data changes so cached and coalesced results from older data never match.
+    uint32 NavDataVersion = 0;
+    int32 PathCacheHits = 0;
+    int32 PathCacheMisses = 0;
+    int32 PathQueriesCoalesced = 0;
+    FNavSearchTraceRecorder SearchTraceRecorder;
+    double LastSearchTraceDumpTime = -UE_BIG_NUMBER;
+    TArray<FNavSearchTrace> SearchTraceReplayTraces;
+
+    // This volume's contribution to STAT_Nav3D_NavigationDataMemory, so updates can report the difference.
+    int64 ReportedNavigationDataBytes = 0;
+    // Shared with the workers so a completion can still be enqueued safely while the volume tears down.
+    TSharedRef<FPathQueryCompletionQueue, ESPMode::ThreadSafe> CompletedPathQueries = MakeShared<FPathQueryCompletionQueue, ESPMode::ThreadSafe>();
+
+    using FNavFlowFieldPtr = TSharedPtr<const FNavFlowField, ESPMode::ThreadSafe>;
+
+    struct FFlowFieldTarget
+    {
+        // Last finished field. Readers only ever see complete fields; a new one replaces it when its build is done.
+        FNavFlowFieldPtr Field;
+        TFuture<FNavFlowFieldPtr> PendingBuild;
+        // NavDataVersion the latest build started from.
+        uint32 BuildNavDataVersion = 0;
+    };
+
+    TMap<TWeakObjectPtr<const AActor>, FFlowFieldTarget> FlowFieldTargets;
+    // Builds of unregistered targets; kept so EndPlay can still wait for them.
+    TArray<TFuture<FNavFlowFieldPtr>> OrphanedFlowFieldBuilds;
+    TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bCancelFlowFieldBuilds = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+
+    void UpdateFlowFields();
+    int32 ResolveFlowFieldGoalIndex(const AActor* Target) const;
+    void CancelFlowFieldBuilds();
+
+    struct FNavTraversabilityUpdate
+    {
+        TArray<FNavGridRegion> Regions;
+        TArray<int32> ChangedCells; // Cells whose traversability flipped; unique.
+    };
+
+    // Marked regions not yet handed to a worker.
+    TArray<FNavGridRegion> PendingDirtyRegions;
+    TFuture<FNavTraversabilityUpdate> PendingTraversabilityUpdate;
+
+    void UpdateDirtyRegions();
+    // True while an evaluated update waits for every worker that reads the grid to finish. No new path
+    // searches or flow field builds start meanwhile.
+    bool IsTraversabilityUpdateWaiting() const;
+    bool AreNavigationReadersIdle() const;
+    void ApplyTraversabilityUpdate(const FNavTraversabilityUpdate& Update);
+    // A path finished on older navigation data is still usable if every segment keeps its voxel line of sight.
+    bool IsPathStillClear(const TArray<FVector>& PathPoints, uint8 MinClearance) const;
+
+    float ComputePathQueryPriority(const AActor* RequestingActor, const FVector& StartLocation) const;
+    void CancelActivePathQuery(const AActor* RequestingActor);
+    void DispatchPendingPathQueries(double BudgetEndTime);
+    void LaunchPathQuery(FPathQueryRequest& Request);
+    void ProcessCompletedPathQueries(double BudgetEndTime);
+    void EnqueuePathQuery(const AActor* RequestingActor, const FVector& StartLocation, const FVector& DestinationLocation,
+        const FNavPathQueryOptions& Options, FOnPathfindingComplete OnCompleteCallback, FOnNavPathComplete OnNativeCompleteCallback);
+    void DeliverPathQueryResult(const FPathQueryRequest& Request, FPathfindingInternalResultBundle& ResultBundle);
+    // Runs whichever completion callbacks the request bound; no debug drawing.
+    static void InvokePathQueryCallbacks(const FPathQueryRequest& Request, const FPathfindingInternalResultBundle& ResultBundle);
+    void DeliverPathBatchResult(const FPathQueryRequest& Request, TArray<FPathfindingInternalResultBundle>& ResultBundles);
+    // A result computed on older navigation data that no longer holds: its path is blocked now, or a NoPathExists
+    // answer that an opened cell may have changed.
+    bool IsStalePathResult(const FPathfindingInternalResultBundle& ResultBundle, uint8 MinClearance) const;
+    void CancelAllPathQueries();
+    FPathQueryKey MakePathQueryKey(const FVector& StartLocation, const FVector& DestinationLocation, const FNavPathQueryOptions& Options) const;
+    void ReleasePathQueryLeader(const FPathQueryRequest& Request);
+
     FPathfindingInternalResultBundle ExecutePathfindingOnThread(
-        TWeakObjectPtr<ANavigationVolume3D> WeakThis,
         TWeakObjectPtr<const AActor> WeakRequestingActor,
+        const FString& ActorNameForLogging,
         const FVector& StartLocation,
         const FVector& DestinationLocation,
-        uint32_t PathSearchID
+        const FNavPathQueryOptions& Options,
+        const std::atomic<bool>* bCancelled = nullptr,
+        FSuspendedPathSearch* SuspendedSearch = nullptr
     );
+
+    FPathfindingInternalResultBundle ExecuteOctreePathfindingOnThread(
+        const FString& ActorNameForLogging,
+        const FVector& StartLocation,
+        const FVector& DestinationLocation,
+        const FNavPathQueryOptions& Options,
+        const std::atomic<bool>* bCancelled,
+        // The caller's trace for this query, or null when traces are off.
+        FNavSearchTrace* Trace
+    );
+
+    // Sets the success result code and long-path/debug bookkeeping once PathPoints is filled in.
+    void FinalizeFoundPath(FPathfindingInternalResultBundle& ResultBundle, const FNavPathQueryOptions& Options, const FString& ActorNameForLogging) const;
+    void SmoothPathPoints(TArray<FVector>& InOutPathPoints, uint8 MinClearance) const;
+    bool ShouldUseJumpPointSearch(const FNavPathQueryOptions& Options) const;
+    bool ShouldUseBidirectionalSearch(const FNavPathQueryOptions& Options) const;
+    // World-space centres of up to MaxCandidates distinct free cells within WorldRadius of Origin, in random order.
+    void CollectRandomLocationCandidates(const FVector& Origin, float WorldRadius, int32 MaxCandidates, TArray<FVector>& OutCandidates) const;
+
+    // Clearance in cells of resolution layer Layer an agent of Radius needs (see FNavGrid::GetClearance), whatever the backend.
+    uint8 GetClearanceForRadius(float Radius, int32 Layer = 0) const;
+    // Clearance in cells a query's AgentRadius needs (see FNavGrid::GetClearance); 1 means any free cell fits.
+    uint8 GetRequiredClearance(const FNavPathQueryOptions& Options) const;
+    // Resolution layer a query searches first: 0 for the full grid, otherwise a level of GridLayers.
+    int32 SelectResolutionLayer(const FNavPathQueryOptions& Options) const;
     
     void AddDebugSphere_TaskLocal(TArray<FDebugSphereData>& DebugSpheresArray, const FVector& Center, float Radius, const FColor& InSphereColor, int32 Segments = 12) const;
     void AddDebugLine_TaskLocal(TArray<FDebugLineData>& DebugLinesArray, const FVector& Start, const FVector& End, const FColor& InLineColor, float Thickness = 1.f) const;
     
     void FlushCollectedDebugDraws(UWorld* World, float Lifetime, const TArray<FDebugSphereData>& Spheres, const TArray<FDebugLineData>& Lines, bool bIsLongPathContext = false) const;
 
-    NavNode* GetNode(FIntVector Coordinates); 
-    const NavNode* GetConstNode(FIntVector Coordinates) const;
+    // Both return a handle to the cell at the (clamped) coordinates, or an invalid handle if the grid is not built.
+    NavNode GetNode(FIntVector Coordinates) const;
+    NavNode GetConstNode(FIntVector Coordinates) const;
+
+    bool IsNavigationDataReady() const;
+    bool IsCellTraversable(const FIntVector& Coordinates) const;
+    // In bounds, traversable and, on the dense grid, at least MinClearance cells from the nearest obstacle.
+    bool IsCellFreeForAgent(const FIntVector& Coordinates, uint8 MinClearance) const;
+    // Dense grid: the cell a blocked endpoint moves to, from the grid's precomputed nearest-traversable table.
+    // Coordinates itself if it is free; INDEX_NONE if the nearest free cell is beyond BlockedEndpointResolveRadius.
+    int32 ResolveBlockedCell(const FIntVector& Coordinates, const FVector& OriginalLocation) const;
+    FVector ConvertCellSpaceToLocation(const FVector& CellSpacePosition) const;
+    int32 FindNearestOctreeLeaf(const FIntVector& Coordinates, int32 SearchRadiusInCells) const;
+    bool IsWorldBoxBlocked(const FVector& WorldCenter, const FVector& HalfExtent) const;
+    // Same overlap test the traversability bake uses for a single cell.
+    bool IsCellBlockedByObstacles(const FIntVector& Coordinates) const;
+    void BuildSparseOctree();
+    // Completes the bundle's trace with the delivered result and adds it to the recorder.
+    void RecordSearchTrace(FPathfindingInternalResultBundle& ResultBundle);
+    FNavSearchTraceHeader MakeSearchTraceHeader() const;
+    FString MakeSearchTraceDumpPath() const;
+    // DumpSearchTraces without blocking the game thread: copies the buffer and writes the copy on the thread pool.
+    void DumpSearchTracesInBackground();
+    // Converts a search node of the active backend to the cell a trace stores for it.
+    uint32 SearchNodeToTraceCell(int32 NodeIndex) const;
+    void DrawSearchTraceReplay();
+
+    // Brings this volume's share of the "Navigation Data" memory stat in line with what it holds now.
+    void UpdateNavigationDataMemoryStat();
+
+    // Everything after the traversability bake: neighbour masks, search acceleration data, readiness.
+    // Baked data already carries the masks and hierarchy.
+    void FinishNavigationBuild(bool bLoadedFromBake = false);
+    bool LoadBakedNavigationData();
+    // Fingerprints of what a bake depends on: the volume's own settings and placement, and the static or
+    // stationary obstacle components overlapping it. Movable obstacles are left to MarkRegionDirty.
+    uint32 ComputeBakeSettingsHash() const;
+    uint32 ComputeObstacleGeometryHash() const;
 
     void CreateLine(const FVector& Start, const FVector& End, const FVector& Normal, TArray<FVector>& Vertices, TArray<int32>& Triangles);
     bool AreCoordinatesValid(const FIntVector& Coordinates) const;
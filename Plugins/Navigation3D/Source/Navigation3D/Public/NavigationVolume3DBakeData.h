@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "Serialization/BulkData.h"
+#include "NavigationVolume3DBakeData.generated.h"
+
+struct FNavGrid;
+class FNavClusterHierarchy;
+class FNavLandmarks;
+
+// Navigation data baked offline for one ANavigationVolume3D: the dense grid's traversability bits, neighbour
+// masks and clearance plus its cluster hierarchy and landmark tables, so BeginPlay can skip the overlap bake entirely.
+//
+// The payload is a little binary blob kept in bulk data:
+//   uint32 Magic, uint32 FormatVersion, uint32 SettingsHash, uint32 GeometryHash,
+//   FNavGrid, bool bHasHierarchy, [FNavClusterHierarchy], bool bHasLandmarks, [FNavLandmarks]
+// The two hashes describe what the bake was made from (see ANavigationVolume3D::ComputeBakeSettingsHash and
+// ComputeObstacleGeometryHash); a volume whose current hashes differ treats the asset as stale.
+UCLASS(BlueprintType)
+class NAVIGATION3D_API UNavigationVolume3DBakeData : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    static constexpr uint32 Magic = 0x4244334E; // "N3DB"
+    static constexpr uint32 FormatVersion = 5;
+
+    virtual void Serialize(FArchive& Ar) override;
+
+    void Store(uint32 SettingsHash, uint32 GeometryHash, FNavGrid& Grid, FNavClusterHierarchy& Hierarchy, FNavLandmarks& Landmarks);
+
+    // Fills Grid, Hierarchy and Landmarks if the payload is readable and was baked with the given hashes.
+    bool Load(uint32 SettingsHash, uint32 GeometryHash, FNavGrid& OutGrid, FNavClusterHierarchy& OutHierarchy, FNavLandmarks& OutLandmarks);
+
+    bool HasPayload() const { return Payload.GetBulkDataSize() > 0; }
+
+protected:
+    UPROPERTY(VisibleAnywhere, Category = "Bake")
+    FIntVector BakedGridSize = FIntVector::ZeroValue;
+
+    UPROPERTY(VisibleAnywhere, Category = "Bake")
+    int32 BakedTraversableCells = 0;
+
+    UPROPERTY(VisibleAnywhere, Category = "Bake")
+    int64 PayloadSizeBytes = 0;
+
+    UPROPERTY(VisibleAnywhere, Category = "Bake")
+    FDateTime BakeTime;
+
+private:
+    FByteBulkData Payload;
+};
@@ -0,0 +1,29 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using System.IO;
+using UnrealBuildTool;
+
+public class Navigation3DTests : ModuleRules
+{
+	public Navigation3DTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PrivateIncludePaths.AddRange(
+			new string[] {
+				// The tests drive the search core (FNavGrid, RunNavAStar, ...) directly, without a world or a volume actor.
+				Path.Combine(ModuleDirectory, "..", "Navigation3D", "Private"),
+			}
+			);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Json",
+				"Navigation3D",
+			}
+			);
+	}
+}
@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "NavTestGrids.h"
+#include "NavTestSearch.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    const FIntVector BidirectionalGridSize(24, 24, 12);
+    constexpr int32 BidirectionalQueryCount = 32;
+    constexpr int32 BidirectionalLandmarkCount = 4;
+    constexpr int32 BidirectionalSeeds[] = {7, 8, 9};
+
+    constexpr ENavTestSearch ComparedSearches[] = {
+        ENavTestSearch::Bidirectional, ENavTestSearch::Landmarks, ENavTestSearch::BidirectionalLandmarks
+    };
+
+    // Blocks every cell around CellIndex, so nothing else can reach it, and rebuilds what depends on traversability.
+    void SealOffCell(FNavGrid& Grid, int32 CellIndex)
+    {
+        const FIntVector Cell = Grid.ToCoordinates(CellIndex);
+        for (int32 Z = -1; Z <= 1; ++Z)
+        {
+            for (int32 Y = -1; Y <= 1; ++Y)
+            {
+                for (int32 X = -1; X <= 1; ++X)
+                {
+                    const FIntVector Neighbor = Cell + FIntVector(X, Y, Z);
+                    if (Neighbor != Cell && Grid.IsInBounds(Neighbor))
+                    {
+                        Grid.SetTraversable(Grid.ToIndex(Neighbor), false);
+                    }
+                }
+            }
+        }
+        Grid.RebuildNeighborMasks();
+        Grid.RebuildClearance();
+        Grid.RebuildNearestTraversable();
+    }
+}
+
+// Bidirectional A*, landmark-guided A* and their combination must return paths exactly as short as plain A*'s, on
+// seeded random grids, including start == goal and goals that cannot be reached.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNavBidirectionalSearchTest, "Navigation3D.Search.BidirectionalAndLandmarks",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FNavBidirectionalSearchTest::RunTest(const FString& Parameters)
+{
+    for (const int32 MinSharedNeighborAxes : {0, 2})
+    {
+        for (const int32 Seed : BidirectionalSeeds)
+        {
+            for (const ENavTestGridLayout Layout : NavTestGridLayouts)
+            {
+                FNavGrid Grid;
+                BuildNavTestGrid(Layout, BidirectionalGridSize, Seed, MinSharedNeighborAxes, Grid);
+                TArray<FNavTestQuery> Queries;
+                MakeNavTestQueries(Grid, BidirectionalQueryCount, Seed + 100, Queries);
+                if (Queries.Num() == 0)
+                {
+                    continue;
+                }
+
+                // A sealed-off start: unreachable from and to everything else, but found at no cost from itself.
+                const int32 SealedIndex = Queries[0].StartIndex;
+                SealOffCell(Grid, SealedIndex);
+                Queries.RemoveAll([&Grid](const FNavTestQuery& Query) { return !Grid.IsTraversable(Query.StartIndex) || !Grid.IsTraversable(Query.GoalIndex); });
+                const int32 NumRandomQueries = Queries.Num();
+                Queries.Add({SealedIndex, SealedIndex});
+                for (int32 QueryIndex = 0; QueryIndex < NumRandomQueries; ++QueryIndex)
+                {
+                    const int32 GoalIndex = Queries[QueryIndex].GoalIndex;
+                    Queries.Add({GoalIndex, GoalIndex});
+                    Queries.Add({SealedIndex, GoalIndex});
+                    Queries.Add({GoalIndex, SealedIndex});
+                }
+
+                FNavTestSearchRunner Runner(Grid, BidirectionalLandmarkCount);
+                const FString GridName = FString::Printf(TEXT("%s seed %d (MinSharedNeighborAxes %d)"), GetNavTestGridLayoutName(Layout), Seed, MinSharedNeighborAxes);
+                FNavTestSearchResult AStarResult;
+                FNavTestSearchResult Result;
+                for (const FNavTestQuery& Query : Queries)
+                {
+                    const float ReferenceCost = FindNavReferenceDistance(Grid, Query.StartIndex, Query.GoalIndex);
+                    Runner.Run(ENavTestSearch::AStar, Query, AStarResult);
+                    if (!TestNavSearchResult(*this, GridName + TEXT(" AStar"), Grid, Query, AStarResult, ReferenceCost))
+                    {
+                        continue;
+                    }
+
+                    for (const ENavTestSearch Search : ComparedSearches)
+                    {
+                        if (!Runner.IsSupported(Search))
+                        {
+                            AddError(FString::Printf(TEXT("%s: %s is unsupported."), *GridName, GetNavTestSearchName(Search)));
+                            continue;
+                        }
+                        Runner.Run(Search, Query, Result);
+                        TestNavSearchResult(*this, FString::Printf(TEXT("%s %s"), *GridName, GetNavTestSearchName(Search)), Grid, Query, Result, AStarResult.Cost);
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "NavHierarchy.h"
+#include "NavTestGrids.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    const FIntVector HierarchyGridSize(32, 32, 16);
+    constexpr int32 HierarchyClusterSize = 8;
+    constexpr int32 HierarchyQueryCount = 48;
+}
+
+// Cluster hierarchy paths must be valid grid paths no shorter than the reference, and its NoPath must be exact
+// whenever the hierarchy reports complete connectivity, which it always must with face neighbours only.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNavClusterHierarchyTest, "Navigation3D.Search.ClusterHierarchy",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FNavClusterHierarchyTest::RunTest(const FString& Parameters)
+{
+    for (const int32 MinSharedNeighborAxes : {0, 2})
+    {
+        for (const ENavTestGridLayout Layout : NavTestGridLayouts)
+        {
+            const FString What = FString::Printf(TEXT("%s (MinSharedNeighborAxes %d)"), GetNavTestGridLayoutName(Layout), MinSharedNeighborAxes);
+            FNavGrid Grid;
+            BuildNavTestGrid(Layout, HierarchyGridSize, 5, MinSharedNeighborAxes, Grid);
+            FNavSearchContextPool SearchContextPool;
+            FNavClusterHierarchy Hierarchy;
+            Hierarchy.Build(Grid, HierarchyClusterSize, SearchContextPool);
+            if (MinSharedNeighborAxes == 2)
+            {
+                TestTrue(What + TEXT(" has complete connectivity"), Hierarchy.HasCompleteConnectivity());
+            }
+
+            TArray<FNavTestQuery> Queries;
+            MakeNavTestQueries(Grid, HierarchyQueryCount, 6, Queries);
+            TArray<int32> PathIndices;
+            for (const FNavTestQuery& Query : Queries)
+            {
+                const float ReferenceCost = FindNavReferenceDistance(Grid, Query.StartIndex, Query.GoalIndex);
+                const ENavAStarStatus Status = Hierarchy.FindPath(Grid, Query.StartIndex, Query.GoalIndex, SearchContextPool, nullptr, PathIndices);
+                if (Status != ENavAStarStatus::Found)
+                {
+                    if (ReferenceCost != NavTestUnreachable && Hierarchy.HasCompleteConnectivity())
+                    {
+                        AddError(FString::Printf(TEXT("%s: %d -> %d found no path, the reference costs %f."), *What, Query.StartIndex, Query.GoalIndex, ReferenceCost));
+                    }
+                    continue;
+                }
+
+                const float PathCost = MeasureNavPathCost(Grid, PathIndices);
+                if (ReferenceCost == NavTestUnreachable || PathCost == NavTestUnreachable || PathIndices[0] != Query.StartIndex || PathIndices.Last() != Query.GoalIndex)
+                {
+                    AddError(FString::Printf(TEXT("%s: %d -> %d returned an invalid path."), *What, Query.StartIndex, Query.GoalIndex));
+                }
+                else if (PathCost < ReferenceCost && !IsNearlyEqualNavCost(PathCost, ReferenceCost))
+                {
+                    AddError(FString::Printf(TEXT("%s: %d -> %d costs %f, below the reference %f."), *What, Query.StartIndex, Query.GoalIndex, PathCost, ReferenceCost));
+                }
+            }
+        }
+    }
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
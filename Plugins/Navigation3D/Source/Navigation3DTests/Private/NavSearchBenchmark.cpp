@@ -0,0 +1,261 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "NavTestGrids.h"
+#include "NavTestSearch.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    const FIntVector BenchmarkGridSize(80, 80, 40);
+    constexpr int32 BenchmarkQueryCount = 200;
+    constexpr int32 BenchmarkLandmarkCount = 8;
+    // ANavigationVolume3D's defaults for HierarchicalClusterSize and HierarchicalMinDistanceCells.
+    constexpr int32 BenchmarkClusterSize = 16;
+    constexpr int32 BenchmarkLongQueryMinCells = 32;
+    // What the cluster hierarchy was asked to save on long queries, in expansions relative to flat A*.
+    constexpr double HierarchyExpansionTarget = 10.0;
+    // Fixed seeds so every build replays the same grids and queries.
+    constexpr int32 BenchmarkGridSeed = 12345;
+    constexpr int32 BenchmarkQuerySeed = 54321;
+
+    // Random pairs for every layout; for the layouts with long detours also pairs as far apart as the volume
+    // requires before it uses the cluster hierarchy.
+    struct FNavBenchmarkQuerySet
+    {
+        const TCHAR* Name;
+        int32 MinCellDistance;
+    };
+
+    struct FNavBenchmarkRow
+    {
+        FString Layout;
+        FString QuerySet;
+        FString Search;
+        int32 NumQueries = 0;
+        int32 NumFound = 0;
+        // Failed TestNavSearchResult, or TestNavApproximateSearchResult for searches that are not optimal.
+        int32 NumNotOptimal = 0;
+        double P50Ms = 0.0;
+        double P95Ms = 0.0;
+        double P99Ms = 0.0;
+        double TotalMs = 0.0;
+        double MeanExpanded = 0.0;
+        int32 MaxExpanded = 0;
+        // Flat A*'s mean expansions on the same queries over this search's.
+        double ExpandedVsAStar = 0.0;
+        // How much longer than the reference the paths are, in percent, over the queries with a path.
+        double MeanExtraCostPct = 0.0;
+        double MaxExtraCostPct = 0.0;
+        int64 PeakScratchBytes = 0;
+    };
+
+    // Nearest-rank percentile of sorted values.
+    double GetPercentile(const TArray<double>& SortedValues, double Percentile)
+    {
+        if (SortedValues.Num() == 0)
+        {
+            return 0.0;
+        }
+        const int32 Rank = FMath::CeilToInt32(Percentile * SortedValues.Num()) - 1;
+        return SortedValues[FMath::Clamp(Rank, 0, SortedValues.Num() - 1)];
+    }
+
+    FString MakeCsv(const TArray<FNavBenchmarkRow>& Rows)
+    {
+        FString Csv = TEXT("Layout,QuerySet,Search,Queries,Found,NotOptimal,P50Ms,P95Ms,P99Ms,TotalMs,MeanExpanded,MaxExpanded,ExpandedVsAStar,MeanExtraCostPct,MaxExtraCostPct,PeakScratchBytes\n");
+        for (const FNavBenchmarkRow& Row : Rows)
+        {
+            Csv += FString::Printf(TEXT("%s,%s,%s,%d,%d,%d,%.4f,%.4f,%.4f,%.3f,%.1f,%d,%.2f,%.3f,%.3f,%lld\n"), *Row.Layout, *Row.QuerySet, *Row.Search,
+                Row.NumQueries, Row.NumFound, Row.NumNotOptimal, Row.P50Ms, Row.P95Ms, Row.P99Ms, Row.TotalMs, Row.MeanExpanded, Row.MaxExpanded,
+                Row.ExpandedVsAStar, Row.MeanExtraCostPct, Row.MaxExtraCostPct, Row.PeakScratchBytes);
+        }
+        return Csv;
+    }
+
+    FString MakeJson(const TArray<FNavBenchmarkRow>& Rows)
+    {
+        const TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+        Root->SetStringField(TEXT("BuildVersion"), FApp::GetBuildVersion());
+        Root->SetStringField(TEXT("BuildConfiguration"), LexToString(FApp::GetBuildConfiguration()));
+        Root->SetStringField(TEXT("GridSize"), BenchmarkGridSize.ToString());
+        Root->SetNumberField(TEXT("GridSeed"), BenchmarkGridSeed);
+        Root->SetNumberField(TEXT("QuerySeed"), BenchmarkQuerySeed);
+        Root->SetNumberField(TEXT("ClusterSize"), BenchmarkClusterSize);
+        Root->SetNumberField(TEXT("LongQueryMinCells"), BenchmarkLongQueryMinCells);
+        Root->SetNumberField(TEXT("ProcessPeakUsedPhysicalBytes"), static_cast<double>(FPlatformMemory::GetStats().PeakUsedPhysical));
+
+        TArray<TSharedPtr<FJsonValue>> Results;
+        for (const FNavBenchmarkRow& Row : Rows)
+        {
+            const TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+            Result->SetStringField(TEXT("Layout"), Row.Layout);
+            Result->SetStringField(TEXT("QuerySet"), Row.QuerySet);
+            Result->SetStringField(TEXT("Search"), Row.Search);
+            Result->SetNumberField(TEXT("Queries"), Row.NumQueries);
+            Result->SetNumberField(TEXT("Found"), Row.NumFound);
+            Result->SetNumberField(TEXT("NotOptimal"), Row.NumNotOptimal);
+            Result->SetNumberField(TEXT("P50Ms"), Row.P50Ms);
+            Result->SetNumberField(TEXT("P95Ms"), Row.P95Ms);
+            Result->SetNumberField(TEXT("P99Ms"), Row.P99Ms);
+            Result->SetNumberField(TEXT("TotalMs"), Row.TotalMs);
+            Result->SetNumberField(TEXT("MeanExpanded"), Row.MeanExpanded);
+            Result->SetNumberField(TEXT("MaxExpanded"), Row.MaxExpanded);
+            Result->SetNumberField(TEXT("ExpandedVsAStar"), Row.ExpandedVsAStar);
+            Result->SetNumberField(TEXT("MeanExtraCostPct"), Row.MeanExtraCostPct);
+            Result->SetNumberField(TEXT("MaxExtraCostPct"), Row.MaxExtraCostPct);
+            Result->SetNumberField(TEXT("PeakScratchBytes"), static_cast<double>(Row.PeakScratchBytes));
+            Results.Add(MakeShared<FJsonValueObject>(Result));
+        }
+        Root->SetArrayField(TEXT("Results"), Results);
+
+        FString Json;
+        const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+        FJsonSerializer::Serialize(Root, Writer);
+        return Json;
+    }
+}
+
+// Replays seeded query sets through every dense-grid search on each synthetic layout and writes latency
+// percentiles, expansions (also relative to flat A*), scratch memory, and optimality and extra path cost against
+// the reference Dijkstra as CSV and JSON, to Saved/Automation/Navigation3D or the directory given with
+// -Nav3DBenchmarkDir=. Needs no world or renderer, so it runs headless, e.g.
+// UnrealEditor-Cmd <Project> -ExecCmds="Automation RunTests Navigation3D.Benchmark; Quit" -nullrhi -unattended.
+// Fails if an optimal search returns a path longer than the reference, or the hierarchy an invalid one; warns if
+// the hierarchy misses its expansion target on long queries.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNavSearchBenchmark, "Navigation3D.Benchmark.Search",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FNavSearchBenchmark::RunTest(const FString& Parameters)
+{
+    TArray<FNavBenchmarkRow> Rows;
+    for (const ENavTestGridLayout Layout : NavTestGridLayouts)
+    {
+        FNavGrid Grid;
+        BuildNavTestGrid(Layout, BenchmarkGridSize, BenchmarkGridSeed, 0, Grid);
+        FNavTestSearchRunner Runner(Grid, BenchmarkLandmarkCount, BenchmarkClusterSize);
+
+        TArray<FNavBenchmarkQuerySet, TInlineAllocator<2>> QuerySets;
+        QuerySets.Add({TEXT("Random"), 0});
+        if (Layout == ENavTestGridLayout::Maze || Layout == ENavTestGridLayout::RoomsAndDoors)
+        {
+            QuerySets.Add({TEXT("Long"), BenchmarkLongQueryMinCells});
+        }
+
+        for (const FNavBenchmarkQuerySet& QuerySet : QuerySets)
+        {
+            TArray<FNavTestQuery> Queries;
+            MakeNavTestQueries(Grid, BenchmarkQueryCount, BenchmarkQuerySeed, Queries, QuerySet.MinCellDistance);
+            TArray<float> ReferenceCosts;
+            ReferenceCosts.Reserve(Queries.Num());
+            for (const FNavTestQuery& Query : Queries)
+            {
+                ReferenceCosts.Add(FindNavReferenceDistance(Grid, Query.StartIndex, Query.GoalIndex));
+            }
+
+            const int32 FirstRow = Rows.Num();
+            for (int32 SearchIndex = 0; SearchIndex < static_cast<int32>(ENavTestSearch::Num); ++SearchIndex)
+            {
+                const ENavTestSearch Search = static_cast<ENavTestSearch>(SearchIndex);
+                if (!Runner.IsSupported(Search))
+                {
+                    continue;
+                }
+
+                FNavBenchmarkRow& Row = Rows.AddDefaulted_GetRef();
+                Row.Layout = GetNavTestGridLayoutName(Layout);
+                Row.QuerySet = QuerySet.Name;
+                Row.Search = GetNavTestSearchName(Search);
+                Row.NumQueries = Queries.Num();
+
+                TArray<double> LatenciesMs;
+                LatenciesMs.Reserve(Queries.Num());
+                int64 TotalExpanded = 0;
+                double TotalExtraCostPct = 0.0;
+                int32 NumCompared = 0;
+                FNavTestSearchResult Result;
+                for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+                {
+                    Runner.Run(Search, Queries[QueryIndex], Result);
+                    LatenciesMs.Add(Result.Seconds * 1000.0);
+                    TotalExpanded += Result.NumExpanded;
+                    Row.MaxExpanded = FMath::Max(Row.MaxExpanded, Result.NumExpanded);
+                    Row.PeakScratchBytes = FMath::Max<int64>(Row.PeakScratchBytes, Result.PeakScratchBytes);
+                    Row.NumFound += Result.Status == ENavAStarStatus::Found;
+
+                    const FString What = FString::Printf(TEXT("%s %s %s"), *Row.Layout, *Row.QuerySet, *Row.Search);
+                    const float ReferenceCost = ReferenceCosts[QueryIndex];
+                    const bool bAgreed = IsNavTestSearchOptimal(Search)
+                        ? TestNavSearchResult(*this, What, Grid, Queries[QueryIndex], Result, ReferenceCost)
+                        : TestNavApproximateSearchResult(*this, What, Grid, Queries[QueryIndex], Result, ReferenceCost);
+                    if (!bAgreed)
+                    {
+                        ++Row.NumNotOptimal;
+                    }
+                    else if (Result.Status == ENavAStarStatus::Found && ReferenceCost > 0.0f)
+                    {
+                        const double ExtraCostPct = FMath::Max(0.0, 100.0 * (static_cast<double>(Result.Cost) - ReferenceCost) / ReferenceCost);
+                        TotalExtraCostPct += ExtraCostPct;
+                        Row.MaxExtraCostPct = FMath::Max(Row.MaxExtraCostPct, ExtraCostPct);
+                        ++NumCompared;
+                    }
+                }
+
+                LatenciesMs.Sort();
+                Row.P50Ms = GetPercentile(LatenciesMs, 0.50);
+                Row.P95Ms = GetPercentile(LatenciesMs, 0.95);
+                Row.P99Ms = GetPercentile(LatenciesMs, 0.99);
+                for (const double LatencyMs : LatenciesMs)
+                {
+                    Row.TotalMs += LatencyMs;
+                }
+                Row.MeanExpanded = Queries.Num() > 0 ? static_cast<double>(TotalExpanded) / Queries.Num() : 0.0;
+                Row.MeanExtraCostPct = NumCompared > 0 ? TotalExtraCostPct / NumCompared : 0.0;
+                AddInfo(FString::Printf(TEXT("%s %s %s: p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, %.0f expansions on average, %d of %d found, paths %.2f%% longer than the reference on average."),
+                    *Row.Layout, *Row.QuerySet, *Row.Search, Row.P50Ms, Row.P95Ms, Row.P99Ms, Row.MeanExpanded, Row.NumFound, Row.NumQueries, Row.MeanExtraCostPct));
+            }
+
+            // AStar is always supported, so it is the first row of the set.
+            const double AStarMeanExpanded = Rows[FirstRow].MeanExpanded;
+            for (int32 RowIndex = FirstRow; RowIndex < Rows.Num(); ++RowIndex)
+            {
+                FNavBenchmarkRow& Row = Rows[RowIndex];
+                Row.ExpandedVsAStar = Row.MeanExpanded > 0.0 ? AStarMeanExpanded / Row.MeanExpanded : 0.0;
+                if (QuerySet.MinCellDistance > 0 && Row.Search == GetNavTestSearchName(ENavTestSearch::Hierarchy))
+                {
+                    const FString Summary = FString::Printf(TEXT("%s %s: the cluster hierarchy expands %.2fx fewer nodes than flat A* (target %.0fx), with paths %.2f%% longer on average and %.2f%% at most."),
+                        *Row.Layout, *Row.QuerySet, Row.ExpandedVsAStar, HierarchyExpansionTarget, Row.MeanExtraCostPct, Row.MaxExtraCostPct);
+                    if (Row.ExpandedVsAStar >= HierarchyExpansionTarget)
+                    {
+                        AddInfo(Summary);
+                    }
+                    else
+                    {
+                        AddWarning(Summary);
+                    }
+                }
+            }
+        }
+    }
+
+    FString OutputDir = FPaths::AutomationDir() / TEXT("Navigation3D");
+    FParse::Value(FCommandLine::Get(), TEXT("Nav3DBenchmarkDir="), OutputDir);
+    const FString BaseName = OutputDir / FString::Printf(TEXT("SearchBenchmark_%s"), *FDateTime::Now().ToString());
+    TestTrue(TEXT("Writes the CSV results"), FFileHelper::SaveStringToFile(MakeCsv(Rows), *(BaseName + TEXT(".csv"))));
+    TestTrue(TEXT("Writes the JSON results"), FFileHelper::SaveStringToFile(MakeJson(Rows), *(BaseName + TEXT(".json"))));
+    AddInfo(FString::Printf(TEXT("Benchmark results written to %s.csv and .json."), *BaseName));
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "NavTestGrids.h"
+#include "NavTestSearch.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    const FIntVector OptimalityGridSize(32, 32, 16);
+    constexpr int32 OptimalityQueryCount = 48;
+}
+
+// Plain A* and jump point search must return paths exactly as short as the reference Dijkstra's, on every layout.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNavSearchOptimalityTest, "Navigation3D.Search.Optimality",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FNavSearchOptimalityTest::RunTest(const FString& Parameters)
+{
+    for (const ENavTestGridLayout Layout : NavTestGridLayouts)
+    {
+        FNavGrid Grid;
+        BuildNavTestGrid(Layout, OptimalityGridSize, 1, 0, Grid);
+        TArray<FNavTestQuery> Queries;
+        MakeNavTestQueries(Grid, OptimalityQueryCount, 2, Queries);
+        FNavTestSearchRunner Runner(Grid, 0);
+
+        FNavTestSearchResult Result;
+        for (const FNavTestQuery& Query : Queries)
+        {
+            const float ReferenceCost = FindNavReferenceDistance(Grid, Query.StartIndex, Query.GoalIndex);
+            for (const ENavTestSearch Search : {ENavTestSearch::AStar, ENavTestSearch::JumpPoint})
+            {
+                Runner.Run(Search, Query, Result);
+                TestNavSearchResult(*this, FString::Printf(TEXT("%s %s"), GetNavTestGridLayoutName(Layout), GetNavTestSearchName(Search)), Grid, Query, Result, ReferenceCost);
+            }
+        }
+    }
+
+    // Without corner and edge steps jump point search is unsupported, but A* must stay optimal on the sparser graph.
+    FNavGrid FaceGrid;
+    BuildNavTestGrid(ENavTestGridLayout::RandomNoise, OptimalityGridSize, 3, 2, FaceGrid);
+    TArray<FNavTestQuery> Queries;
+    MakeNavTestQueries(FaceGrid, OptimalityQueryCount, 4, Queries);
+    FNavTestSearchRunner Runner(FaceGrid, 0);
+    TestFalse(TEXT("Jump point search is unsupported with face neighbours only"), Runner.IsSupported(ENavTestSearch::JumpPoint));
+
+    FNavTestSearchResult Result;
+    for (const FNavTestQuery& Query : Queries)
+    {
+        Runner.Run(ENavTestSearch::AStar, Query, Result);
+        TestNavSearchResult(*this, TEXT("RandomNoise (face neighbours) AStar"), FaceGrid, Query, Result, FindNavReferenceDistance(FaceGrid, Query.StartIndex, Query.GoalIndex));
+    }
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,262 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NavTestGrids.h"
+#include "Math/RandomStream.h"
+
+namespace
+{
+    constexpr int32 RoomSize = 8;
+    constexpr float DoorChance = 0.85f;
+    constexpr float NoiseBlockedChance = 0.3f;
+
+    const FIntVector FaceDirections[6] = {
+        FIntVector(-1, 0, 0), FIntVector(1, 0, 0), FIntVector(0, -1, 0), FIntVector(0, 1, 0), FIntVector(0, 0, -1), FIntVector(0, 0, 1)
+    };
+
+    void SetAllTraversable(FNavGrid& Grid, bool bTraversable)
+    {
+        for (int32 Index = 0; Index < Grid.Num(); ++Index)
+        {
+            Grid.SetTraversable(Index, bTraversable);
+        }
+    }
+
+    void BuildMaze(FNavGrid& Grid, FRandomStream& RandomStream)
+    {
+        SetAllTraversable(Grid, false);
+
+        // Maze nodes are the cells with even coordinates; the cell between two linked nodes is carved as well.
+        const FIntVector Size = Grid.GetSize();
+        const FIntVector NumNodes((Size.X + 1) / 2, (Size.Y + 1) / 2, (Size.Z + 1) / 2);
+        TBitArray<> Visited(false, NumNodes.X * NumNodes.Y * NumNodes.Z);
+        auto ToNodeIndex = [&NumNodes](const FIntVector& Node) { return (Node.Z * NumNodes.Y + Node.Y) * NumNodes.X + Node.X; };
+
+        TArray<FIntVector> Stack;
+        Stack.Add(FIntVector::ZeroValue);
+        Visited[0] = true;
+        Grid.SetTraversable(0, true);
+        while (Stack.Num() > 0)
+        {
+            const FIntVector Node = Stack.Last();
+            FIntVector Unvisited[6];
+            int32 NumUnvisited = 0;
+            for (const FIntVector& Direction : FaceDirections)
+            {
+                const FIntVector Next = Node + Direction;
+                if (Next.X >= 0 && Next.X < NumNodes.X && Next.Y >= 0 && Next.Y < NumNodes.Y && Next.Z >= 0 && Next.Z < NumNodes.Z && !Visited[ToNodeIndex(Next)])
+                {
+                    Unvisited[NumUnvisited++] = Next;
+                }
+            }
+            if (NumUnvisited == 0)
+            {
+                Stack.Pop(EAllowShrinking::No);
+                continue;
+            }
+
+            const FIntVector Next = Unvisited[RandomStream.RandHelper(NumUnvisited)];
+            Visited[ToNodeIndex(Next)] = true;
+            Grid.SetTraversable(Grid.ToIndex(Node + Next), true);
+            Grid.SetTraversable(Grid.ToIndex(Next * 2), true);
+            Stack.Add(Next);
+        }
+    }
+
+    void BuildRoomsAndDoors(FNavGrid& Grid, FRandomStream& RandomStream)
+    {
+        // Walls sit on every coordinate that is RoomSize modulo RoomSize + 1, on all three axes.
+        constexpr int32 Pitch = RoomSize + 1;
+        const FIntVector Size = Grid.GetSize();
+        for (int32 Index = 0; Index < Grid.Num(); ++Index)
+        {
+            const FIntVector Coordinates = Grid.ToCoordinates(Index);
+            Grid.SetTraversable(Index, Coordinates.X % Pitch != RoomSize && Coordinates.Y % Pitch != RoomSize && Coordinates.Z % Pitch != RoomSize);
+        }
+
+        const FIntVector NumRooms(FMath::DivideAndRoundUp(Size.X, Pitch), FMath::DivideAndRoundUp(Size.Y, Pitch), FMath::DivideAndRoundUp(Size.Z, Pitch));
+        for (int32 RoomZ = 0; RoomZ < NumRooms.Z; ++RoomZ)
+        {
+            for (int32 RoomY = 0; RoomY < NumRooms.Y; ++RoomY)
+            {
+                for (int32 RoomX = 0; RoomX < NumRooms.X; ++RoomX)
+                {
+                    const FIntVector RoomMin(RoomX * Pitch, RoomY * Pitch, RoomZ * Pitch);
+                    for (int32 Axis = 0; Axis < 3; ++Axis)
+                    {
+                        // Skipped walls leave some rooms sealed off, so the query sets include unreachable goals.
+                        const int32 WallCoordinate = RoomMin[Axis] + RoomSize;
+                        if (WallCoordinate + 1 >= Size[Axis] || RandomStream.FRand() >= DoorChance)
+                        {
+                            continue;
+                        }
+
+                        FIntVector DoorMin = RoomMin;
+                        DoorMin[Axis] = WallCoordinate;
+                        const int32 AxisU = (Axis + 1) % 3;
+                        const int32 AxisV = (Axis + 2) % 3;
+                        DoorMin[AxisU] += RandomStream.RandHelper(RoomSize - 1);
+                        DoorMin[AxisV] += RandomStream.RandHelper(RoomSize - 1);
+                        for (int32 U = 0; U < 2; ++U)
+                        {
+                            for (int32 V = 0; V < 2; ++V)
+                            {
+                                FIntVector DoorCell = DoorMin;
+                                DoorCell[AxisU] += U;
+                                DoorCell[AxisV] += V;
+                                if (Grid.IsInBounds(DoorCell))
+                                {
+                                    Grid.SetTraversable(Grid.ToIndex(DoorCell), true);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void BuildRandomNoise(FNavGrid& Grid, FRandomStream& RandomStream)
+    {
+        for (int32 Index = 0; Index < Grid.Num(); ++Index)
+        {
+            Grid.SetTraversable(Index, RandomStream.FRand() >= NoiseBlockedChance);
+        }
+    }
+}
+
+const TCHAR* GetNavTestGridLayoutName(ENavTestGridLayout Layout)
+{
+    switch (Layout)
+    {
+    case ENavTestGridLayout::OpenAir:
+        return TEXT("OpenAir");
+    case ENavTestGridLayout::Maze:
+        return TEXT("Maze");
+    case ENavTestGridLayout::RoomsAndDoors:
+        return TEXT("RoomsAndDoors");
+    case ENavTestGridLayout::RandomNoise:
+        return TEXT("RandomNoise");
+    default:
+        return TEXT("Unknown");
+    }
+}
+
+void BuildNavTestGrid(ENavTestGridLayout Layout, const FIntVector& Size, int32 Seed, int32 MinSharedNeighborAxes, FNavGrid& OutGrid)
+{
+    OutGrid.Initialize(Size.X, Size.Y, Size.Z, MinSharedNeighborAxes);
+
+    FRandomStream RandomStream(Seed);
+    switch (Layout)
+    {
+    case ENavTestGridLayout::Maze:
+        BuildMaze(OutGrid, RandomStream);
+        break;
+    case ENavTestGridLayout::RoomsAndDoors:
+        BuildRoomsAndDoors(OutGrid, RandomStream);
+        break;
+    case ENavTestGridLayout::RandomNoise:
+        BuildRandomNoise(OutGrid, RandomStream);
+        break;
+    default:
+        break;
+    }
+
+    OutGrid.RebuildNeighborMasks();
+    OutGrid.RebuildClearance();
+    OutGrid.RebuildNearestTraversable();
+}
+
+void MakeNavTestQueries(const FNavGrid& Grid, int32 NumQueries, int32 Seed, TArray<FNavTestQuery>& OutQueries, int32 MinCellDistance)
+{
+    OutQueries.Reset();
+
+    TArray<int32> FreeCells;
+    for (int32 Index = 0; Index < Grid.Num(); ++Index)
+    {
+        if (Grid.IsTraversable(Index))
+        {
+            FreeCells.Add(Index);
+        }
+    }
+    if (FreeCells.Num() == 0)
+    {
+        return;
+    }
+
+    FRandomStream RandomStream(Seed);
+    OutQueries.Reserve(NumQueries);
+    const int64 MinDistanceSquared = static_cast<int64>(MinCellDistance) * MinCellDistance;
+    const int32 MaxAttempts = MinCellDistance > 0 ? NumQueries * 64 : NumQueries;
+    for (int32 Attempt = 0; Attempt < MaxAttempts && OutQueries.Num() < NumQueries; ++Attempt)
+    {
+        FNavTestQuery Query;
+        Query.StartIndex = FreeCells[RandomStream.RandHelper(FreeCells.Num())];
+        Query.GoalIndex = FreeCells[RandomStream.RandHelper(FreeCells.Num())];
+        const FIntVector Delta = Grid.ToCoordinates(Query.GoalIndex) - Grid.ToCoordinates(Query.StartIndex);
+        if (static_cast<int64>(Delta.X) * Delta.X + static_cast<int64>(Delta.Y) * Delta.Y + static_cast<int64>(Delta.Z) * Delta.Z >= MinDistanceSquared)
+        {
+            OutQueries.Add(Query);
+        }
+    }
+}
+
+float FindNavReferenceDistance(const FNavGrid& Grid, int32 StartIndex, int32 GoalIndex)
+{
+    struct FEntry
+    {
+        double Distance;
+        int32 NodeIndex;
+
+        bool operator<(const FEntry& Other) const { return Distance < Other.Distance; }
+    };
+
+    TArray<double> Distances;
+    Distances.Init(TNumericLimits<double>::Max(), Grid.Num());
+    TArray<FEntry> Heap;
+    Distances[StartIndex] = 0.0;
+    Heap.HeapPush({0.0, StartIndex});
+    while (Heap.Num() > 0)
+    {
+        FEntry Entry;
+        Heap.HeapPop(Entry, EAllowShrinking::No);
+        if (Entry.Distance > Distances[Entry.NodeIndex])
+        {
+            continue;
+        }
+        if (Entry.NodeIndex == GoalIndex)
+        {
+            return static_cast<float>(Entry.Distance);
+        }
+
+        uint32 OpenNeighbors = Grid.GetOpenNeighborMask(Entry.NodeIndex);
+        while (OpenNeighbors != 0)
+        {
+            const int32 Direction = FMath::CountTrailingZeros(OpenNeighbors);
+            OpenNeighbors &= OpenNeighbors - 1;
+            const int32 NeighborIndex = Entry.NodeIndex + Grid.GetIndexOffset(Direction);
+            const double Distance = Entry.Distance + FNavGrid::GetDirectionCost(Direction);
+            if (Distance < Distances[NeighborIndex])
+            {
+                Distances[NeighborIndex] = Distance;
+                Heap.HeapPush({Distance, NeighborIndex});
+            }
+        }
+    }
+    return NavTestUnreachable;
+}
+
+float MeasureNavPathCost(const FNavGrid& Grid, TConstArrayView<int32> PathIndices)
+{
+    float Cost = 0.0f;
+    for (int32 Step = 1; Step < PathIndices.Num(); ++Step)
+    {
+        const int32 Direction = FNavGrid::FindDirection(Grid.ToCoordinates(PathIndices[Step]) - Grid.ToCoordinates(PathIndices[Step - 1]));
+        if (Direction == INDEX_NONE || (Grid.GetOpenNeighborMask(PathIndices[Step - 1]) & (1u << Direction)) == 0)
+        {
+            return NavTestUnreachable;
+        }
+        Cost += FNavGrid::GetDirectionCost(Direction);
+    }
+    return Cost;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavGrid.h"
+#include <limits>
+
+// Synthetic dense grids for the search tests and benchmarks. They are built straight into an FNavGrid, so no
+// world, volume actor or renderer is involved and everything runs under -nullrhi.
+enum class ENavTestGridLayout : uint8
+{
+    // Nothing blocked.
+    OpenAir,
+    // One-cell corridors carved by a randomized depth-first search over the cells with even coordinates.
+    Maze,
+    // Boxes of RoomSize cells separated by one-cell walls, with a 2 x 2 door in most of the walls between them.
+    RoomsAndDoors,
+    // Every cell blocked with a fixed probability.
+    RandomNoise
+};
+
+static constexpr ENavTestGridLayout NavTestGridLayouts[] = {
+    ENavTestGridLayout::OpenAir, ENavTestGridLayout::Maze, ENavTestGridLayout::RoomsAndDoors, ENavTestGridLayout::RandomNoise
+};
+
+const TCHAR* GetNavTestGridLayoutName(ENavTestGridLayout Layout);
+
+// Builds Layout into OutGrid, including neighbour masks, clearance and the nearest-traversable table. The same
+// layout, size and seed always give the same grid.
+void BuildNavTestGrid(ENavTestGridLayout Layout, const FIntVector& Size, int32 Seed, int32 MinSharedNeighborAxes, FNavGrid& OutGrid);
+
+struct FNavTestQuery
+{
+    int32 StartIndex = INDEX_NONE;
+    int32 GoalIndex = INDEX_NONE;
+};
+
+// NumQueries start/goal pairs of free cells drawn from Seed. Pairs need not be connected to each other. With
+// MinCellDistance, only pairs at least that many cells apart (straight line) are kept; fewer than NumQueries
+// come back if such pairs are too rare.
+void MakeNavTestQueries(const FNavGrid& Grid, int32 NumQueries, int32 Seed, TArray<FNavTestQuery>& OutQueries, int32 MinCellDistance = 0);
+
+static constexpr float NavTestUnreachable = std::numeric_limits<float>::max();
+
+// Shortest path cost between two cells by plain Dijkstra over the grid's open-neighbour masks, accumulated in
+// double precision; NavTestUnreachable if the goal cannot be reached. Shares no code with the A* core.
+float FindNavReferenceDistance(const FNavGrid& Grid, int32 StartIndex, int32 GoalIndex);
+
+// Sum of the step costs along PathIndices, or NavTestUnreachable if any step is not a move to an open neighbour.
+float MeasureNavPathCost(const FNavGrid& Grid, TConstArrayView<int32> PathIndices);
+
+// Whether two path costs agree up to float accumulation error.
+FORCEINLINE bool IsNearlyEqualNavCost(float Cost, float ReferenceCost)
+{
+    if (Cost == NavTestUnreachable || ReferenceCost == NavTestUnreachable)
+    {
+        return Cost == ReferenceCost;
+    }
+    return FMath::Abs(Cost - ReferenceCost) <= FMath::Max(1.e-3f, ReferenceCost * 1.e-5f);
+}
@@ -0,0 +1,274 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NavTestSearch.h"
+#include "NavTestGrids.h"
+#include "Misc/AutomationTest.h"
+
+namespace
+{
+    template<typename GraphType>
+    ENavAStarStatus RunWithLandmarks(const GraphType& Graph, const FNavLandmarkHeuristic& Landmarks, FNavSearchContext& Search, const FNavAStarParams& Params)
+    {
+        FNavAStarNullVisitor Visitor;
+        if (Landmarks.IsEmpty())
+        {
+            return RunNavAStar(Graph, Search, Params, Visitor);
+        }
+        const TNavLandmarkGraph<GraphType> LandmarkGraph(Graph, Landmarks);
+        return RunNavAStar(LandmarkGraph, Search, Params, Visitor);
+    }
+
+    SIZE_T GetScratchBytes(const FNavSearchContext& Search)
+    {
+        return Search.NodeStates.GetAllocatedSize() + Search.PeakOpen * sizeof(FNavOpenSetEntry);
+    }
+
+    // Counts closed nodes over every search of a cluster hierarchy query.
+    class FNavExpansionCounter final : public INavAStarVisitor
+    {
+    public:
+        int32 NumExpanded = 0;
+
+        virtual void OnPopped(int32 NodeIndex) override {}
+        virtual void OnClosed(int32 NodeIndex) override { ++NumExpanded; }
+        virtual void OnNeighborConsidered(int32 FromIndex, int32 ToIndex) override {}
+        virtual void OnNeighborImproved(int32 FromIndex, int32 ToIndex) override {}
+    };
+}
+
+const TCHAR* GetNavTestSearchName(ENavTestSearch Search)
+{
+    switch (Search)
+    {
+    case ENavTestSearch::AStar:
+        return TEXT("AStar");
+    case ENavTestSearch::JumpPoint:
+        return TEXT("JumpPoint");
+    case ENavTestSearch::Bidirectional:
+        return TEXT("Bidirectional");
+    case ENavTestSearch::Landmarks:
+        return TEXT("Landmarks");
+    case ENavTestSearch::BidirectionalLandmarks:
+        return TEXT("BidirectionalLandmarks");
+    case ENavTestSearch::Hierarchy:
+        return TEXT("Hierarchy");
+    default:
+        return TEXT("Unknown");
+    }
+}
+
+FNavTestSearchRunner::FNavTestSearchRunner(const FNavGrid& InGrid, int32 NumLandmarks, int32 ClusterSize)
+    : Grid(InGrid)
+{
+    JumpPointRules.Build(Grid.GetAllowedDirectionsMask());
+    if (NumLandmarks > 0)
+    {
+        Landmarks.Build(Grid, NumLandmarks, SearchContextPool);
+    }
+    if (ClusterSize > 0)
+    {
+        ClusterHierarchy.Build(Grid, ClusterSize, HierarchySearchContextPool);
+    }
+}
+
+bool FNavTestSearchRunner::IsSupported(ENavTestSearch Search) const
+{
+    switch (Search)
+    {
+    case ENavTestSearch::JumpPoint:
+        return JumpPointRules.IsSupported();
+    case ENavTestSearch::Landmarks:
+    case ENavTestSearch::BidirectionalLandmarks:
+        return !Landmarks.IsEmpty();
+    case ENavTestSearch::Hierarchy:
+        return !ClusterHierarchy.IsEmpty();
+    default:
+        return true;
+    }
+}
+
+void FNavTestSearchRunner::Run(ENavTestSearch Search, const FNavTestQuery& Query, FNavTestSearchResult& OutResult)
+{
+    check(IsSupported(Search));
+    if (Search == ENavTestSearch::Hierarchy)
+    {
+        RunHierarchy(Query, OutResult);
+        return;
+    }
+
+    FNavAStarParams Params;
+    Params.StartIndex = Query.StartIndex;
+    Params.GoalIndex = Query.GoalIndex;
+    Forward.BeginSearch(Grid.Num());
+    Backward.BeginSearch(Grid.Num());
+
+    const FNavLandmarkHeuristic NoLandmarks;
+    const bool bUseLandmarks = Search == ENavTestSearch::Landmarks || Search == ENavTestSearch::BidirectionalLandmarks;
+    const bool bBidirectional = Search == ENavTestSearch::Bidirectional || Search == ENavTestSearch::BidirectionalLandmarks;
+    const FNavGridGraph ForwardGraph(Grid, Grid.ToCoordinates(Query.GoalIndex));
+
+    const double StartTime = FPlatformTime::Seconds();
+    int32 MeetingIndex = INDEX_NONE;
+    if (bBidirectional)
+    {
+        const FNavGridGraph BackwardGraph(Grid, Grid.ToCoordinates(Query.StartIndex));
+        FNavAStarNullVisitor Visitor;
+        if (bUseLandmarks)
+        {
+            const FNavLandmarkHeuristic ForwardLandmarks = Landmarks.MakeHeuristic(Query.GoalIndex);
+            const FNavLandmarkHeuristic BackwardLandmarks = Landmarks.MakeHeuristic(Query.StartIndex);
+            const TNavLandmarkGraph<FNavGridGraph> ForwardLandmarkGraph(ForwardGraph, ForwardLandmarks);
+            const TNavLandmarkGraph<FNavGridGraph> BackwardLandmarkGraph(BackwardGraph, BackwardLandmarks);
+            OutResult.Status = RunNavBidirectionalAStar(ForwardLandmarkGraph, BackwardLandmarkGraph, Forward, Backward, Params, Visitor, MeetingIndex);
+        }
+        else
+        {
+            OutResult.Status = RunNavBidirectionalAStar(ForwardGraph, BackwardGraph, Forward, Backward, Params, Visitor, MeetingIndex);
+        }
+    }
+    else if (Search == ENavTestSearch::JumpPoint)
+    {
+        const FNavJumpPointGraph JumpPointGraph(Grid, JumpPointRules, Forward, Query.GoalIndex);
+        FNavAStarNullVisitor Visitor;
+        OutResult.Status = RunNavAStar(JumpPointGraph, Forward, Params, Visitor);
+    }
+    else
+    {
+        const FNavLandmarkHeuristic GoalLandmarks = bUseLandmarks ? Landmarks.MakeHeuristic(Query.GoalIndex) : NoLandmarks;
+        OutResult.Status = RunWithLandmarks(ForwardGraph, GoalLandmarks, Forward, Params);
+    }
+    OutResult.Seconds = FPlatformTime::Seconds() - StartTime;
+
+    OutResult.NumExpanded = Forward.NumExpanded + Backward.NumExpanded;
+    OutResult.PeakScratchBytes = GetScratchBytes(Forward) + (bBidirectional ? GetScratchBytes(Backward) : 0);
+    OutResult.PathIndices.Reset();
+    OutResult.Cost = NavTestUnreachable;
+    if (OutResult.Status != ENavAStarStatus::Found)
+    {
+        return;
+    }
+
+    if (bBidirectional)
+    {
+        OutResult.Cost = Forward.GetGScore(MeetingIndex) + Backward.GetGScore(MeetingIndex);
+        ReconstructNavBidirectionalPath(Forward, Backward, MeetingIndex, OutResult.PathIndices);
+        return;
+    }
+
+    OutResult.Cost = Forward.GetGScore(Query.GoalIndex);
+    ReconstructNavPath(Forward, Query.GoalIndex, OutResult.PathIndices);
+    if (Search == ENavTestSearch::JumpPoint)
+    {
+        ExpandJumpPointPath(Grid, OutResult.PathIndices);
+    }
+}
+
+void FNavTestSearchRunner::RunHierarchy(const FNavTestQuery& Query, FNavTestSearchResult& OutResult)
+{
+    FNavExpansionCounter Counter;
+    const double StartTime = FPlatformTime::Seconds();
+    OutResult.Status = ClusterHierarchy.FindPath(Grid, Query.StartIndex, Query.GoalIndex, HierarchySearchContextPool, nullptr, OutResult.PathIndices, &Counter);
+    OutResult.NumExpanded = Counter.NumExpanded;
+
+    // As in ANavigationVolume3D, a NoPath the cluster graph cannot vouch for is settled by a flat search.
+    bool bFellBack = false;
+    if (OutResult.Status == ENavAStarStatus::NoPath && !ClusterHierarchy.HasCompleteConnectivity())
+    {
+        bFellBack = true;
+        FNavAStarParams Params;
+        Params.StartIndex = Query.StartIndex;
+        Params.GoalIndex = Query.GoalIndex;
+        Forward.BeginSearch(Grid.Num());
+        const FNavGridGraph ForwardGraph(Grid, Grid.ToCoordinates(Query.GoalIndex));
+        FNavAStarNullVisitor Visitor;
+        OutResult.Status = RunNavAStar(ForwardGraph, Forward, Params, Visitor);
+        OutResult.NumExpanded += Forward.NumExpanded;
+        OutResult.PathIndices.Reset();
+        if (OutResult.Status == ENavAStarStatus::Found)
+        {
+            ReconstructNavPath(Forward, Query.GoalIndex, OutResult.PathIndices);
+        }
+    }
+    OutResult.Seconds = FPlatformTime::Seconds() - StartTime;
+
+    {
+        TUniquePtr<FNavSearchContext> Context = HierarchySearchContextPool.Acquire(Grid.Num());
+        OutResult.PeakScratchBytes = Context->NodeStates.GetAllocatedSize() + Context->OpenHeap.GetAllocatedSize() + (bFellBack ? GetScratchBytes(Forward) : 0);
+        HierarchySearchContextPool.Release(MoveTemp(Context));
+    }
+
+    if (OutResult.Status != ENavAStarStatus::Found)
+    {
+        OutResult.PathIndices.Reset();
+        OutResult.Cost = NavTestUnreachable;
+        return;
+    }
+    OutResult.Cost = MeasureNavPathCost(Grid, OutResult.PathIndices);
+}
+
+bool TestNavSearchResult(FAutomationTestBase& Test, const FString& What, const FNavGrid& Grid, const FNavTestQuery& Query, const FNavTestSearchResult& Result, float ReferenceCost)
+{
+    const bool bReachable = ReferenceCost != NavTestUnreachable;
+    if ((Result.Status == ENavAStarStatus::Found) != bReachable)
+    {
+        Test.AddError(FString::Printf(TEXT("%s: %d -> %d %s a path, the reference %s."), *What, Query.StartIndex, Query.GoalIndex,
+            Result.Status == ENavAStarStatus::Found ? TEXT("found") : TEXT("found no"), bReachable ? TEXT("has one") : TEXT("has none")));
+        return false;
+    }
+    if (!bReachable)
+    {
+        return true;
+    }
+
+    if (!IsNearlyEqualNavCost(Result.Cost, ReferenceCost))
+    {
+        Test.AddError(FString::Printf(TEXT("%s: %d -> %d costs %f, the reference %f."), *What, Query.StartIndex, Query.GoalIndex, Result.Cost, ReferenceCost));
+        return false;
+    }
+    if (Result.PathIndices.Num() == 0 || Result.PathIndices[0] != Query.StartIndex || Result.PathIndices.Last() != Query.GoalIndex)
+    {
+        Test.AddError(FString::Printf(TEXT("%s: %d -> %d path does not run from start to goal."), *What, Query.StartIndex, Query.GoalIndex));
+        return false;
+    }
+    const float PathCost = MeasureNavPathCost(Grid, Result.PathIndices);
+    if (!IsNearlyEqualNavCost(PathCost, Result.Cost))
+    {
+        Test.AddError(FString::Printf(TEXT("%s: %d -> %d path steps cost %f, the search reported %f."), *What, Query.StartIndex, Query.GoalIndex, PathCost, Result.Cost));
+        return false;
+    }
+    return true;
+}
+
+bool TestNavApproximateSearchResult(FAutomationTestBase& Test, const FString& What, const FNavGrid& Grid, const FNavTestQuery& Query, const FNavTestSearchResult& Result, float ReferenceCost)
+{
+    const bool bReachable = ReferenceCost != NavTestUnreachable;
+    if ((Result.Status == ENavAStarStatus::Found) != bReachable)
+    {
+        Test.AddError(FString::Printf(TEXT("%s: %d -> %d %s a path, the reference %s."), *What, Query.StartIndex, Query.GoalIndex,
+            Result.Status == ENavAStarStatus::Found ? TEXT("found") : TEXT("found no"), bReachable ? TEXT("has one") : TEXT("has none")));
+        return false;
+    }
+    if (!bReachable)
+    {
+        return true;
+    }
+
+    if (Result.PathIndices.Num() == 0 || Result.PathIndices[0] != Query.StartIndex || Result.PathIndices.Last() != Query.GoalIndex)
+    {
+        Test.AddError(FString::Printf(TEXT("%s: %d -> %d path does not run from start to goal."), *What, Query.StartIndex, Query.GoalIndex));
+        return false;
+    }
+    const float PathCost = MeasureNavPathCost(Grid, Result.PathIndices);
+    if (PathCost == NavTestUnreachable || !IsNearlyEqualNavCost(PathCost, Result.Cost))
+    {
+        Test.AddError(FString::Printf(TEXT("%s: %d -> %d path steps cost %f, the search reported %f."), *What, Query.StartIndex, Query.GoalIndex, PathCost, Result.Cost));
+        return false;
+    }
+    if (Result.Cost < ReferenceCost && !IsNearlyEqualNavCost(Result.Cost, ReferenceCost))
+    {
+        Test.AddError(FString::Printf(TEXT("%s: %d -> %d costs %f, below the reference %f."), *What, Query.StartIndex, Query.GoalIndex, Result.Cost, ReferenceCost));
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavAStar.h"
+#include "NavHierarchy.h"
+#include "NavJumpPoint.h"
+#include "NavLandmarks.h"
+#include "NavSearchContext.h"
+
+class FAutomationTestBase;
+struct FNavTestQuery;
+
+// The dense-grid searches ANavigationVolume3D can run for a point-sized agent, wired up the way the volume does.
+enum class ENavTestSearch : uint8
+{
+    AStar,
+    JumpPoint,
+    Bidirectional,
+    Landmarks,
+    BidirectionalLandmarks,
+    // FNavClusterHierarchy::FindPath, falling back to A* on a NoPath the cluster graph cannot vouch for. Not optimal.
+    Hierarchy,
+    Num
+};
+
+const TCHAR* GetNavTestSearchName(ENavTestSearch Search);
+
+// Whether Search always returns a shortest path; see TestNavSearchResult and TestNavApproximateSearchResult.
+FORCEINLINE bool IsNavTestSearchOptimal(ENavTestSearch Search)
+{
+    return Search != ENavTestSearch::Hierarchy;
+}
+
+struct FNavTestSearchResult
+{
+    ENavAStarStatus Status = ENavAStarStatus::NoPath;
+    // Summed g-scores at the goal (or the meeting cell, or along the refined path), NavTestUnreachable without a path.
+    float Cost = 0.0f;
+    // Start to goal, one cell per step; jump point paths are expanded.
+    TArray<int32> PathIndices;
+    // Nodes closed by every search the query ran; for Hierarchy the endpoint, abstract and refinement searches.
+    int32 NumExpanded = 0;
+    // Bytes of search scratch state at the peak of the query: node states plus the largest open heap, per context.
+    // For Hierarchy, the pooled grid context's node states and heap capacity; its small abstract context is not counted.
+    SIZE_T PeakScratchBytes = 0;
+    double Seconds = 0.0;
+};
+
+// Runs any ENavTestSearch over one grid, reusing its search contexts between queries as the volume's pool does.
+class FNavTestSearchRunner
+{
+public:
+    // Grid must outlive the runner. Landmark tables are only built when NumLandmarks > 0, the cluster hierarchy
+    // only when ClusterSize > 0.
+    FNavTestSearchRunner(const FNavGrid& InGrid, int32 NumLandmarks, int32 ClusterSize = 0);
+
+    // False when the search cannot run on this grid (jump points without 26-connectivity, landmarks without tables,
+    // Hierarchy without a hierarchy).
+    bool IsSupported(ENavTestSearch Search) const;
+
+    void Run(ENavTestSearch Search, const FNavTestQuery& Query, FNavTestSearchResult& OutResult);
+
+    FORCEINLINE const FNavClusterHierarchy& GetClusterHierarchy() const { return ClusterHierarchy; }
+
+private:
+    void RunHierarchy(const FNavTestQuery& Query, FNavTestSearchResult& OutResult);
+
+    const FNavGrid& Grid;
+    FNavJumpPointRules JumpPointRules;
+    FNavLandmarks Landmarks;
+    FNavSearchContextPool SearchContextPool;
+    FNavSearchContext Forward;
+    FNavSearchContext Backward;
+    FNavClusterHierarchy ClusterHierarchy;
+    // Only the hierarchy borrows from it, so the context it hands back after a query is the one FindPath used.
+    FNavSearchContextPool HierarchySearchContextPool;
+};
+
+// Reports an error on Test unless Result agrees with ReferenceCost (see FindNavReferenceDistance): a path exactly
+// when the goal is reachable, a cost equal to the reference, and a valid cell path from start to goal whose
+// step costs add up to that cost. Returns whether it agreed.
+bool TestNavSearchResult(FAutomationTestBase& Test, const FString& What, const FNavGrid& Grid, const FNavTestQuery& Query, const FNavTestSearchResult& Result, float ReferenceCost);
+
+// TestNavSearchResult for a search that need not be optimal: a path whenever the goal is reachable (and only
+// then), a valid cell path from start to goal whose step costs add up to the reported cost, and a cost no lower
+// than the reference. Returns whether it agreed.
+bool TestNavApproximateSearchResult(FAutomationTestBase& Test, const FString& What, const FNavGrid& Grid, const FNavTestQuery& Query, const FNavTestSearchResult& Result, float ReferenceCost);
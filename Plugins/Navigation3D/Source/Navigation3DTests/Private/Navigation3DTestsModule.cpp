@@ -0,0 +1,6 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Modules/ModuleManager.h"
+
+// Holds only automation tests, which register themselves when the module loads.
+IMPLEMENT_MODULE(FDefaultModuleImpl, Navigation3DTests)